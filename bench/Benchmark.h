@@ -126,6 +126,12 @@ public:
 
     virtual void getGpuStats(SkCanvas*, SkTArray<SkString>* keys, SkTArray<double>* values) {}
 
+    /*
+     * Results other than time, e.g. memory use or output size, reported with the timings.
+     * Called after onPerCanvasPostDraw().
+     */
+    virtual void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) {}
+
 protected:
     virtual void setupPaint(SkPaint* paint);
 
@@ -10,6 +10,7 @@
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkRandom.h"
+#include "SkString.h"
 #include "SkTDArray.h"
 
 /**
@@ -85,23 +86,22 @@ static void gen_paths(const SkTDArray<SkScalar>& topData,
 }
 
 // A set of scrolling line plots with the area between each plot filled. Stresses out GPU path
-// filling
+// filling. Unless scrolling, the same paths are drawn every frame, the way a dashboard redraws a
+// chart whose data has not changed, so their strokes can be found in the stroke cache.
 class ChartBench : public Benchmark {
 public:
-    ChartBench(bool aa) {
+    ChartBench(bool aa, bool scroll = true) {
         fShift = 0;
         fAA = aa;
+        fScroll = scroll;
         fSize.fWidth = -1;
         fSize.fHeight = -1;
+        fName.printf("chart_%s%s", fScroll ? "" : "static_", fAA ? "aa" : "bw");
     }
 
 protected:
     const char* onGetName() override {
-        if (fAA) {
-            return "chart_aa";
-        } else {
-            return "chart_bw";
-        }
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
@@ -135,9 +135,6 @@ protected:
 
             canvas->clear(0xFFE0F0E0);
 
-            SkPath plotPath;
-            SkPath fillPath;
-
             static const SkScalar kStrokeWidth = SkIntToScalar(2);
             SkPaint plotPaint;
             SkPaint fillPaint;
@@ -151,26 +148,31 @@ protected:
 
             SkTDArray<SkScalar>* prevData = nullptr;
             for (int i = 0; i < kNumGraphs; ++i) {
-                gen_paths(fData[i],
-                          prevData,
-                          height,
-                          0,
-                          SkIntToScalar(kPixelsPerTick),
-                          fShift,
-                          &plotPath,
-                          &fillPath);
+                if (fScroll || sizeChanged) {
+                    gen_paths(fData[i],
+                              prevData,
+                              height,
+                              0,
+                              SkIntToScalar(kPixelsPerTick),
+                              fShift,
+                              &fPlotPaths[i],
+                              &fFillPaths[i]);
+                }
 
                 // Make the fills partially transparent
                 fillPaint.setColor((colors[i] & 0x00ffffff) | 0x80000000);
-                canvas->drawPath(fillPath, fillPaint);
+                canvas->drawPath(fFillPaths[i], fillPaint);
 
                 plotPaint.setColor(colors[i]);
-                canvas->drawPath(plotPath, plotPaint);
+                canvas->drawPath(fPlotPaths[i], plotPaint);
 
                 prevData = fData + i;
             }
 
-            fShift += kShiftPerFrame;
+            if (fScroll) {
+                fShift += kShiftPerFrame;
+            }
+            sizeChanged = false;
         }
     }
 
@@ -183,7 +185,11 @@ private:
     int                 fShift;
     SkISize             fSize;
     SkTDArray<SkScalar> fData[kNumGraphs];
+    SkPath              fPlotPaths[kNumGraphs];
+    SkPath              fFillPaths[kNumGraphs];
     bool                fAA;
+    bool                fScroll;
+    SkString            fName;
 
     typedef Benchmark INHERITED;
 };
@@ -192,3 +198,5 @@ private:
 
 DEF_BENCH( return new ChartBench(true); )
 DEF_BENCH( return new ChartBench(false); )
+DEF_BENCH( return new ChartBench(true, false); )
+DEF_BENCH( return new ChartBench(false, false); )
@@ -8,8 +8,13 @@
 #include "Benchmark.h"
 #include "Resources.h"
 #include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkImageEncoder.h"
+#include "SkImageEncoderPriv.h"
+#include "SkShader.h"
+#include "SkStream.h"
 
 #include "sk_tool_utils.h"
 
@@ -81,3 +86,111 @@ DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kPNG,
 // TODO: What is the appropriate quality to use to benchmark WEBP encodes?
 DEF_BENCH(return new EncodeBench("mandrill_512.png", SkEncodedImageFormat::kWEBP, 90));
 DEF_BENCH(return new EncodeBench("color_wheel.jpg", SkEncodedImageFormat::kWEBP, 90));
+
+// Compares the default PNG encode with faster, less thorough settings.
+class EncodePNGOptionsBench : public Benchmark {
+public:
+    EncodePNGOptionsBench(const char* filename, SkEncodeOptions::PNGFilterFlags filterFlags,
+                          int zlibLevel, const char* suffix)
+        : fFilename(filename)
+    {
+        fOpts.fPNGFilterFlags = filterFlags;
+        fOpts.fPNGZLibLevel = zlibLevel;
+        fName.printf("Encode_%s_PNG_%s", filename, suffix);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        GetResourceAsBitmap(fFilename, &fBitmap);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPixmap pixmap;
+        if (!fBitmap.peekPixels(&pixmap)) {
+            return;
+        }
+
+        for (int i = 0; i < loops; i++) {
+            SkDynamicMemoryWStream stream;
+            SkEncodeImageAsPNG(&stream, pixmap, fOpts);
+        }
+    }
+
+private:
+    const char*     fFilename;
+    SkEncodeOptions fOpts;
+    SkString        fName;
+    SkBitmap        fBitmap;
+};
+
+DEF_BENCH(return new EncodePNGOptionsBench("mandrill_512.png",
+                                           SkEncodeOptions::PNGFilterFlags::kSub, 1, "fast"));
+DEF_BENCH(return new EncodePNGOptionsBench("mandrill_512.png",
+                                           SkEncodeOptions::PNGFilterFlags::kNone, 0, "stored"));
+DEF_BENCH(return new EncodePNGOptionsBench("color_wheel.jpg",
+                                           SkEncodeOptions::PNGFilterFlags::kSub, 1, "fast"));
+
+// Encodes a large, screenshot-sized image as PNG, optionally spreading the work across threads.
+// threads == 0 uses the serial encoder.
+class EncodePNGThreadsBench : public Benchmark {
+public:
+    EncodePNGThreadsBench(int threads) : fThreads(threads) {
+        fName.printf("Encode_PNG_2560x1600_%dthreads", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap tile;
+        if (!GetResourceAsBitmap("mandrill_512.png", &tile)) {
+            return;
+        }
+
+        // Tile the image so the encoder sees realistic, compressible content at a large size.
+        fBitmap.allocN32Pixels(2560, 1600);
+        SkCanvas canvas(fBitmap);
+        SkPaint paint;
+        paint.setShader(SkShader::MakeBitmapShader(tile, SkShader::kMirror_TileMode,
+                                                   SkShader::kMirror_TileMode));
+        canvas.drawPaint(paint);
+
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPixmap pixmap;
+        if (!fBitmap.peekPixels(&pixmap)) {
+            return;
+        }
+
+        SkEncodeOptions opts;
+        opts.fExecutor = fExecutor.get();
+        for (int i = 0; i < loops; i++) {
+            SkDynamicMemoryWStream stream;
+#ifdef SK_DEBUG
+            bool result =
+#endif
+            SkEncodeImageAsPNG(&stream, pixmap, opts);
+            SkASSERT(result);
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new EncodePNGThreadsBench(0));
+DEF_BENCH(return new EncodePNGThreadsBench(1));
+DEF_BENCH(return new EncodePNGThreadsBench(2));
+DEF_BENCH(return new EncodePNGThreadsBench(4));
+DEF_BENCH(return new EncodePNGThreadsBench(8));
@@ -10,7 +10,18 @@
 #include "SkBlurImageFilter.h"
 #include "SkDisplacementMapEffect.h"
 #include "SkCanvas.h"
+#include "SkColorFilterImageFilter.h"
+#include "SkColorMatrixFilter.h"
+#include "SkDropShadowImageFilter.h"
+#include "SkExecutor.h"
+#include "SkImageFilterCache.h"
+#include "SkLightingImageFilter.h"
+#include "SkMatrixConvolutionImageFilter.h"
 #include "SkMergeImageFilter.h"
+#include "SkMorphologyImageFilter.h"
+#include "SkOffsetImageFilter.h"
+#include "SkPoint3.h"
+#include "SkSpecialImage.h"
 
 
 // Exercise a blur filter connected to 5 inputs of the same merge filter.
@@ -120,6 +131,216 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Filters an image through a DAG of independent branches (a drop shadow, a blur, diffuse
+// lighting and a sharpening convolution, merged) on the raster backend.  The context carries a
+// pool of fThreads threads, or no executor at all when fThreads is 0, so comparing the variants
+// shows how well inputs and bands of the per-pixel filters are spread over threads.
+class ImageFilterDAGThreadsBench : public Benchmark {
+public:
+    ImageFilterDAGThreadsBench(int threads) : fThreads(threads) {
+        fName.printf("image_filter_dag_threads_%d", threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kSize, kSize);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 8; ++i) {
+            paint.setColor(0xFF000000 | (0x1F3F5F * (i + 1)));
+            canvas.drawCircle(SkIntToScalar(kSize * (i + 1) / 9), SkIntToScalar(kSize / 2),
+                              SkIntToScalar(kSize / 6), paint);
+        }
+        fSource = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize), bitmap);
+
+        const SkScalar sharpen[] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+        sk_sp<SkImageFilter> branches[] = {
+            SkDropShadowImageFilter::Make(4, 4, 3, 3, SK_ColorBLACK,
+                    SkDropShadowImageFilter::kDrawShadowAndForeground_ShadowMode, nullptr),
+            SkBlurImageFilter::Make(6, 6, nullptr),
+            SkLightingImageFilter::MakePointLitDiffuse(SkPoint3::Make(kSize / 2, kSize / 2, 50),
+                                                       SK_ColorWHITE, 2, 1, nullptr),
+            SkMatrixConvolutionImageFilter::Make(SkISize::Make(3, 3), sharpen, 1, 0,
+                                                 SkIPoint::Make(1, 1),
+                                                 SkMatrixConvolutionImageFilter::kClamp_TileMode,
+                                                 false, nullptr),
+        };
+        SkBlendMode modes[SK_ARRAY_COUNT(branches)];
+        for (SkBlendMode& mode : modes) {
+            mode = SkBlendMode::kSrcOver;
+        }
+        fFilter = SkMergeImageFilter::MakeN(branches, SK_ARRAY_COUNT(branches), modes);
+
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // No cache, or every loop after the first would just look the result up.
+        SkImageFilter::OutputProperties outputProperties(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                   outputProperties, fExecutor.get());
+        for (int i = 0; i < loops; ++i) {
+            SkIPoint offset = SkIPoint::Make(0, 0);
+            sk_sp<SkSpecialImage> result = fFilter->filterImage(fSource.get(), ctx, &offset);
+            SkASSERT(result);
+        }
+    }
+
+private:
+    static const int kSize = 1024;
+
+    int                          fThreads;
+    SkString                     fName;
+    sk_sp<SkSpecialImage>        fSource;
+    sk_sp<SkImageFilter>         fFilter;
+    std::unique_ptr<SkExecutor>  fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+// Never hits, but holds on to every filter's output until the next one comes in, to find the
+// most bytes of outputs that were alive at once (while a filter runs, its inputs and its output).
+class PeakBytesCache : public SkImageFilterCache {
+public:
+    size_t peakBytes() const { return fPeakBytes; }
+
+    sk_sp<SkSpecialImage> get(const SkImageFilterCacheKey&, SkIPoint*) const override {
+        return nullptr;
+    }
+
+    void set(const SkImageFilterCacheKey&, SkSpecialImage* image, const SkIPoint&) override {
+        fImages.push_back(sk_ref_sp(image));
+        size_t bytes = 0;
+        for (const sk_sp<SkSpecialImage>& held : fImages) {
+            bytes += held->getSize();
+        }
+        fPeakBytes = SkTMax(fPeakBytes, bytes);
+
+        // Let go of what the filters are done with.
+        for (int i = fImages.count() - 1; i >= 0; --i) {
+            if (fImages[i]->unique()) {
+                fImages.removeShuffle(i);
+            }
+        }
+    }
+
+    void purge() override { fImages.reset(); }
+    void purgeByKeys(const SkImageFilterCacheKey[], int) override {}
+    SkDEBUGCODE(int count() const override { return fImages.count(); })
+
+private:
+    SkTArray<sk_sp<SkSpecialImage>> fImages;
+    size_t                          fPeakBytes = 0;
+};
+
+// Filters a 4K layer through a five deep chain of local filters (a color filter, an offset, a
+// dilation, a sharpening convolution and diffuse lighting), either all at once (fTileSize == 0)
+// or one tile at a time with filterImageInTiles().  Reports the peak bytes of intermediates
+// each way takes, which tiling bounds at the price of recomputing the margins between tiles.
+class ImageFilterTiledBench : public Benchmark {
+public:
+    ImageFilterTiledBench(int tileSize) : fTileSize(tileSize) {
+        fName.printf("image_filter_tiled_%d", tileSize);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(kWidth, kHeight);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 32; ++i) {
+            paint.setColor(0xFF000000 | (0x1F3F5F * (i + 1)));
+            canvas.drawCircle(SkIntToScalar(kWidth * ((i % 8) + 1) / 9),
+                              SkIntToScalar(kHeight * ((i / 8) + 1) / 5),
+                              SkIntToScalar(kHeight / 10), paint);
+        }
+        fSource = SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kWidth, kHeight), bitmap);
+
+        const SkScalar sharpen[] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+        sk_sp<SkImageFilter> filter = SkColorFilterImageFilter::Make(
+                SkColorMatrixFilter::MakeLightingFilter(0xFFC0A080, 0x00102030), nullptr);
+        filter = SkOffsetImageFilter::Make(3, 3, std::move(filter));
+        filter = SkDilateImageFilter::Make(2, 2, std::move(filter));
+        filter = SkMatrixConvolutionImageFilter::Make(
+                SkISize::Make(3, 3), sharpen, 1, 0, SkIPoint::Make(1, 1),
+                SkMatrixConvolutionImageFilter::kClamp_TileMode, false, std::move(filter));
+        fFilter = SkLightingImageFilter::MakePointLitDiffuse(
+                SkPoint3::Make(kWidth / 2, kHeight / 2, 200), SK_ColorWHITE, 2, 1,
+                std::move(filter));
+        SkASSERT(fFilter->canFilterInTiles());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            PeakBytesCache peak;
+            sk_sp<SkSpecialImage> result = this->filter(&peak);
+            SkASSERT(result);
+            fPeakBytes = peak.peakBytes();
+            if (fTileSize > 0 && result) {
+                fPeakBytes += result->getSize();  // pieced together outside of any filter
+            }
+        }
+    }
+
+    void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        keys->push_back(SkString("peak_filter_outputs_mb"));
+        values->push_back(fPeakBytes / (1024.0 * 1024));
+    }
+
+private:
+    sk_sp<SkSpecialImage> filter(SkImageFilterCache* cache) const {
+        SkImageFilter::OutputProperties outputProperties(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight), cache,
+                                   outputProperties);
+        SkIPoint offset = SkIPoint::Make(0, 0);
+        return fTileSize > 0 ? fFilter->filterImageInTiles(fSource.get(), ctx, fTileSize, &offset)
+                             : fFilter->filterImage(fSource.get(), ctx, &offset);
+    }
+
+    static const int kWidth  = 3840;
+    static const int kHeight = 2160;
+
+    int                     fTileSize;
+    SkString                fName;
+    sk_sp<SkSpecialImage>   fSource;
+    sk_sp<SkImageFilter>    fFilter;
+    size_t                  fPeakBytes = 0;
+
+    typedef Benchmark INHERITED;
+};
+
 DEF_BENCH(return new ImageFilterDAGBench;)
 DEF_BENCH(return new ImageMakeWithFilterDAGBench;)
 DEF_BENCH(return new ImageFilterDisplacedBlur;)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(0);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(1);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(2);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(4);)
+DEF_BENCH(return new ImageFilterDAGThreadsBench(8);)
+DEF_BENCH(return new ImageFilterTiledBench(0);)
+DEF_BENCH(return new ImageFilterTiledBench(256);)
+DEF_BENCH(return new ImageFilterTiledBench(512);)
@@ -10,6 +10,7 @@
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkTArray.h"
 
 static const char* name(SkMatrixConvolutionImageFilter::TileMode mode) {
     switch (mode) {
@@ -68,3 +69,60 @@ DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kCl
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kRepeat_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, false); )
+
+// Emboss and sharpen sized kernels over a whole large layer.  Separable kernels are a column of
+// binomial weights times a row of them; dense ones are not the product of any two.
+class MatrixConvolutionLargeBench : public Benchmark {
+public:
+    MatrixConvolutionLargeBench(int kernelSize, bool separable)
+        : fName(SkStringPrintf("matrixconvolution_%dx%d_%s", kernelSize, kernelSize,
+                               separable ? "separable" : "dense")) {
+        SkTArray<SkScalar> binomial;
+        binomial.push_back(1);
+        for (int i = 1; i < kernelSize; ++i) {
+            binomial.push_back(binomial[i - 1] * (kernelSize - i) / i);
+        }
+        SkTArray<SkScalar> kernel;
+        SkScalar sum = 0;
+        SkRandom rand;
+        for (int y = 0; y < kernelSize; ++y) {
+            for (int x = 0; x < kernelSize; ++x) {
+                kernel.push_back(separable ? binomial[y] * binomial[x] : rand.nextRangeF(-1, 2));
+                sum += kernel.back();
+            }
+        }
+        fFilter = SkMatrixConvolutionImageFilter::Make(
+                SkISize::Make(kernelSize, kernelSize), kernel.begin(), 1 / sum, 0,
+                SkIPoint::Make(kernelSize / 2, kernelSize / 2),
+                SkMatrixConvolutionImageFilter::kClamp_TileMode, true, nullptr);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setImageFilter(fFilter);
+        SkPaint ovalPaint;
+        ovalPaint.setColor(0xFF4080C0);
+        const SkRect layer = SkRect::MakeWH(1024, 1024);
+        for (int i = 0; i < loops; i++) {
+            canvas->saveLayer(&layer, &paint);
+            canvas->drawOval(layer, ovalPaint);
+            canvas->restore();
+        }
+    }
+
+private:
+    sk_sp<SkImageFilter> fFilter;
+    SkString fName;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new MatrixConvolutionLargeBench(5, false); )
+DEF_BENCH( return new MatrixConvolutionLargeBench(5, true); )
+DEF_BENCH( return new MatrixConvolutionLargeBench(7, false); )
+DEF_BENCH( return new MatrixConvolutionLargeBench(7, true); )
@@ -38,6 +38,8 @@ DEF_BENCH(return new WStreamWriteTextBenchmark;)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "ProcStats.h"
+#include "SkCanvas.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFDocument.h"
 #include "SkPDFShader.h"
@@ -243,6 +245,115 @@ struct WritePDFTextBenchmark : public Benchmark {
     }
 };
 
+// Writes a document where each page draws its own image and some text, as a
+// long statement would, and reports how much the resident set grows.
+struct PDFPagesBench : public Benchmark {
+    static const int kPageCount = 200;
+    const bool fStreamPages;
+    SkString fName;
+    int fPeakGrowthMB = 0;
+
+    PDFPagesBench(bool streamPages) : fStreamPages(streamPages) {
+        fName.printf("PDFPages_%d%s", kPageCount, streamPages ? "_streaming" : "");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    template <typename Fn>
+    void writeDocument(Fn&& afterPage) {
+        SkDocument::PDFMetadata metadata;
+        metadata.fStreamPages = fStreamPages;
+        SkAutoPixmapStorage pixmap;
+        pixmap.alloc(SkImageInfo::MakeN32Premul(256, 256));
+        SkRandom random;
+        SkPaint paint;
+        const char text[] = "Statement of account";
+        SkNullWStream stream;
+        sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream, SK_ScalarDefaultRasterDPI,
+                                                    metadata, nullptr, false);
+        for (int page = 0; page < kPageCount; ++page) {
+            pixmap.erase(random.nextU() | 0xFF000000);
+            SkCanvas* canvas = doc->beginPage(612, 792);
+            canvas->drawImage(SkImage::MakeRasterCopy(pixmap), 72, 72);
+            canvas->drawText(text, strlen(text), 72, 400, paint);
+            doc->endPage();
+            afterPage();
+        }
+        doc->close();
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            this->writeDocument([] {});
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        // Sampled on a run of its own, so the system calls stay out of the timings.
+        const int baselineMB = sk_tools::getCurrResidentSetSizeMB();
+        fPeakGrowthMB = 0;
+        this->writeDocument([&] {
+            const int currentMB = sk_tools::getCurrResidentSetSizeMB();
+            if (baselineMB >= 0 && currentMB >= 0) {
+                fPeakGrowthMB = SkTMax(fPeakGrowthMB, currentMB - baselineMB);
+            }
+        });
+    }
+    void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        keys->push_back(SkString("peak_rss_growth_mb"));
+        values->push_back(fPeakGrowthMB);
+    }
+};
+
+// Writes a document where every page draws the same logo, decoded into a new
+// SkImage each time as a document assembled from separate parts would, and
+// reports the size of the output.
+struct PDFRepeatedImageBench : public Benchmark {
+    static const int kPageCount = 50;
+    const bool fEncoded;
+    SkString fName;
+    sk_sp<SkData> fEncodedData;
+    SkBitmap fBitmap;
+    size_t fBytesWritten = 0;
+
+    PDFRepeatedImageBench(bool encoded) : fEncoded(encoded) {
+        fName.printf("PDFRepeatedImage_%s", encoded ? "jpeg" : "raster");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        sk_sp<SkImage> img(GetResourceAsImage("mandrill_512_q075.jpg"));
+        if (!img) { return; }
+        fEncodedData.reset(img->refEncoded());
+        img->asLegacyBitmap(&fBitmap, SkImage::kRO_LegacyBitmapMode);
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fEncodedData || fBitmap.drawsNothing()) {
+            SkDEBUGFAIL("");
+            return;
+        }
+        SkPixmap pixmap;
+        SkAssertResult(fBitmap.peekPixels(&pixmap));
+        while (loops-- > 0) {
+            SkDynamicMemoryWStream stream;
+            sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream);
+            for (int page = 0; page < kPageCount; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                canvas->drawImage(fEncoded ? SkImage::MakeFromEncoded(fEncodedData)
+                                           : SkImage::MakeRasterCopy(pixmap), 50, 50);
+                doc->endPage();
+            }
+            doc->close();
+            fBytesWritten = stream.bytesWritten();
+        }
+    }
+    void getMetrics(SkTArray<SkString>* keys, SkTArray<double>* values) override {
+        keys->push_back(SkString("bytes"));
+        values->push_back(fBytesWritten);
+    }
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -251,6 +362,10 @@ DEF_BENCH(return new PDFScalarBench;)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
+DEF_BENCH(return new PDFPagesBench(false);)
+DEF_BENCH(return new PDFPagesBench(true);)
+DEF_BENCH(return new PDFRepeatedImageBench(true);)
+DEF_BENCH(return new PDFRepeatedImageBench(false);)
 
 #endif
 
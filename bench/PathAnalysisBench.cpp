@@ -0,0 +1,117 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+
+// Asks copies of one static path the same questions again and again, the way a path kept in a
+// picture or a UI element is asked every frame. Copies share their points, and with them the
+// answers, so only the first copy should pay for each.
+//
+// The dynamic variants rebuild the path before each question instead, the way an animated path
+// is, so nothing can be reused: they time what keeping the answers costs when it does not pay.
+class PathAnalysisBench : public Benchmark {
+public:
+    enum Kind {
+        kConvexity_Kind,
+        kTightBounds_Kind,
+        kDraw_Kind,
+        kDynamicConvexity_Kind,
+        kDynamicDraw_Kind,
+    };
+
+    PathAnalysisBench(Kind kind) : fKind(kind) {
+        static const char* kNames[] = {
+            "convexity", "tight_bounds", "draw", "dynamic_convexity", "dynamic_draw",
+        };
+        fName.printf("path_analysis_%s", kNames[kind]);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        bool draws = kDraw_Kind == fKind || kDynamicDraw_Kind == fKind;
+        return draws ? kNonRendering_Backend != backend
+                     : kNonRendering_Backend == backend;
+    }
+
+    void onDelayedSetup() override {
+        if (kTightBounds_Kind == fKind) {
+            // Control points stray outside the curves, so the tight bounds take pathops.
+            fPath.moveTo(10, 100);
+            for (int i = 0; i < 64; ++i) {
+                SkScalar x = 10 + 6 * i;
+                fPath.cubicTo(x + 2, 0, x + 4, 200, x + 6, 100);
+            }
+            fPath.lineTo(400, 300);
+            fPath.lineTo(10, 300);
+            fPath.close();
+        } else {
+            // Convex, so finding out takes every point.
+            const int kPoints = 4096;
+            for (int i = 0; i < kPoints; ++i) {
+                SkScalar angle = 2 * SK_ScalarPI * i / kPoints;
+                *fPoints.append() = SkPoint::Make(200 + 200 * SkScalarCos(angle),
+                                                  200 + 200 * SkScalarSin(angle));
+            }
+            fPath.addPoly(fPoints.begin(), fPoints.count(), true);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < loops; ++i) {
+            SkPath copy(fPath);
+            if (kDynamicConvexity_Kind == fKind || kDynamicDraw_Kind == fKind) {
+                fPath.rewind();
+                fPath.addPoly(fPoints.begin(), fPoints.count(), true);
+            }
+            switch (fKind) {
+                case kConvexity_Kind:
+                    (void)copy.isConvex();
+                    break;
+                case kTightBounds_Kind: {
+                    SkRect bounds;
+                    (void)TightBounds(copy, &bounds);
+                    break;
+                }
+                case kDraw_Kind:
+                    canvas->drawPath(copy, paint);
+                    break;
+                case kDynamicConvexity_Kind:
+                    (void)fPath.isConvex();
+                    break;
+                case kDynamicDraw_Kind:
+                    canvas->drawPath(fPath, paint);
+                    break;
+            }
+        }
+    }
+
+private:
+    Kind     fKind;
+    SkString fName;
+    SkPath   fPath;
+    SkTDArray<SkPoint> fPoints;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathAnalysisBench(PathAnalysisBench::kConvexity_Kind); )
+DEF_BENCH( return new PathAnalysisBench(PathAnalysisBench::kTightBounds_Kind); )
+DEF_BENCH( return new PathAnalysisBench(PathAnalysisBench::kDraw_Kind); )
+DEF_BENCH( return new PathAnalysisBench(PathAnalysisBench::kDynamicConvexity_Kind); )
+DEF_BENCH( return new PathAnalysisBench(PathAnalysisBench::kDynamicDraw_Kind); )
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRRect.h"
+#include "SkString.h"
+
+// Times Op() on the kinds of paths clips and hit regions are combined from, both exactly and
+// to within a quarter pixel, and on two pairs from the pathops test corpus: rRect1x from
+// PathOpsOpTest and issue414409 from PathOpsBattles. PathOpsApproximate and
+// PathOpsApproximateCorpus in tests/ check that the approximate results of the same pairs stay
+// within the tolerance.
+class PathOpsApproximateBench : public Benchmark {
+public:
+    enum Shapes {
+        kCircles_Shapes,
+        kRRects_Shapes,
+        kCubics_Shapes,
+        kRRect1x_Shapes,
+        kIssue414409_Shapes,
+    };
+
+    PathOpsApproximateBench(Shapes shapes, SkPathOp op, bool approximate)
+        : fShapes(shapes), fOp(op) {
+        static const char* kShapeNames[] = {
+            "circles", "rrects", "cubics", "rrect1x", "issue414409",
+        };
+        static const char* kOpNames[] = { "diff", "sect", "union", "xor", "rdiff" };
+        fName.printf("pathops_%s_%s_%s", approximate ? "approximate" : "exact",
+                     kShapeNames[shapes], kOpNames[op]);
+        fOptions.fPrecision = approximate ? SkPathOpsOptions::kApproximate_Precision
+                                          : SkPathOpsOptions::kExact_Precision;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onDelayedSetup() override {
+        switch (fShapes) {
+            case kCircles_Shapes:
+                fOne.addCircle(100, 100, 80);
+                fTwo.addCircle(160, 120, 70);
+                break;
+            case kRRects_Shapes:
+                fOne.addRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(40, 30, 260, 180), 20, 20));
+                fTwo.addRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(100, 80, 400, 300), 30, 30));
+                break;
+            case kCubics_Shapes:
+                fOne.moveTo(10, 10);
+                fOne.cubicTo(200, 0, -50, 100, 120, 120);
+                fOne.cubicTo(300, 50, 0, 300, 10, 10);
+                fTwo.moveTo(60, 0);
+                fTwo.cubicTo(250, 90, -80, 40, 150, 200);
+                fTwo.cubicTo(-20, 250, 200, -40, 60, 0);
+                break;
+            case kRRect1x_Shapes:
+                fOne.setFillType(SkPath::kEvenOdd_FillType);
+                fOne.moveTo(20.65f, 5.65f);
+                fOne.conicTo(20.65f, 1.13612f, 25.1404f, 0.65f, 0.888488f);
+                fOne.lineTo(25.65f, 0.65f);
+                fOne.lineTo(26.1596f, 0.67604f);
+                fOne.conicTo(30.65f, 1.13612f, 30.65f, 5.65f, 0.888488f);
+                fOne.lineTo(30.65f, 25.65f);
+                fOne.conicTo(30.65f, 20.65f, 25.65f, 20.65f, 0.707107f);
+                fOne.lineTo(20.65f, 20.65f);
+                fOne.lineTo(20.65f, 5.65f);
+                fOne.close();
+                fOne.moveTo(20.65f, 20.65f);
+                fOne.lineTo(5.65f, 20.65f);
+                fOne.conicTo(0.65f, 20.65f, 0.65f, 25.65f, 0.707107f);
+                fOne.lineTo(0.65f, 45.65f);
+                fOne.conicTo(0.65f, 50.65f, 5.65f, 50.65f, 0.707107f);
+                fOne.lineTo(25.65f, 50.65f);
+                fOne.conicTo(30.65f, 50.65f, 30.65f, 45.65f, 0.707107f);
+                fOne.lineTo(30.65f, 25.65f);
+                fOne.conicTo(30.65f, 30.65f, 25.65f, 30.65f, 0.707107f);
+                fOne.conicTo(20.65f, 30.65f, 20.65f, 25.65f, 0.707107f);
+                fOne.lineTo(20.65f, 20.65f);
+                fOne.close();
+                fTwo.moveTo(20.65f, 45.65f);
+                fTwo.lineTo(20.65f, 25.65f);
+                fTwo.conicTo(20.65f, 20.65f, 25.65f, 20.65f, 0.707107f);
+                fTwo.lineTo(45.65f, 20.65f);
+                fTwo.conicTo(50.65f, 20.65f, 50.65f, 25.65f, 0.707107f);
+                fTwo.lineTo(50.65f, 45.65f);
+                fTwo.conicTo(50.65f, 50.65f, 45.65f, 50.65f, 0.707107f);
+                fTwo.lineTo(25.65f, 50.65f);
+                fTwo.conicTo(20.65f, 50.65f, 20.65f, 45.65f, 0.707107f);
+                fTwo.close();
+                break;
+            case kIssue414409_Shapes:
+                fOne.moveTo(9.53595e-07f, -60);
+                fOne.lineTo(5.08228e-15f, -83);
+                fOne.cubicTo(32.8673f, -83, 62.6386f, -63.6055f, 75.9208f, -33.5416f);
+                fOne.cubicTo(89.2029f, -3.47759f, 83.4937f, 31.5921f, 61.3615f, 55.8907f);
+                fOne.lineTo(46.9383f, 68.4529f);
+                fOne.lineTo(33.9313f, 49.484f);
+                fOne.cubicTo(37.7451f, 46.8689f, 41.2438f, 43.8216f, 44.3577f, 40.4029f);
+                fOne.lineTo(44.3577f, 40.4029f);
+                fOne.cubicTo(60.3569f, 22.8376f, 64.4841f, -2.51392f, 54.8825f, -24.2469f);
+                fOne.cubicTo(45.2809f, -45.9799f, 23.7595f, -60, 9.53595e-07f, -60);
+                fOne.close();
+                fTwo.moveTo(46.9383f, 68.4529f);
+                fTwo.cubicTo(17.5117f, 88.6307f, -21.518f, 87.7442f, -49.9981f, 66.251f);
+                fTwo.cubicTo(-78.4781f, 44.7578f, -90.035f, 7.46781f, -78.7014f, -26.3644f);
+                fTwo.cubicTo(-67.3679f, -60.1967f, -35.6801f, -83, -1.48383e-06f, -83);
+                fTwo.lineTo(4.22689e-14f, -60);
+                fTwo.cubicTo(-25.7929f, -60, -48.6997f, -43.5157f, -56.8926f, -19.0586f);
+                fTwo.cubicTo(-65.0855f, 5.39842f, -56.7312f, 32.355f, -36.1432f, 47.8923f);
+                fTwo.cubicTo(-15.5552f, 63.4296f, 12.6591f, 64.0704f, 33.9313f, 49.484f);
+                fTwo.lineTo(46.9383f, 68.4529f);
+                fTwo.close();
+                break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result;
+            Op(fOne, fTwo, fOp, fOptions, &result);
+        }
+    }
+
+private:
+    Shapes           fShapes;
+    SkPathOp         fOp;
+    SkPathOpsOptions fOptions;
+    SkString         fName;
+    SkPath           fOne;
+    SkPath           fTwo;
+
+    typedef Benchmark INHERITED;
+};
+
+#define BENCHES(shapes, op)                                                         \
+    DEF_BENCH( return new PathOpsApproximateBench(                              \
+            PathOpsApproximateBench::k##shapes##_Shapes, op, false); )           \
+    DEF_BENCH( return new PathOpsApproximateBench(                              \
+            PathOpsApproximateBench::k##shapes##_Shapes, op, true); )
+
+BENCHES(Circles, kUnion_SkPathOp)
+BENCHES(Circles, kIntersect_SkPathOp)
+BENCHES(RRects, kIntersect_SkPathOp)
+BENCHES(RRects, kDifference_SkPathOp)
+BENCHES(Cubics, kUnion_SkPathOp)
+BENCHES(Cubics, kXOR_SkPathOp)
+BENCHES(RRect1x, kDifference_SkPathOp)
+BENCHES(Issue414409, kUnion_SkPathOp)
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkExecutor.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+// Unions fCount random, mostly non-convex polygons scattered over a square, the way map data is
+// preprocessed: some overlap their neighbors, many stand alone.  fThreads is the size of the pool
+// handed to SkOpBuilder::resolve(), or 0 to resolve without an executor.
+class PathOpsBuilderUnionBench : public Benchmark {
+public:
+    PathOpsBuilderUnionBench(int count, int threads) : fCount(count), fThreads(threads) {
+        fName.printf("pathops_builder_union_%d_threads_%d", count, threads);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        // Spread the polygons out so that they cover the square about twice over.
+        const SkScalar extent = 20 * SkScalarSqrt(SkIntToScalar(fCount));
+        for (int i = 0; i < fCount; ++i) {
+            const SkPoint center = SkPoint::Make(rand.nextRangeScalar(0, extent),
+                                                 rand.nextRangeScalar(0, extent));
+            const int sides = rand.nextRangeU(3, 9);
+            SkPath& path = fPaths.push_back();
+            for (int side = 0; side < sides; ++side) {
+                const SkScalar angle = 2 * SK_ScalarPI * side / sides;
+                const SkScalar radius = rand.nextRangeScalar(4, 24);
+                const SkPoint pt = center + SkPoint::Make(radius * SkScalarCos(angle),
+                                                          radius * SkScalarSin(angle));
+                if (0 == side) {
+                    path.moveTo(pt);
+                } else {
+                    path.lineTo(pt);
+                }
+            }
+            path.close();
+        }
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkOpBuilder builder;
+            for (const SkPath& path : fPaths) {
+                builder.add(path, kUnion_SkPathOp);
+            }
+            SkPath result;
+            SkAssertResult(builder.resolve(&result, fExecutor.get()));
+        }
+    }
+
+private:
+    int                          fCount;
+    int                          fThreads;
+    SkString                     fName;
+    SkTArray<SkPath>             fPaths;
+    std::unique_ptr<SkExecutor>  fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathOpsBuilderUnionBench(500, 0); )
+DEF_BENCH( return new PathOpsBuilderUnionBench(500, 4); )
+DEF_BENCH( return new PathOpsBuilderUnionBench(4000, 0); )
+DEF_BENCH( return new PathOpsBuilderUnionBench(4000, 4); )
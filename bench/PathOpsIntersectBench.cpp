@@ -0,0 +1,123 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+
+// Builds a closed polygon of count points around a noisy circle, like a coastline.
+static SkPath make_coastline(int count, SkScalar dx, uint32_t seed) {
+    SkRandom rand(seed);
+    SkPath path;
+    for (int i = 0; i < count; ++i) {
+        const SkScalar angle = 2 * SK_ScalarPI * i / count;
+        const SkScalar radius = 500 + rand.nextRangeScalar(-20, 20);
+        const SkPoint pt = SkPoint::Make(dx + radius * SkScalarCos(angle),
+                                         radius * SkScalarSin(angle));
+        if (0 == i) {
+            path.moveTo(pt);
+        } else {
+            path.lineTo(pt);
+        }
+    }
+    path.close();
+    return path;
+}
+
+// Strokes a random walk of count points; filled, the outline crosses itself wherever the walk
+// does, the way stroked map roads and handwriting do before they are simplified.
+static SkPath make_stroked_scribble(int count) {
+    SkRandom rand;
+    SkPath walk;
+    SkPoint pt = SkPoint::Make(0, 0);
+    walk.moveTo(pt);
+    for (int i = 1; i < count; ++i) {
+        pt += SkPoint::Make(rand.nextRangeScalar(-8, 8), rand.nextRangeScalar(-8, 8));
+        walk.lineTo(pt);
+    }
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    SkPath outline;
+    paint.getFillPath(walk, &outline);
+    return outline;
+}
+
+// Times Simplify() or Op() on inputs of growing size, to show how intersecting their segments
+// scales with the number of segments in a contour.
+class PathOpsIntersectBench : public Benchmark {
+public:
+    enum Kind {
+        kSimplifyCoastline_Kind,
+        kUnionCoastlines_Kind,
+        kSimplifyStroke_Kind,
+    };
+
+    PathOpsIntersectBench(Kind kind, int count) : fKind(kind), fCount(count) {
+        static const char* kNames[] = { "simplify_coastline", "union_coastlines",
+                                        "simplify_stroke" };
+        fName.printf("pathops_intersect_%s_%d", kNames[kind], count);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onDelayedSetup() override {
+        switch (fKind) {
+            case kSimplifyCoastline_Kind:
+                fOne = make_coastline(fCount, 0, 0);
+                break;
+            case kUnionCoastlines_Kind:
+                fOne = make_coastline(fCount, 0, 1);
+                fTwo = make_coastline(fCount, 300, 2);
+                break;
+            case kSimplifyStroke_Kind:
+                fOne = make_stroked_scribble(fCount);
+                break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result;
+            if (kUnionCoastlines_Kind == fKind) {
+                Op(fOne, fTwo, kUnion_SkPathOp, &result);
+            } else {
+                Simplify(fOne, &result);
+            }
+        }
+    }
+
+private:
+    Kind     fKind;
+    int      fCount;
+    SkString fName;
+    SkPath   fOne;
+    SkPath   fTwo;
+
+    typedef Benchmark INHERITED;
+};
+
+using K = PathOpsIntersectBench;
+DEF_BENCH( return new PathOpsIntersectBench(K::kSimplifyCoastline_Kind, 1000); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kSimplifyCoastline_Kind, 4000); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kSimplifyCoastline_Kind, 16000); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kUnionCoastlines_Kind, 1000); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kUnionCoastlines_Kind, 4000); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kUnionCoastlines_Kind, 16000); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kSimplifyStroke_Kind, 250); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kSimplifyStroke_Kind, 1000); )
+DEF_BENCH( return new PathOpsIntersectBench(K::kSimplifyStroke_Kind, 4000); )
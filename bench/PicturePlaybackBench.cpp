@@ -134,12 +134,40 @@ private:
     typedef PicturePlaybackBench INHERITED;
 };
 
+// Table-like content: long runs of same-paint rects, alternating with a second paint every row
+// when fAlternate is set so that no two consecutive rects can be coalesced.
+class RectGridPlaybackBench : public PicturePlaybackBench {
+public:
+    RectGridPlaybackBench(bool alternate)
+        : INHERITED(alternate ? "drawRect_alternating" : "drawRect_grid")
+        , fAlternate(alternate) { }
+protected:
+    void recordCanvas(SkCanvas* canvas) override {
+        SkPaint paints[2];
+        paints[0].setColor(0xFFE0E0E0);
+        paints[1].setColor(0xFFC0C0F0);
+
+        const SkScalar kCell = 10;
+        int n = 0;
+        for (SkScalar y = 0; y < fPictureHeight; y += kCell) {
+            for (SkScalar x = 0; x < fPictureWidth; x += kCell) {
+                canvas->drawRect(SkRect::MakeXYWH(x, y, kCell - 1, kCell - 1),
+                                 paints[fAlternate ? (n++ & 1) : 0]);
+            }
+        }
+    }
+private:
+    bool fAlternate;
+    typedef PicturePlaybackBench INHERITED;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new TextPlaybackBench(); )
 DEF_BENCH( return new PosTextPlaybackBench(true); )
 DEF_BENCH( return new PosTextPlaybackBench(false); )
+DEF_BENCH( return new RectGridPlaybackBench(false); )
+DEF_BENCH( return new RectGridPlaybackBench(true); )
 
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
@@ -95,6 +95,62 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Time culling a large picture's ops against every tile of a grid, as tiled playback does.
+class RTreeTileQueryBench : public Benchmark {
+public:
+    RTreeTileQueryBench(const char* name, MakeRectProc proc, int numRects, int tileSize)
+        : fProc(proc), fNumRects(numRects), fTileSize(tileSize) {
+        fName.printf("rtree_%s_tilequery_%d_%d", name, numRects, tileSize);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+    void onDelayedSetup() override {
+        SkRandom rand;
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
+        }
+        fTree.insert(rects.get(), fNumRects);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkRect bounds = fTree.getRootBound();
+        SkTDArray<int> hits;
+        for (int i = 0; i < loops; ++i) {
+            for (SkScalar y = bounds.fTop; y < bounds.fBottom; y += fTileSize) {
+                for (SkScalar x = bounds.fLeft; x < bounds.fRight; x += fTileSize) {
+                    hits.rewind();
+                    fTree.search(SkRect::MakeXYWH(x, y, fTileSize, fTileSize), &hits);
+                }
+            }
+        }
+    }
+private:
+    SkRTree fTree;
+    MakeRectProc fProc;
+    int fNumRects;
+    int fTileSize;
+    SkString fName;
+    typedef Benchmark INHERITED;
+};
+
+// Small rects densely tiling the plane in drawing order, like the ops of a long web page.
+static inline SkRect make_page_rects(SkRandom& rand, int index, int numRects) {
+    static const int kColumns = 250;
+    SkRect out;
+    out.fLeft   = SkIntToScalar(index % kColumns) * 4;
+    out.fTop    = SkIntToScalar(index / kColumns) * 4;
+    out.fRight  = out.fLeft + 1 + rand.nextRangeF(0, 16);
+    out.fBottom = out.fTop  + 1 + rand.nextRangeF(0, 16);
+    return out;
+}
+
 static inline SkRect make_XYordered_rects(SkRandom& rand, int index, int numRects) {
     SkRect out;
     out.fLeft   = SkIntToScalar(index % GRID_WIDTH);
@@ -136,3 +192,7 @@ DEF_BENCH(return new RTreeQueryBench("XY", &make_XYordered_rects));
 DEF_BENCH(return new RTreeQueryBench("YX", &make_YXordered_rects));
 DEF_BENCH(return new RTreeQueryBench("random", &make_random_rects));
 DEF_BENCH(return new RTreeQueryBench("concentric", &make_concentric_rects));
+
+DEF_BENCH(return new RTreeTileQueryBench("page", &make_page_rects, 100000, 256));
+DEF_BENCH(return new RTreeTileQueryBench("page", &make_page_rects, 100000, 64));
+DEF_BENCH(return new RTreeTileQueryBench("random", &make_random_rects, 100000, 256));
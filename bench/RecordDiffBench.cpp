@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkPictureRecorder.h"
+#include "SkRecordDiff.h"
+#include "SkRegion.h"
+#include "SkString.h"
+
+// A large, mostly static picture (a table of labelled cells) where one cell changes color
+// between frames.  Measures the cost of computing the damage, and of re-rasterizing the new
+// frame in full versus just its damage.
+class RecordDiffBench : public Benchmark {
+public:
+    enum Mode { kDiff_Mode, kRedrawFull_Mode, kRedrawDamage_Mode };
+
+    explicit RecordDiffBench(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "diff", "redraw_full", "redraw_damage" };
+        fName.printf("record_damage_%s", kNames[mode]);
+    }
+
+protected:
+    static const int kSize = 1024;
+    static const int kCell = 32;
+
+    const char* onGetName() override { return fName.c_str(); }
+    SkIPoint onGetSize() override { return SkIPoint::Make(kSize, kSize); }
+    bool isSuitableFor(Backend backend) override {
+        return fMode == kDiff_Mode ? backend == kNonRendering_Backend
+                                   : backend != kNonRendering_Backend;
+    }
+
+    static sk_sp<SkPicture> Record(int highlighted) {
+        SkPaint cell, highlight, text;
+        cell.setColor(0xFFF0F0F0);
+        highlight.setColor(0xFFFFE080);
+        text.setAntiAlias(true);
+        text.setTextSize(10);
+
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize, &factory);
+        int i = 0;
+        for (int y = 0; y < kSize; y += kCell) {
+            for (int x = 0; x < kSize; x += kCell, i++) {
+                canvas->save();
+                canvas->translate(SkIntToScalar(x), SkIntToScalar(y));
+                canvas->drawRect(SkRect::MakeWH(kCell - 2, kCell - 2),
+                                 i == highlighted ? highlight : cell);
+                SkString label;
+                label.printf("%d", i);
+                canvas->drawText(label.c_str(), label.size(), 2, 20, text);
+                canvas->restore();
+            }
+        }
+        return recorder.finishRecordingAsPicture();
+    }
+
+    void onDelayedSetup() override {
+        const int cells = (kSize / kCell) * (kSize / kCell);
+        fBefore = Record(cells / 3);
+        fAfter  = Record(cells / 3 + 1);
+        SkPictureComputeDamage(fBefore.get(), fAfter.get(), SkMatrix::I(), &fDamage);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkRegion damage;
+        for (int i = 0; i < loops; i++) {
+            switch (fMode) {
+                case kDiff_Mode:
+                    SkPictureComputeDamage(fBefore.get(), fAfter.get(), SkMatrix::I(), &damage);
+                    break;
+                case kRedrawFull_Mode:
+                    canvas->clear(SK_ColorWHITE);
+                    canvas->drawPicture(fAfter);
+                    break;
+                case kRedrawDamage_Mode:
+                    canvas->save();
+                    canvas->clipRegion(fDamage);
+                    canvas->clear(SK_ColorWHITE);
+                    canvas->drawPicture(fAfter);
+                    canvas->restore();
+                    break;
+            }
+        }
+    }
+
+private:
+    Mode             fMode;
+    SkString         fName;
+    sk_sp<SkPicture> fBefore, fAfter;
+    SkRegion         fDamage;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new RecordDiffBench(RecordDiffBench::kDiff_Mode); )
+DEF_BENCH( return new RecordDiffBench(RecordDiffBench::kRedrawFull_Mode); )
+DEF_BENCH( return new RecordDiffBench(RecordDiffBench::kRedrawDamage_Mode); )
@@ -71,8 +71,22 @@ void RecordingBench::onDraw(int loops, SkCanvas*) {
 #include "SkPipe.h"
 #include "SkStream.h"
 
-PipingBench::PipingBench(const char* name, const SkPicture* pic) : INHERITED(name, pic) {
-    fName.prepend("pipe_");
+PipingBench::PipingBench(const char* name, const SkPicture* pic, bool fresh)
+    : INHERITED(name, pic)
+    , fFresh(fresh) {
+    fName.prepend(fresh ? "pipe_fresh_" : "pipe_");
+
+    SkDynamicMemoryWStream stream;
+    SkPipeSerializer serializer;
+    for (int frame = 0; frame < 2; ++frame) {
+        stream.reset();
+        if (fFresh) {
+            serializer.resetCache();
+        }
+        fSrc->playback(serializer.beginWrite(fSrc->cullRect(), &stream));
+        serializer.endWrite();
+    }
+    fBytesPerFrame = stream.bytesWritten();
 }
 
 void PipingBench::onDraw(int loops, SkCanvas*) {
@@ -80,8 +94,41 @@ void PipingBench::onDraw(int loops, SkCanvas*) {
     SkPipeSerializer serializer;
 
     while (loops --> 0) {
+        if (fFresh) {
+            serializer.resetCache();
+        }
         fSrc->playback(serializer.beginWrite(fSrc->cullRect(), &stream));
         serializer.endWrite();
         stream.reset();
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SerializingBench::SerializingBench(const char* name, const SkPicture* pic, bool threaded,
+                                   bool deserialize)
+    : INHERITED(name, pic)
+    , fDeserialize(deserialize) {
+    fName.prepend(deserialize ? "deserialize_" : "serialize_");
+    if (threaded) {
+        fName.append("_mt");
+        fExecutor = SkExecutor::MakeThreadPool();
+    }
+    if (deserialize) {
+        fSerialized = fSrc->serialize();
+    }
+}
+
+void SerializingBench::onDraw(int loops, SkCanvas*) {
+    if (fDeserialize) {
+        while (loops --> 0) {
+            (void)SkPicture::MakeFromData(fSerialized.get(), nullptr, fExecutor.get());
+        }
+    } else {
+        SkDynamicMemoryWStream stream;
+        while (loops --> 0) {
+            fSrc->serialize(&stream, nullptr, fExecutor.get());
+            stream.reset();
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #define RecordingBench_DEFINED
 
 #include "Benchmark.h"
+#include "SkExecutor.h"
 #include "SkPicture.h"
 #include "SkLiteDL.h"
 
@@ -42,14 +43,39 @@ private:
     typedef PictureCentricBench INHERITED;
 };
 
+// Pipes the picture once per loop, as if it were a frame of an animation.  Frames share one
+// SkPipeSerializer, so images and typefaces are only sent by the first, unless fresh is set.
 class PipingBench : public PictureCentricBench {
 public:
-    PipingBench(const char* name, const SkPicture*);
+    PipingBench(const char* name, const SkPicture*, bool fresh);
+
+    // Size of a frame piped after the first.
+    size_t bytesPerFrame() const { return fBytesPerFrame; }
+
+protected:
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    bool   fFresh;
+    size_t fBytesPerFrame;
+
+    typedef PictureCentricBench INHERITED;
+};
+
+// Serializes the picture, or deserializes it, optionally flattening and decoding paths and
+// images on a thread pool.
+class SerializingBench : public PictureCentricBench {
+public:
+    SerializingBench(const char* name, const SkPicture*, bool threaded, bool deserialize);
 
 protected:
     void onDraw(int loops, SkCanvas*) override;
 
 private:
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkData>               fSerialized;
+    bool                        fDeserialize;
+
     typedef PictureCentricBench INHERITED;
 };
 
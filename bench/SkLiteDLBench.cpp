@@ -0,0 +1,98 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkColorFilter.h"
+#include "SkGradientShader.h"
+#include "SkLiteDL.h"
+#include "SkLiteRecorder.h"
+#include "SkRRect.h"
+#include "SkString.h"
+
+// Records a typical scrolling-list UI frame into an SkLiteDL over and over, the way a renderer
+// would from one frame to the next.  Each frame moves the highlighted row, so most ops are
+// unchanged and a few aren't.
+//   - fresh:  a new SkLiteDL every frame;
+//   - reset:  one SkLiteDL, reset() between frames (keeps storage);
+//   - rewind: one SkLiteDL, rewind() between frames (keeps storage and recycles ops).
+class SkLiteDLFramesBench : public Benchmark {
+public:
+    enum Mode { kFresh_Mode, kReset_Mode, kRewind_Mode };
+
+    explicit SkLiteDLFramesBench(Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "fresh", "reset", "rewind" };
+        fName.printf("lite_dl_frames_%s", kNames[mode]);
+    }
+
+protected:
+    static const int kRows = 100;
+
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        const SkPoint pts[] = {{0,0}, {0,48}};
+        const SkColor colors[] = { 0xFFFFFFFF, 0xFFE0E0E0 };
+        fRow.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                    SkShader::kClamp_TileMode));
+        fRow.setAntiAlias(true);
+        fHighlight = fRow;
+        fHighlight.setColorFilter(SkColorFilter::MakeModeFilter(0x403366FF,
+                                                                SkBlendMode::kSrcOver));
+        fText.setAntiAlias(true);
+        fText.setTextSize(14);
+    }
+
+    void drawFrame(SkCanvas* canvas, int highlighted) {
+        canvas->drawColor(SK_ColorWHITE);
+        for (int i = 0; i < kRows; i++) {
+            canvas->save();
+            canvas->translate(0, i * 48.0f);
+            canvas->clipRect(SkRect::MakeWH(480, 48));
+            canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(480, 46), 4, 4),
+                              i == highlighted ? fHighlight : fRow);
+            canvas->drawText("Hamburgefons", 12, 16, 30, fText);
+            canvas->restore();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkIRect bounds = {0, 0, 480, kRows * 48};
+        SkLiteRecorder rec;
+        SkLiteDL dl;
+        for (int i = 0; i < loops; i++) {
+            switch (fMode) {
+                case kFresh_Mode: {
+                    SkLiteDL fresh;
+                    rec.reset(&fresh, bounds);
+                    this->drawFrame(&rec, i % kRows);
+                } break;
+                case kReset_Mode:
+                    dl.reset();
+                    rec.reset(&dl, bounds);
+                    this->drawFrame(&rec, i % kRows);
+                    break;
+                case kRewind_Mode:
+                    dl.rewind();
+                    rec.reset(&dl, bounds);
+                    this->drawFrame(&rec, i % kRows);
+                    break;
+            }
+        }
+    }
+
+private:
+    Mode     fMode;
+    SkString fName;
+    SkPaint  fRow, fHighlight, fText;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkLiteDLFramesBench(SkLiteDLFramesBench::kFresh_Mode); )
+DEF_BENCH( return new SkLiteDLFramesBench(SkLiteDLFramesBench::kReset_Mode); )
+DEF_BENCH( return new SkLiteDLFramesBench(SkLiteDLFramesBench::kRewind_Mode); )
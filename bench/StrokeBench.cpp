@@ -10,14 +10,33 @@
 #include "SkPath.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkStroke.h"
+
+class StrokeTester {
+public:
+    static void SetUsePolylineStroker(SkStroke* stroke, bool use) {
+        stroke->setUsePolylineStroker(use);
+    }
+};
 
 class StrokeBench : public Benchmark {
 public:
-    StrokeBench(const SkPath& path, const SkPaint& paint, const char pathType[], SkScalar res)
-        : fPath(path), fPaint(paint), fRes(res)
+    enum Mode {
+        kStroke_Mode,   // every stroke is built, by the polyline stroker if the path allows it
+        kGeneral_Mode,  // every stroke is built by the general stroker, skipping getFillPath()
+        kCached_Mode,   // the path is stroked twice, and then found in the stroke cache
+    };
+
+    StrokeBench(const SkPath& path, const SkPaint& paint, const char pathType[], SkScalar res,
+                Mode mode = kStroke_Mode)
+        : fPath(path), fPaint(paint), fRes(res), fMode(mode)
     {
-        fName.printf("build_stroke_%s_%g_%d_%d",
-                     pathType, paint.getStrokeWidth(), paint.getStrokeJoin(), paint.getStrokeCap());
+        static const char* kSuffixes[] = { "", "_general", "_cached" };
+        fName.printf("build_stroke_%s_%g_%d_%d%s",
+                     pathType, paint.getStrokeWidth(), paint.getStrokeJoin(), paint.getStrokeCap(),
+                     kSuffixes[mode]);
+        // Volatile paths are never cached, so the stroke is built every time.
+        fPath.setIsVolatile(kCached_Mode != mode);
     }
 
 protected:
@@ -31,6 +50,18 @@ protected:
         SkPaint paint(fPaint);
         this->setupPaint(&paint);
 
+        if (kGeneral_Mode == fMode) {
+            SkStroke stroke(paint);
+            stroke.setResScale(fRes);
+            StrokeTester::SetUsePolylineStroker(&stroke, false);
+            for (int outer = 0; outer < 10; ++outer) {
+                for (int i = 0; i < loops; ++i) {
+                    SkPath result;
+                    stroke.strokePath(fPath, &result);
+                }
+            }
+            return;
+        }
         for (int outer = 0; outer < 10; ++outer) {
             for (int i = 0; i < loops; ++i) {
                 SkPath result;
@@ -44,6 +75,7 @@ private:
     SkPaint     fPaint;
     SkString    fName;
     SkScalar    fRes;
+    Mode        fMode;
     typedef Benchmark INHERITED;
 };
 
@@ -66,6 +98,16 @@ static SkPath line_path_maker() {
     }
     return path;
 }
+// A chart plot: many short lines running left to right.
+static SkPath polyline_path_maker() {
+    SkPath path;
+    SkRandom rand;
+    path.moveTo(0, Y);
+    for (int i = 1; i < 10000; ++i) {
+        path.lineTo(i * 0.1f, Y + rand.nextSScalar1() * Y);
+    }
+    return path;
+}
 static SkPath quad_path_maker() {
     SkPath path;
     SkRandom rand;
@@ -103,6 +145,15 @@ static SkPaint paint_maker() {
     return paint;
 }
 
+static SkPaint round_paint_maker() {
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(2);
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+    paint.setStrokeCap(SkPaint::kRound_Cap);
+    return paint;
+}
+
 DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_1", 1);)
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_1", 1);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_1", 1);)
@@ -117,3 +168,14 @@ DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_.25", .
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_.25", .25f);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_.25", .25f);)
 DEF_BENCH(return new StrokeBench(cubic_path_maker(), paint_maker(), "cubic_.25", .25f);)
+
+DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_1", 1,
+                                 StrokeBench::kGeneral_Mode);)
+DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_1", 1,
+                                 StrokeBench::kCached_Mode);)
+
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), round_paint_maker(), "polyline_1", 1);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), round_paint_maker(), "polyline_1", 1,
+                                 StrokeBench::kGeneral_Mode);)
+DEF_BENCH(return new StrokeBench(polyline_path_maker(), round_paint_maker(), "polyline_1", 1,
+                                 StrokeBench::kCached_Mode);)
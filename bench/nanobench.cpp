@@ -574,6 +574,7 @@ public:
                       , fGMs(skiagm::GMRegistry::Head())
                       , fCurrentRecording(0)
                       , fCurrentPiping(0)
+                      , fCurrentSerializing(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
                       , fCurrentSVG(0)
@@ -718,9 +719,10 @@ public:
             return new RecordingBench(name.c_str(), pic.get(), FLAGS_bbh, FLAGS_lite);
         }
 
-        // Add all .skps as PipeBenches.
-        while (fCurrentPiping < fSKPs.count()) {
-            const SkString& path = fSKPs[fCurrentPiping++];
+        // Add all .skps as PipeBenches, with and without a dictionary shared across frames.
+        while (fCurrentPiping < 2 * fSKPs.count()) {
+            const int index = fCurrentPiping++;
+            const SkString& path = fSKPs[index / 2];
             sk_sp<SkPicture> pic = ReadPicture(path.c_str());
             if (!pic) {
                 continue;
@@ -728,9 +730,28 @@ public:
             SkString name = SkOSPath::Basename(path.c_str());
             fSourceType = "skp";
             fBenchType  = "piping";
+            fSKPOps   = pic->approximateOpCount();
+            PipingBench* bench = new PipingBench(name.c_str(), pic.get(), SkToBool(index & 1));
+            fSKPBytes = static_cast<double>(bench->bytesPerFrame());
+            return bench;
+        }
+
+        // Add all .skps as SerializingBenches: serialize and deserialize, each with and
+        // without a thread pool.
+        while (fCurrentSerializing < 4 * fSKPs.count()) {
+            const int index = fCurrentSerializing++;
+            const SkString& path = fSKPs[index / 4];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "serializing";
             fSKPBytes = static_cast<double>(pic->approximateBytesUsed());
             fSKPOps   = pic->approximateOpCount();
-            return new PipingBench(name.c_str(), pic.get());
+            return new SerializingBench(name.c_str(), pic.get(), SkToBool(index & 1),
+                                        SkToBool(index & 2));
         }
 
         // Then once each for each scale as SKPBenches (playback).
@@ -1026,7 +1047,7 @@ public:
                 log->configOption("multi_picture_draw", fUseMPDs[fCurrentUseMPD-1] ? "true" : "false");
             }
         }
-        if (0 == strcmp(fBenchType, "recording")) {
+        if (0 == strcmp(fBenchType, "recording") || 0 == strcmp(fBenchType, "piping")) {
             log->metric("bytes", fSKPBytes);
             log->metric("ops",   fSKPOps);
         }
@@ -1064,6 +1085,7 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
     int fCurrentPiping;
+    int fCurrentSerializing;
     int fCurrentScale;
     int fCurrentSKP;
     int fCurrentSVG;
@@ -1287,6 +1309,15 @@ int main(int argc, char** argv) {
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
             log->metrics("samples",    samples);
+            {
+                SkTArray<SkString> metricKeys;
+                SkTArray<double> metricValues;
+                bench->getMetrics(&metricKeys, &metricValues);
+                SkASSERT(metricKeys.count() == metricValues.count());
+                for (int i = 0; i < metricKeys.count(); i++) {
+                    log->metric(metricKeys[i].c_str(), metricValues[i]);
+                }
+            }
 #if SK_SUPPORT_GPU
             if (gpuStatsDump) {
                 // dump to json, only SKPBench currently returns valid keys / values
@@ -86,6 +86,15 @@ public:
          * The date and time the document was most recently modified.
          */
         OptionalTimestamp fModified;
+        /**
+         * If true, the objects each page refers to (images, shaders,
+         * form xobjects, ...) are written to the stream and released
+         * when the page ends, so memory use does not grow with the
+         * number of pages.  Fonts are still written when the document
+         * is closed.  Either way the output is a valid PDF, but the
+         * objects are written in a different order.
+         */
+        bool fStreamPages = false;
     };
 
     /**
@@ -113,6 +113,17 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  When enabled, raster devices look up the results of image filters (e.g. on saveLayer) in
+     *  the resource cache by the filter's content and the pixels it reads, so that layers
+     *  re-recorded unchanged from one frame to the next are not filtered again.
+     *
+     *  Disabled by default. GetImageFilterContentCacheStats() reports lookups since startup.
+     */
+    static bool GetImageFilterContentCacheEnabled();
+    static void SetImageFilterContentCacheEnabled(bool enabled);
+    static void GetImageFilterContentCacheStats(uint64_t* hits, uint64_t* misses);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
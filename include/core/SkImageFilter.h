@@ -20,6 +20,7 @@
 class GrContext;
 class GrFragmentProcessor;
 class SkColorFilter;
+class SkExecutor;
 struct SkIPoint;
 class SkSpecialImage;
 class SkImageFilterCache;
@@ -53,11 +54,14 @@ public:
     class Context {
     public:
         Context(const SkMatrix& ctm, const SkIRect& clipBounds, SkImageFilterCache* cache,
-                const OutputProperties& outputProperties)
+                const OutputProperties& outputProperties, SkExecutor* executor = nullptr,
+                const SkIRect* fullClipBounds = nullptr)
             : fCTM(ctm)
             , fClipBounds(clipBounds)
+            , fFullClipBounds(fullClipBounds ? *fullClipBounds : clipBounds)
             , fCache(cache)
             , fOutputProperties(outputProperties)
+            , fExecutor(executor)
         {}
 
         const SkMatrix& ctm() const { return fCTM; }
@@ -65,11 +69,25 @@ public:
         SkImageFilterCache* cache() const { return fCache; }
         const OutputProperties& outputProperties() const { return fOutputProperties; }
 
+        /**
+         *  If not null, raster filters may use this to evaluate independent inputs, and bands of
+         *  their own output, concurrently.  The caller must keep it alive while filtering.
+         */
+        SkExecutor* executor() const { return fExecutor; }
+
+        /**
+         *  While filterImageInTiles() filters one tile, clipBounds() are the tile's and these are
+         *  the clip bounds of the whole output it is part of.  Otherwise they are clipBounds().
+         */
+        const SkIRect& fullClipBounds() const { return fFullClipBounds; }
+
     private:
         SkMatrix               fCTM;
         SkIRect                fClipBounds;
+        SkIRect                fFullClipBounds;
         SkImageFilterCache*    fCache;
         OutputProperties       fOutputProperties;
+        SkExecutor*            fExecutor;
     };
 
     class CropRect {
@@ -131,6 +149,19 @@ public:
      */
     sk_sp<SkSpecialImage> filterImage(SkSpecialImage* src, const Context&, SkIPoint* offset) const;
 
+    /**
+     *  Like filterImage(), but evaluates the DAG one tileSize x tileSize tile of the output at a
+     *  time, narrowing the clip bounds to each tile in turn.  Every node then only produces, and
+     *  pulls from its inputs, what that tile needs (plus the node's own margins), so the
+     *  intermediates alive at once are bounded by the tile size rather than by the whole output.
+     *
+     *  Falls back to filterImage() if tileSize is not positive, src is texture-backed, or the
+     *  DAG cannot filterInTiles().  A cache in the context keeps every tile's intermediates
+     *  alive, so pass none to bound memory.
+     */
+    sk_sp<SkSpecialImage> filterImageInTiles(SkSpecialImage* src, const Context&, int tileSize,
+                                             SkIPoint* offset) const;
+
     enum MapDirection {
         kForward_MapDirection,
         kReverse_MapDirection
@@ -230,6 +261,13 @@ public:
      */
     bool canHandleComplexCTM() const;
 
+    /**
+     *  Returns true iff this filter and all of its (non-null) inputs produce the same pixels inside
+     *  any clip bounds as they would without them, so that filterImageInTiles() can piece the
+     *  output together tile by tile.
+     */
+    bool canFilterInTiles() const;
+
     /**
      * Return an imagefilter which transforms its input by the given matrix.
      */
@@ -342,6 +380,14 @@ protected:
                                       const Context&, 
                                       SkIPoint* offset) const;
 
+    // Calls filterInput() for each input, storing the images in results[] and their offsets
+    // (starting from zero) in offsets[], both countInputs() long.  With an executor in the
+    // context and a raster source, distinct inputs are filtered concurrently.
+    void filterInputs(SkSpecialImage* src,
+                      const Context&,
+                      sk_sp<SkSpecialImage> results[],
+                      SkIPoint offsets[]) const;
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
@@ -356,6 +402,14 @@ protected:
      */
     virtual bool onCanHandleComplexCTM() const { return false; }
 
+    /**
+     *  Override this to return true if, as a leaf node, this filter's output inside the clip
+     *  bounds only depends on the input within its onFilterNodeBounds(..., kReverse_MapDirection)
+     *  margins, and not on where the clip cuts its input.  The caller takes care of the inputs and
+     *  of partial crop rects, which follow the input's (clipped) bounds.
+     */
+    virtual bool onCanFilterInTiles() const { return false; }
+
     /** Given a "srcBounds" rect, computes destination bounds for this filter.
      *  "dstBounds" are computed by transforming the crop rect by the context's
      *  CTM, applying it to the initial bounds, and intersecting the result with
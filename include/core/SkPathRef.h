@@ -18,6 +18,7 @@
 #include "SkRefCnt.h"
 #include <stddef.h> // ptrdiff_t
 
+class SkPathAnalysis;
 class SkRBuffer;
 class SkWBuffer;
 
@@ -337,6 +338,8 @@ private:
         // The next two values don't matter unless fIsOval or fIsRRect are true.
         fRRectOrOvalIsCCW = false;
         fRRectOrOvalStartIdx = 0xAC;
+        fAnalysis = nullptr;
+        fConvexity = 0;
         SkDEBUGCODE(fEditorsAttached = 0;)
         SkDEBUGCODE(this->validate();)
     }
@@ -381,6 +384,7 @@ private:
         SkDEBUGCODE(this->validate();)
         fBoundsIsDirty = true;      // this also invalidates fIsFinite
         fGenerationID = 0;
+        this->resetAnalysis();
 
         fSegmentMask = 0;
         fIsOval = false;
@@ -509,6 +513,13 @@ private:
 
     void callGenIDChangeListeners();
 
+    /** Returns the SkPathAnalysis of the current points and verbs, creating it on first use. */
+    SkPathAnalysis* analysis() const;
+
+    /** Forgets the convexity and drops the SkPathAnalysis; called wherever the points or verbs
+     *  change. */
+    void resetAnalysis();
+
     enum {
         kMinSize = 256,
     };
@@ -530,6 +541,11 @@ private:
 
     SkTDArray<GenIDChangeListener*> fGenIDChangeListeners;  // pointers are owned
 
+    mutable SkAtomic<SkPathAnalysis*> fAnalysis;  // owned; null until first asked for
+    // The convexity and first direction a path sharing this ref worked out, packed by SkPathPriv
+    // so that they are read and written together. 0 until known.
+    mutable SkAtomic<uint8_t, sk_memory_order_relaxed> fConvexity;
+
     mutable uint8_t  fBoundsIsDirty;
     mutable SkBool8  fIsFinite;    // only meaningful if bounds are valid
 
@@ -541,6 +557,7 @@ private:
     uint8_t  fRRectOrOvalStartIdx;
     uint8_t  fSegmentMask;
 
+    friend class SkPathPriv;  // analysis(), fConvexity
     friend class PathRefTest_Private;
     friend class ForceIsRRect_Private; // unit test isRRect
 };
@@ -13,10 +13,12 @@
 #include "SkTypes.h"
 
 class GrContext;
+class SkBBHFactory;
 class SkBigPicture;
 class SkBitmap;
 class SkCanvas;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkImageDeserializer;
 class SkPath;
@@ -64,6 +66,25 @@ public:
                                          SkImageDeserializer* = nullptr);
     static sk_sp<SkPicture> MakeFromData(const SkData* data, SkImageDeserializer* = nullptr);
 
+    /**
+     *  As MakeFromData(), but the serialized images are decoded concurrently on executor.  The
+     *  image-deserializer, if not null, must be safe to call from several threads at once.
+     */
+    static sk_sp<SkPicture> MakeFromData(const SkData* data, SkImageDeserializer*, SkExecutor*);
+
+    /**
+     *  Like MakeFromData(), but only the header is read up front: the rest is parsed the first
+     *  time the picture is played back or inspected.  The picture keeps a ref on data and its
+     *  encoded images share data's bytes rather than copying them, so a file mapped with
+     *  SkData::MakeFromFileName() is only paged in as it is used.  Once parsed, the ops are
+     *  indexed by an R-tree, so playback into a clipped canvas (e.g. one tile) skips the ops
+     *  that fall outside the clip.
+     *
+     *  Returns nullptr if data does not start with a valid header.  If the rest turns out to be
+     *  invalid, the picture draws nothing.
+     */
+    static sk_sp<SkPicture> MakeLazyFromData(sk_sp<SkData> data);
+
     /**
      *  Recreate a picture that was serialized into a buffer. If the creation requires bitmap
      *  decoding, the decoder must be set on the SkReadBuffer parameter by calling
@@ -120,6 +141,13 @@ public:
      */
     void serialize(SkWStream*, SkPixelSerializer* = nullptr) const;
 
+    /**
+     *  As above, but the picture's paths and images are flattened concurrently on executor.
+     *  The output is identical.  The pixel-serializer, if not null, must be safe to call from
+     *  several threads at once.
+     */
+    void serialize(SkWStream*, SkPixelSerializer*, SkExecutor*) const;
+
     /**
      *  Serialize to a buffer.
      */
@@ -172,10 +200,13 @@ private:
     SkPicture();
     friend class SkBigPicture;
     friend class SkEmptyPicture;
+    friend class SkLazyPicture;
     template <typename> friend class SkMiniPicture;
 
-    void serialize(SkWStream*, SkPixelSerializer*, SkRefCntSet* typefaces) const;
-    static sk_sp<SkPicture> MakeFromStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*);
+    void serialize(SkWStream*, SkPixelSerializer*, SkRefCntSet* typefaces, SkExecutor*) const;
+    static sk_sp<SkPicture> MakeFromStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*,
+                                           const SkData* backingData = nullptr,
+                                           SkExecutor* = nullptr);
     friend class SkPictureData;
 
     virtual int numSlowPaths() const = 0;
@@ -223,7 +254,8 @@ private:
     static bool IsValidPictInfo(const SkPictInfo& info);
     static sk_sp<SkPicture> Forwardport(const SkPictInfo&,
                                         const SkPictureData*,
-                                        SkReadBuffer* buffer);
+                                        SkReadBuffer* buffer,
+                                        SkBBHFactory* bbhFactory = nullptr);
 
     SkPictInfo createHeader() const;
     SkPictureData* backport() const;
@@ -20,6 +20,7 @@
 
 class SkBitmap;
 class SkDeduper;
+class SkExecutor;
 class SkFactorySet;
 class SkFlattenable;
 class SkRefCntSet;
@@ -64,6 +65,22 @@ public:
     virtual void writeTypeface(SkTypeface* typeface) = 0;
     virtual void writePaint(const SkPaint& paint) = 0;
 
+    /**
+     *  Equivalent to calling writePath() or writeImage() on each element in turn.  If executor
+     *  is not null, subclasses may do the work concurrently on it, but must write exactly the
+     *  same bytes.
+     */
+    virtual void writePaths(const SkPath paths[], int count, SkExecutor*) {
+        for (int i = 0; i < count; ++i) {
+            this->writePath(paths[i]);
+        }
+    }
+    virtual void writeImages(const SkImage* const images[], int count, SkExecutor*) {
+        for (int i = 0; i < count; ++i) {
+            this->writeImage(images[i]);
+        }
+    }
+
     void setDeduper(SkDeduper* deduper) { fDeduper = deduper; }
 
 protected:
@@ -124,6 +141,11 @@ public:
     void writeTypeface(SkTypeface* typeface) override;
     void writePaint(const SkPaint& paint) override;
 
+    // Paths are sized up front and flattened in place, and images are encoded, in parallel.
+    // The pixel serializer, if any, must be safe to call from several threads at once.
+    void writePaths(const SkPath paths[], int count, SkExecutor*) override;
+    void writeImages(const SkImage* const images[], int count, SkExecutor*) override;
+
     bool writeToStream(SkWStream*);
     void writeToMemory(void* dst) { fWriter.flatten(dst); }
 
@@ -140,6 +162,9 @@ public:
     SkPixelSerializer* getPixelSerializer() const { return fPixelSerializer.get(); }
 
 private:
+    // Write an image given the result of image->encode(fPixelSerializer), which may be null.
+    void writeEncodedImage(const SkImage*, SkData* encoded);
+
     const uint32_t fFlags;
     SkFactorySet* fFactorySet;
     SkWriter32 fWriter;
@@ -150,6 +175,8 @@ private:
 
     // Only used if we do not have an fFactorySet
     SkTHashMap<SkString, uint32_t> fFlattenableDict;
+
+    typedef SkWriteBuffer INHERITED;
 };
 
 #endif // SkWriteBuffer_DEFINED
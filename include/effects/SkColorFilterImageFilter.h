@@ -27,6 +27,7 @@ protected:
                                         SkIPoint* offset) const override;
     bool onIsColorFilterNode(SkColorFilter**) const override;
     bool onCanHandleComplexCTM() const override { return true; }
+    bool onCanFilterInTiles() const override { return true; }
     bool affectsTransparentBlack() const override;
 
 private:
@@ -28,6 +28,7 @@ protected:
                                         SkIPoint* offset) const override;
     SkIRect onFilterBounds(const SkIRect&, const SkMatrix&, MapDirection) const override;
     bool onCanHandleComplexCTM() const override { return true; }
+    bool onCanFilterInTiles() const override { return true; }
 
 private:
     typedef SkImageFilter INHERITED;
@@ -49,11 +49,20 @@ protected:
     void flatten(SkWriteBuffer&) const override;
     const SkImageFilterLight* light() const { return fLight.get(); }
     SkScalar surfaceScale() const { return fSurfaceScale; }
+    bool lightsOnePixelAtATime() const { return fLightsOnePixelAtATime; }
     bool affectsTransparentBlack() const override { return true; }
 
 private:
+    friend class LightingImageFilterTester; // for unit testing
+
+    // Lights the interior one pixel at a time, as the edges are, rather than four at a time.
+    void setLightsOnePixelAtATime(bool onePixelAtATime) {
+        fLightsOnePixelAtATime = onePixelAtATime;
+    }
+
     sk_sp<SkImageFilterLight> fLight;
     SkScalar fSurfaceScale;
+    bool fLightsOnePixelAtATime = false;
 
     typedef SkImageFilter INHERITED;
 };
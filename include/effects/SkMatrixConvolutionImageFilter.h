@@ -83,6 +83,7 @@ protected:
                                         SkIPoint* offset) const override;
     SkIRect onFilterNodeBounds(const SkIRect&, const SkMatrix&, MapDirection) const override;
     bool affectsTransparentBlack() const override;
+    bool onCanFilterInTiles() const override;
 
 private:
     SkISize   fKernelSize;
@@ -92,6 +93,10 @@ private:
     SkIPoint  fKernelOffset;
     TileMode  fTileMode;
     bool      fConvolveAlpha;
+    // When fKernel is the product of a column and a row, and running them as two passes saves
+    // enough taps, the row's fKernelSize.width() factors followed by the column's
+    // fKernelSize.height() ones.  Otherwise null.
+    SkScalar* fSeparableKernel;
 
     template <class PixelFetcher, bool convolveAlpha>
     void filterPixels(const SkBitmap& src,
@@ -111,6 +116,15 @@ private:
                             SkBitmap* result,
                             const SkIRect& rect,
                             const SkIRect& bounds) const;
+    template <class PixelFetcher, bool convolveAlpha>
+    void filterPixelsSeparable(const SkBitmap& src,
+                               SkBitmap* result,
+                               const SkIRect& rect,
+                               const SkIRect& bounds) const;
+    void filterSeparablePixels(const SkBitmap& src,
+                               SkBitmap* result,
+                               const SkIRect& rect,
+                               const SkIRect& bounds) const;
 
     typedef SkImageFilter INHERITED;
 };
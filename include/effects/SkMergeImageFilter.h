@@ -28,6 +28,7 @@ protected:
     sk_sp<SkSpecialImage> onFilterImage(SkSpecialImage* source, const Context&,
                                         SkIPoint* offset) const override;
     bool onCanHandleComplexCTM() const override { return true; }
+    bool onCanFilterInTiles() const override { return true; }
 
 private:
     SkMergeImageFilter(sk_sp<SkImageFilter> filters[], int count, const SkBlendMode modes[],
@@ -43,6 +43,7 @@ protected:
                                         const Context&,
                                         SkIPoint* offset) const override;
     void flatten(SkWriteBuffer&) const override;
+    bool onCanFilterInTiles() const override { return true; }
 
     SkISize radius() const { return fRadius; }
 
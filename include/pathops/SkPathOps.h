@@ -10,7 +10,9 @@
 #include "../private/SkTArray.h"
 #include "../private/SkTDArray.h"
 #include "SkPreConfig.h"
+#include "SkScalar.h"
 
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -45,6 +47,41 @@ enum SkPathOp {
   */
 bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result);
 
+/** Choices that trade the exactness of Op() for speed.
+  */
+struct SK_API SkPathOpsOptions {
+    enum Precision {
+        kExact_Precision,        //!< find where curves meet exactly, keeping them curves
+        kApproximate_Precision,  //!< flatten curves to lines, within fTolerance
+    };
+
+    Precision fPrecision = kExact_Precision;
+
+    /** How far, in the units of the paths' coordinates, the approximate result may stray from
+        the exact one. Drawing or hit-testing in device space wants a fraction of a pixel.
+     */
+    SkScalar  fTolerance = 0.25f;
+};
+
+/** Set result to (one op two), as Op() above, to the precision in options.
+
+    For kApproximate_Precision, both paths are flattened to polygons with their points
+    snapped to a grid, and swept in a single pass. The result is made of lines only, with
+    every point within options.fTolerance of the exact result; it suits clips and hit regions,
+    but not paths that are edited or combined further. Paths too large for the grid, or a
+    tolerance that is not positive, use kExact_Precision.
+
+    @param one The first operand (for difference, the minuend)
+    @param two The second operand (for difference, the subtrahend)
+    @param op The operator to apply.
+    @param options How exact the result must be.
+    @param result The product of the operands. The result may be one of the
+                  inputs.
+    @return True if the operation succeeded.
+  */
+bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op,
+               const SkPathOpsOptions& options, SkPath* result);
+
 /** Set this path to a set of non-overlapping contours that describe the
     same area as the original path.
     The curve order is reduced where possible so that cubics may
@@ -60,6 +97,8 @@ bool SK_API Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
 bool SK_API Simplify(const SkPath& path, SkPath* result);
 
 /** Set the resulting rectangle to the tight bounds of the path.
+    The bounds are kept with the path's points and verbs, so asking again, for this path or
+    for a copy of it, does not compute them again.
 
     @param path The path measured.
     @param result The tight bounds of the path.
@@ -82,10 +121,15 @@ public:
     /** Computes the sum of all paths and operands, and resets the builder to its
         initial state.
  
+        When every operand is a union and an executor is supplied, the paths are split into
+        groups whose bounds never meet, and each group is unioned as a balanced tree of Op()
+        calls, on the executor's threads.  Other sequences of operands are folded in order.
+
         @param result The product of the operands.
+        @param executor If not null, runs the unions of many paths concurrently.
         @return True if the operation succeeded.
       */
-    bool resolve(SkPath* result);
+    bool resolve(SkPath* result, SkExecutor* executor = nullptr);
 
 private:
     SkTArray<SkPath> fPathRefs;
@@ -93,6 +137,7 @@ private:
 
     static bool FixWinding(SkPath* path);
     static void ReversePath(SkPath* path);
+    bool resolveUnions(SkPath* result, SkExecutor* executor);
     void reset();
 };
 
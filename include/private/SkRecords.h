@@ -77,6 +77,7 @@ namespace SkRecords {
     M(DrawTextRSXform)                                              \
     M(DrawRRect)                                                    \
     M(DrawRect)                                                     \
+    M(DrawRects)                                                    \
     M(DrawRegion)                                                   \
     M(DrawTextBlob)                                                 \
     M(DrawAtlas)                                                    \
@@ -303,6 +304,12 @@ RECORD(DrawRRect, kDraw_Tag|kHasPaint_Tag,
 RECORD(DrawRect, kDraw_Tag|kHasPaint_Tag,
         SkPaint paint;
         SkRect rect);
+// Never recorded directly: SkRecordCoalesceDrawRects() makes these from runs of DrawRect.
+RECORD(DrawRects, kDraw_Tag|kHasPaint_Tag,
+        SkPaint paint;
+        SkRect bounds;              // Union of the sorted rects.
+        int count;
+        PODArray<SkRect> rects);
 RECORD(DrawRegion, kDraw_Tag|kHasPaint_Tag,
         SkPaint paint;
         SkRegion region);
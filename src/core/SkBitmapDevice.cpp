@@ -9,6 +9,7 @@
 #include "SkDraw.h"
 #include "SkImageFilter.h"
 #include "SkImageFilterCache.h"
+#include "SkImageFilterContentCache.h"
 #include "SkMallocPixelRef.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
@@ -401,7 +402,8 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* srcImg, int x, int y,
         SkImageFilter::OutputProperties outputProperties(fBitmap.colorSpace());
         SkImageFilter::Context ctx(matrix, clipBounds, cache.get(), outputProperties);
 
-        sk_sp<SkSpecialImage> resultImg(filter->filterImage(srcImg, ctx, &offset));
+        sk_sp<SkSpecialImage> resultImg(
+                SkImageFilterContentCache::FilterImage(filter, srcImg, ctx, &offset));
         if (resultImg) {
             SkPaint tmpUnfiltered(paint);
             tmpUnfiltered.setImageFilter(nullptr);
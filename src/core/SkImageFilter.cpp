@@ -17,6 +17,7 @@
 #include "SkRect.h"
 #include "SkSpecialImage.h"
 #include "SkSpecialSurface.h"
+#include "SkTaskGroup.h"
 #include "SkValidationUtils.h"
 #include "SkWriteBuffer.h"
 #if SK_SUPPORT_GPU
@@ -205,7 +206,8 @@ sk_sp<SkSpecialImage> SkImageFilter::filterImage(SkSpecialImage* src, const Cont
 
     uint32_t srcGenID = fUsesSrcInput ? src->uniqueID() : 0;
     const SkIRect srcSubset = fUsesSrcInput ? src->subset() : SkIRect::MakeWH(0, 0);
-    SkImageFilterCacheKey key(fUniqueID, context.ctm(), context.clipBounds(), srcGenID, srcSubset);
+    SkImageFilterCacheKey key(fUniqueID, context.ctm(), context.clipBounds(),
+                              context.fullClipBounds(), srcGenID, srcSubset);
     if (context.cache()) {
         sk_sp<SkSpecialImage> result = context.cache()->get(key, offset);
         if (result) {
@@ -233,6 +235,62 @@ sk_sp<SkSpecialImage> SkImageFilter::filterImage(SkSpecialImage* src, const Cont
     return result;
 }
 
+sk_sp<SkSpecialImage> SkImageFilter::filterImageInTiles(SkSpecialImage* src, const Context& ctx,
+                                                        int tileSize, SkIPoint* offset) const {
+    SkASSERT(src && offset);
+
+    if (tileSize <= 0 || src->isTextureBacked() || !this->canFilterInTiles()) {
+        return this->filterImage(src, ctx, offset);
+    }
+
+    // Only visit the tiles the DAG can actually draw to.
+    SkIRect dstBounds = this->filterBounds(SkIRect::MakeWH(src->width(), src->height()),
+                                           ctx.ctm(), kForward_MapDirection);
+    if (!dstBounds.intersect(ctx.clipBounds())) {
+        return nullptr;
+    }
+    if (dstBounds.width() <= tileSize && dstBounds.height() <= tileSize) {
+        return this->filterImage(src, ctx, offset);
+    }
+
+    sk_sp<SkSpecialSurface> surf(src->makeSurface(ctx.outputProperties(), dstBounds.size()));
+    if (!surf) {
+        return nullptr;
+    }
+
+    SkCanvas* canvas = surf->getCanvas();
+    SkASSERT(canvas);
+    canvas->clear(0x0);
+    canvas->translate(SkIntToScalar(-dstBounds.x()), SkIntToScalar(-dstBounds.y()));
+
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    for (int y = dstBounds.top(); y < dstBounds.bottom(); y += tileSize) {
+        for (int x = dstBounds.left(); x < dstBounds.right(); x += tileSize) {
+            SkIRect tile = SkIRect::MakeXYWH(x, y, tileSize, tileSize);
+            SkAssertResult(tile.intersect(dstBounds));
+
+            Context tileCtx(ctx.ctm(), tile, ctx.cache(), ctx.outputProperties(), ctx.executor(),
+                            &ctx.clipBounds());
+            SkIPoint tileOffset = SkIPoint::Make(0, 0);
+            sk_sp<SkSpecialImage> result(this->filterImage(src, tileCtx, &tileOffset));
+            if (!result) {
+                continue;   // transparent black
+            }
+
+            // Some filters return a margin beyond the clip; each tile only owns its own pixels.
+            canvas->save();
+            canvas->clipRect(SkRect::Make(tile));
+            result->draw(canvas, SkIntToScalar(tileOffset.x()), SkIntToScalar(tileOffset.y()),
+                         &paint);
+            canvas->restore();
+        }
+    }
+
+    *offset = SkIPoint::Make(dstBounds.x(), dstBounds.y());
+    return surf->makeImageSnapshot();
+}
+
 SkIRect SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
                                  MapDirection direction) const {
     if (kReverse_MapDirection == direction) {
@@ -334,6 +392,24 @@ bool SkImageFilter::canHandleComplexCTM() const {
     return true;
 }
 
+bool SkImageFilter::canFilterInTiles() const {
+    // A partial crop rect takes its missing edges from the input's bounds, which each tile clips.
+    if (this->cropRectIsSet() && CropRect::kHasAll_CropEdge != fCropRect.flags()) {
+        return false;
+    }
+    if (!this->onCanFilterInTiles()) {
+        return false;
+    }
+    const int count = this->countInputs();
+    for (int i = 0; i < count; ++i) {
+        SkImageFilter* input = this->getInput(i);
+        if (input && !input->canFilterInTiles()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool SkImageFilter::applyCropRect(const Context& ctx, const SkIRect& srcBounds,
                                   SkIRect* dstBounds) const {
     SkIRect temp = this->onFilterNodeBounds(srcBounds, ctx.ctm(), kForward_MapDirection);
@@ -466,7 +542,10 @@ SkIRect SkImageFilter::onFilterNodeBounds(const SkIRect& src, const SkMatrix&, M
 SkImageFilter::Context SkImageFilter::mapContext(const Context& ctx) const {
     SkIRect clipBounds = this->onFilterNodeBounds(ctx.clipBounds(), ctx.ctm(),
                                                   MapDirection::kReverse_MapDirection);
-    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties());
+    SkIRect fullClipBounds = this->onFilterNodeBounds(ctx.fullClipBounds(), ctx.ctm(),
+                                                      MapDirection::kReverse_MapDirection);
+    return Context(ctx.ctm(), clipBounds, ctx.cache(), ctx.outputProperties(), ctx.executor(),
+                   &fullClipBounds);
 }
 
 sk_sp<SkImageFilter> SkImageFilter::MakeMatrixFilter(const SkMatrix& matrix,
@@ -499,6 +578,50 @@ sk_sp<SkSpecialImage> SkImageFilter::filterInput(int index,
     return result;
 }
 
+void SkImageFilter::filterInputs(SkSpecialImage* src,
+                                 const Context& ctx,
+                                 sk_sp<SkSpecialImage> results[],
+                                 SkIPoint offsets[]) const {
+    const int count = this->countInputs();
+    for (int i = 0; i < count; ++i) {
+        offsets[i].setZero();
+    }
+
+    if (!ctx.executor() || count < 2 || src->isTextureBacked()) {
+        for (int i = 0; i < count; ++i) {
+            results[i] = this->filterInput(i, src, ctx, &offsets[i]);
+        }
+        return;
+    }
+
+    // DAGs often feed one node to several inputs; filter each distinct node only once.
+    SkSTArray<8, int> distinct;
+    SkAutoSTArray<8, int> firstUse(count);
+    for (int i = 0; i < count; ++i) {
+        firstUse[i] = i;
+        for (int j : distinct) {
+            if (this->getInput(j) == this->getInput(i)) {
+                firstUse[i] = j;
+                break;
+            }
+        }
+        if (firstUse[i] == i) {
+            distinct.push_back(i);
+        }
+    }
+
+    SkTaskGroup(*ctx.executor()).batch(distinct.count(), [&](int k) {
+        int i = distinct[k];
+        results[i] = this->filterInput(i, src, ctx, &offsets[i]);
+    });
+    for (int i = 0; i < count; ++i) {
+        if (firstUse[i] != i) {
+            results[i] = results[firstUse[i]];
+            offsets[i] = offsets[firstUse[i]];
+        }
+    }
+}
+
 void SkImageFilter::PurgeCache() {
     SkImageFilterCache::Get()->purge();
 }
@@ -17,14 +17,22 @@ class SkSpecialImage;
 struct SkImageFilterCacheKey {
     SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
         const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset)
+        : SkImageFilterCacheKey(uniqueID, matrix, clipBounds, clipBounds, srcGenID, srcSubset) {}
+
+    // fullClipBounds tells a tile of filterImageInTiles() apart from the same clip on its own.
+    SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
+        const SkIRect& clipBounds, const SkIRect& fullClipBounds, uint32_t srcGenID,
+        const SkIRect& srcSubset)
         : fUniqueID(uniqueID)
         , fMatrix(matrix)
         , fClipBounds(clipBounds)
+        , fFullClipBounds(fullClipBounds)
         , fSrcGenID(srcGenID)
         , fSrcSubset(srcSubset) {
         // Assert that Key is tightly-packed, since it is hashed.
         static_assert(sizeof(SkImageFilterCacheKey) == sizeof(uint32_t) + sizeof(SkMatrix) +
-                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t),
+                                     2 * sizeof(SkIRect) + sizeof(uint32_t) +
+                                     4 * sizeof(int32_t),
                                      "image_filter_key_tight_packing");
         fMatrix.getType();  // force initialization of type, so hashes match
     }
@@ -32,6 +40,7 @@ struct SkImageFilterCacheKey {
     uint32_t fUniqueID;
     SkMatrix fMatrix;
     SkIRect fClipBounds;
+    SkIRect fFullClipBounds;
     uint32_t fSrcGenID;
     SkIRect fSrcSubset;
 
@@ -39,6 +48,7 @@ struct SkImageFilterCacheKey {
         return fUniqueID == other.fUniqueID &&
                fMatrix == other.fMatrix &&
                fClipBounds == other.fClipBounds &&
+               fFullClipBounds == other.fFullClipBounds &&
                fSrcGenID == other.fSrcGenID &&
                fSrcSubset == other.fSrcSubset;
     }
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkImageFilterContentCache.h"
+
+#include "SkBitmap.h"
+#include "SkColorSpace.h"
+#include "SkData.h"
+#include "SkDeduper.h"
+#include "SkGraphics.h"
+#include "SkImage.h"
+#include "SkOpts.h"
+#include "SkPicture.h"
+#include "SkResourceCache.h"
+#include "SkSpecialImage.h"
+#include "SkTDArray.h"
+#include "SkTypeface.h"
+#include "SkWriteBuffer.h"
+
+#include <atomic>
+
+static std::atomic<bool>     gEnabled{false};
+static std::atomic<uint64_t> gHits{0};
+static std::atomic<uint64_t> gMisses{0};
+
+namespace {
+static unsigned gContentKeyNamespaceLabel;
+
+// Writes what a filter DAG only references by identity, rather than its content: images and
+// typefaces as their unique IDs, and factories as indices into factories(), in the order they
+// were first seen.  SkPictureImageFilter flattens its picture op by op, so a re-recorded picture
+// still matches.
+class FingerprintDeduper : public SkDeduper {
+public:
+    int findOrDefineImage(SkImage* image) override { return image->uniqueID(); }
+    int findOrDefinePicture(SkPicture* picture) override { return picture->uniqueID(); }
+    int findOrDefineTypeface(SkTypeface* typeface) override {
+        return typeface ? typeface->uniqueID() : 0;
+    }
+    int findOrDefineFactory(SkFlattenable* flattenable) override {
+        if (!flattenable) {
+            return 0;
+        }
+        SkFlattenable::Factory factory = flattenable->getFactory();
+        int index = fFactories.find(factory);
+        if (index < 0) {
+            index = fFactories.count();
+            *fFactories.append() = factory;
+        }
+        return index + 1;
+    }
+
+    const SkTDArray<SkFlattenable::Factory>& factories() const { return fFactories; }
+
+private:
+    SkTDArray<SkFlattenable::Factory> fFactories;
+};
+
+static sk_sp<SkData> flatten_filter(const SkImageFilter* filter) {
+    FingerprintDeduper deduper;
+    SkBinaryWriteBuffer buffer;
+    buffer.setDeduper(&deduper);
+    buffer.writeFlattenable(filter);
+    // The factories' addresses, whole, are unique in-process; the indices only mean them.
+    buffer.write(deduper.factories().begin(), deduper.factories().bytes());
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(buffer.bytesWritten());
+    buffer.writeToMemory(data->writable_data());
+    return data;
+}
+
+// Two independent 32-bit hashes of the pixels src covers, so that a collision takes 64 bits.
+static bool hash_pixels(SkSpecialImage* src, uint32_t hash[2]) {
+    SkBitmap bitmap;
+    if (!src->getROPixels(&bitmap)) {
+        return false;
+    }
+    SkAutoLockPixels alp(bitmap);
+    if (!bitmap.getPixels()) {
+        return false;
+    }
+
+    const SkIRect& subset = src->subset();
+    const size_t rowBytes = subset.width() * bitmap.bytesPerPixel();
+    hash[0] = 0;
+    hash[1] = 0x9E3779B9;
+    for (int y = subset.top(); y < subset.bottom(); ++y) {
+        const void* row = bitmap.getAddr(subset.left(), y);
+        hash[0] = SkOpts::hash(row, rowBytes, hash[0]);
+        hash[1] = SkOpts::hash(row, rowBytes, hash[1]);
+    }
+    return true;
+}
+
+static uint32_t hash_color_space(SkColorSpace* colorSpace) {
+    if (!colorSpace) {
+        return 0;
+    }
+    sk_sp<SkData> data = colorSpace->serialize();
+    return data ? SkOpts::hash(data->data(), data->size()) : 0;
+}
+
+struct ContentKey : public SkResourceCache::Key {
+public:
+    ContentKey(const SkData* filterBytes, const uint32_t srcHash[2], const SkSpecialImage* src,
+               const SkImageFilter::Context& ctx)
+        : fFilterHash(SkOpts::hash(filterBytes->data(), filterBytes->size()))
+        , fFilterSize(SkToU32(filterBytes->size()))
+        , fSrcHash{ srcHash[0], srcHash[1] }
+        , fMatrix(ctx.ctm())
+        , fClipBounds(ctx.clipBounds())
+        , fSrcWidth(src->width())
+        , fSrcHeight(src->height())
+        , fSrcColorSpaceHash(hash_color_space(src->getColorSpace()))
+        , fDstColorSpaceHash(hash_color_space(ctx.outputProperties().colorSpace())) {
+        static_assert(sizeof(ContentKey) == sizeof(SkResourceCache::Key) + kFieldBytes,
+                      "content_key_tight_packing");
+        fMatrix.getType();  // force initialization of type, so hashes match
+        this->init(&gContentKeyNamespaceLabel, 0, kFieldBytes);
+    }
+
+    static const size_t kFieldBytes = 4 * sizeof(uint32_t) + sizeof(SkMatrix) + sizeof(SkIRect) +
+                                      2 * sizeof(int32_t) + 2 * sizeof(uint32_t);
+
+    uint32_t fFilterHash;
+    uint32_t fFilterSize;
+    uint32_t fSrcHash[2];
+    SkMatrix fMatrix;
+    SkIRect  fClipBounds;
+    int32_t  fSrcWidth;
+    int32_t  fSrcHeight;
+    uint32_t fSrcColorSpaceHash;
+    uint32_t fDstColorSpaceHash;
+};
+
+struct ContentRec : public SkResourceCache::Rec {
+    ContentRec(const ContentKey& key, sk_sp<SkData> filterBytes, SkSpecialImage* image,
+               const SkIPoint& offset)
+        : fKey(key)
+        , fFilterBytes(std::move(filterBytes))
+        , fImage(SkRef(image))
+        , fOffset(offset) {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(fKey) + fFilterBytes->size() + fImage->getSize();
+    }
+    const char* getCategory() const override { return "image-filter"; }
+
+    struct Result {
+        const SkData*         fFilterBytes;
+        sk_sp<SkSpecialImage> fImage;
+        SkIPoint              fOffset;
+    };
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* context) {
+        const ContentRec& rec = static_cast<const ContentRec&>(baseRec);
+        Result* result = (Result*)context;
+
+        // The key only has a hash of the filter; a different DAG that collides with it evicts it.
+        if (!rec.fFilterBytes->equals(result->fFilterBytes)) {
+            return false;
+        }
+        result->fImage = rec.fImage;
+        result->fOffset = rec.fOffset;
+        return true;
+    }
+
+private:
+    ContentKey            fKey;
+    sk_sp<SkData>         fFilterBytes;
+    sk_sp<SkSpecialImage> fImage;
+    SkIPoint              fOffset;
+};
+} // namespace
+
+sk_sp<SkSpecialImage> SkImageFilterContentCache::FilterImage(const SkImageFilter* filter,
+                                                             SkSpecialImage* src,
+                                                             const SkImageFilter::Context& ctx,
+                                                             SkIPoint* offset) {
+    SkASSERT(filter && src && offset);
+
+    if (!gEnabled.load(std::memory_order_relaxed) || src->isTextureBacked()) {
+        return filter->filterImage(src, ctx, offset);
+    }
+
+    sk_sp<SkData> filterBytes = flatten_filter(filter);
+    uint32_t srcHash[2];
+    if (!hash_pixels(src, srcHash)) {
+        return filter->filterImage(src, ctx, offset);
+    }
+
+    ContentKey key(filterBytes.get(), srcHash, src, ctx);
+    ContentRec::Result found = { filterBytes.get(), nullptr, SkIPoint::Make(0, 0) };
+    if (SkResourceCache::Find(key, ContentRec::Finder, &found)) {
+        gHits.fetch_add(1, std::memory_order_relaxed);
+        *offset = found.fOffset;
+        return std::move(found.fImage);
+    }
+    gMisses.fetch_add(1, std::memory_order_relaxed);
+
+    sk_sp<SkSpecialImage> result = filter->filterImage(src, ctx, offset);
+    if (result) {
+        SkResourceCache::Add(new ContentRec(key, std::move(filterBytes), result.get(), *offset));
+    }
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkGraphics::GetImageFilterContentCacheEnabled() {
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+void SkGraphics::SetImageFilterContentCacheEnabled(bool enabled) {
+    gEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SkGraphics::GetImageFilterContentCacheStats(uint64_t* hits, uint64_t* misses) {
+    if (hits) {
+        *hits = gHits.load(std::memory_order_relaxed);
+    }
+    if (misses) {
+        *misses = gMisses.load(std::memory_order_relaxed);
+    }
+}
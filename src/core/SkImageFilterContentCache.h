@@ -0,0 +1,36 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageFilterContentCache_DEFINED
+#define SkImageFilterContentCache_DEFINED
+
+#include "SkImageFilter.h"
+
+class SkSpecialImage;
+
+/**
+ *  Caches the results of whole image filter DAGs by what they were computed from, in the global
+ *  SkResourceCache (sharing its budget and LRU purging).
+ *
+ *  SkImageFilterCache keys results by the unique IDs of the filter and of its source, so nothing
+ *  carries over when a frame re-records a layer with the same content: both are new objects.
+ *  These keys are the DAG's flattened form and a hash of the source's pixels instead.
+ *
+ *  Off unless enabled with SkGraphics::SetImageFilterContentCacheEnabled().
+ */
+class SkImageFilterContentCache {
+public:
+    /**
+     *  Filters src like filter->filterImage(), unless an earlier call with the same filter
+     *  content, source pixels, matrix, clip and color spaces left its result in the cache.
+     *  When the cache is disabled, or src is texture-backed, this is just filterImage().
+     */
+    static sk_sp<SkSpecialImage> FilterImage(const SkImageFilter* filter, SkSpecialImage* src,
+                                             const SkImageFilter::Context&, SkIPoint* offset);
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageFilterPriv_DEFINED
+#define SkImageFilterPriv_DEFINED
+
+#include "SkImageFilter.h"
+#include "SkTaskGroup.h"
+
+/**
+ *  Calls fn(top, bottom) for horizontal bands of rows that together cover exactly
+ *  [bounds.top(), bounds.bottom()).  When the context has an executor and bounds is large enough
+ *  to be worth it, the bands run concurrently, so fn may only write the rows it is handed.
+ *  Per-pixel raster filters whose output rows are independent use this to spread their work.
+ */
+template <typename Fn>
+void SkImageFilterForEachBand(const SkImageFilter::Context& ctx, const SkIRect& bounds, Fn&& fn) {
+    static const int kMinRowsPerBand   = 16;
+    static const int kMinPixelsPerBand = 16 * 1024;
+    static const int kMaxBands         = 64;
+
+    int bands = 1;
+    if (ctx.executor() && !bounds.isEmpty()) {
+        const int64_t pixels = (int64_t)bounds.width() * bounds.height();
+        bands = (int)SkTMin<int64_t>(SkTMin(bounds.height() / kMinRowsPerBand, kMaxBands),
+                                     pixels / kMinPixelsPerBand);
+    }
+    if (bands <= 1) {
+        fn(bounds.top(), bounds.bottom());
+        return;
+    }
+
+    const int rows = bounds.height();
+    SkTaskGroup(*ctx.executor()).batch(bands, [&](int i) {
+        fn(bounds.top() + rows *  i      / bands,
+           bounds.top() + rows * (i + 1) / bands);
+    });
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkImageDeserializer.h"
+#include "SkLazyPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkStream.h"
+
+sk_sp<SkPicture> SkLazyPicture::Make(sk_sp<SkData> data) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data);
+    SkPictInfo info;
+    if (!InternalOnly_StreamIsSKP(&stream, &info) || !stream.readBool()) {
+        return nullptr;
+    }
+    return sk_sp<SkPicture>(new SkLazyPicture(info, std::move(data), stream.getPosition()));
+}
+
+SkLazyPicture::SkLazyPicture(const SkPictInfo& info, sk_sp<SkData> data, size_t offset)
+    : fInfo(info)
+    , fOffset(offset)
+    , fData(std::move(data)) {}
+
+const SkPicture* SkLazyPicture::picture() const {
+    fOnce([this] {
+        SkMemoryStream stream(fData);
+        SkAssertResult(stream.seek(fOffset));
+
+        // Parse in place: op data and encoded images become subsets of fData.
+        SkImageDeserializer factory;
+        std::unique_ptr<SkPictureData> data(
+                SkPictureData::CreateFromStream(&stream, fInfo, &factory, nullptr, fData.get()));
+
+        SkRTreeFactory rtreeFactory;
+        fPicture = Forwardport(fInfo, data.get(), nullptr, &rtreeFactory);
+        if (!fPicture) {
+            SkPictureRecorder recorder;
+            recorder.beginRecording(fInfo.fCullRect);
+            fPicture = recorder.finishRecordingAsPicture();
+        }
+
+        // Whatever still needs the bytes (e.g. not-yet-decoded images) holds its own ref.
+        fData = nullptr;
+    });
+    return fPicture.get();
+}
+
+void SkLazyPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    this->picture()->playback(canvas, callback);
+}
+
+bool SkLazyPicture::willPlayBackBitmaps() const {
+    return this->picture()->willPlayBackBitmaps();
+}
+
+int SkLazyPicture::approximateOpCount() const {
+    return this->picture()->approximateOpCount();
+}
+
+size_t SkLazyPicture::approximateBytesUsed() const {
+    return sizeof(*this) + this->picture()->approximateBytesUsed();
+}
+
+const SkBigPicture* SkLazyPicture::asSkBigPicture() const {
+    return this->picture()->asSkBigPicture();
+}
+
+int SkLazyPicture::numSlowPaths() const {
+    return this->picture()->numSlowPaths();
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkLazyPicture_DEFINED
+#define SkLazyPicture_DEFINED
+
+#include "SkData.h"
+#include "SkOnce.h"
+#include "SkPicture.h"
+#include "SkPictureData.h"
+
+// An SkPicture that holds serialized SKP bytes and only parses them the first time it is
+// played back or inspected.  See SkPicture::MakeLazyFromData().
+class SkLazyPicture final : public SkPicture {
+public:
+    // Returns nullptr if data does not start with a valid SKP header.
+    static sk_sp<SkPicture> Make(sk_sp<SkData> data);
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override { return fInfo.fCullRect; }
+    bool willPlayBackBitmaps() const override;
+    int approximateOpCount() const override;
+    size_t approximateBytesUsed() const override;
+    const SkBigPicture* asSkBigPicture() const override;
+
+private:
+    SkLazyPicture(const SkPictInfo&, sk_sp<SkData>, size_t offset);
+
+    int numSlowPaths() const override;
+
+    // Parses fData into fPicture, the first time it is called.
+    const SkPicture* picture() const;
+
+    const SkPictInfo         fInfo;
+    const size_t             fOffset;   // Where the picture data starts within fData.
+    mutable sk_sp<SkData>    fData;     // Released once parsed.
+    mutable SkOnce           fOnce;
+    mutable sk_sp<SkPicture> fPicture;
+};
+
+#endif//SkLazyPicture_DEFINED
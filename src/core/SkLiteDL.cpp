@@ -502,14 +502,91 @@ namespace {
     };
 }
 
+namespace {
+    // When rewind()ing, same(op, args...) says whether op would be constructed exactly as it is
+    // from args, so we can keep it rather than destroy it and copy its paint, path, etc. again.
+    // Trailing pod data isn't compared; callers always rewrite it.  Ops not listed here are
+    // always rebuilt, which is cheap for the trivially destructible ones.
+    template <typename T, typename... Args>
+    bool same(const T&, const Args&...) { return false; }
+
+    bool same(const ClipPath& op, const SkPath& path, SkClipOp clipOp, bool aa) {
+        return op.op == clipOp && op.aa == aa
+            && op.path.getGenerationID() == path.getGenerationID()
+            && op.path.getFillType()     == path.getFillType();
+    }
+    bool same(const DrawPaint& op, const SkPaint& paint) { return op.paint == paint; }
+    bool same(const DrawPath& op, const SkPath& path, const SkPaint& paint) {
+        return op.path.getGenerationID() == path.getGenerationID()
+            && op.path.getFillType()     == path.getFillType()
+            && op.paint == paint;
+    }
+    bool same(const DrawRect& op, const SkRect& rect, const SkPaint& paint) {
+        return op.rect == rect && op.paint == paint;
+    }
+    bool same(const DrawOval& op, const SkRect& oval, const SkPaint& paint) {
+        return op.oval == oval && op.paint == paint;
+    }
+    bool same(const DrawRRect& op, const SkRRect& rrect, const SkPaint& paint) {
+        return op.rrect == rrect && op.paint == paint;
+    }
+    bool same(const DrawDRRect& op, const SkRRect& outer, const SkRRect& inner,
+              const SkPaint& paint) {
+        return op.outer == outer && op.inner == inner && op.paint == paint;
+    }
+    bool same(const DrawImage& op, const sk_sp<const SkImage>& image, SkScalar x, SkScalar y,
+              const SkPaint* paint) {
+        return op.image == image && op.x == x && op.y == y
+            && op.paint == (paint ? *paint : SkPaint());
+    }
+    bool same(const DrawImageRect& op, const sk_sp<const SkImage>& image, const SkRect* src,
+              const SkRect& dst, const SkPaint* paint, SkCanvas::SrcRectConstraint constraint) {
+        return op.image == image && op.dst == dst && op.constraint == constraint
+            && op.src == (src ? *src : SkRect::MakeIWH(image->width(), image->height()))
+            && op.paint == (paint ? *paint : SkPaint());
+    }
+    bool same(const DrawText& op, size_t bytes, SkScalar x, SkScalar y, const SkPaint& paint) {
+        return op.bytes == bytes && op.x == x && op.y == y && op.paint == paint;
+    }
+    bool same(const DrawPosText& op, size_t bytes, const SkPaint& paint, int n) {
+        return op.bytes == bytes && op.n == n && op.paint == paint;
+    }
+    bool same(const DrawPosTextH& op, size_t bytes, SkScalar y, const SkPaint& paint, int n) {
+        return op.bytes == bytes && op.y == y && op.n == n && op.paint == paint;
+    }
+    bool same(const DrawTextBlob& op, const SkTextBlob* blob, SkScalar x, SkScalar y,
+              const SkPaint& paint) {
+        return op.blob.get() == blob && op.x == x && op.y == y && op.paint == paint;
+    }
+}
+
 template <typename T, typename... Args>
 void* SkLiteDL::push(size_t pod, Args&&... args) {
     size_t skip = SkAlignPtr(sizeof(T) + pod);
     SkASSERT(skip < (1<<24));
+    if (fUsed < fReusable) {
+        // We're rewriting the ops of the last frame.  While they line up, recycle them in place.
+        auto old = (Op*)(fBytes.get() + fUsed);
+        if (old->type == (uint32_t)T::kType && old->skip == skip) {
+            auto op = (T*)old;
+            fUsed += skip;
+            if (!same(*op, args...)) {
+                op->~T();
+                new (op) T{ std::forward<Args>(args)... };
+                op->type = (uint32_t)T::kType;
+                op->skip = skip;
+            }
+            return op+1;
+        }
+        // They don't line up any more.  Give up on the rest of the last frame.
+        this->destroyReusable();
+    }
     if (fUsed + skip > fReserved) {
         static_assert(SkIsPow2(SKLITEDL_PAGE), "This math needs updating for non-pow2.");
-        // Next greater multiple of SKLITEDL_PAGE.
-        fReserved = (fUsed + skip + SKLITEDL_PAGE) & ~(SKLITEDL_PAGE-1);
+        // Grow by at least half again, to the next greater multiple of SKLITEDL_PAGE,
+        // so that recording a large display list doesn't realloc once per page.
+        fReserved = (SkTMax(fUsed + skip, fReserved + fReserved/2) + SKLITEDL_PAGE)
+                  & ~(SKLITEDL_PAGE-1);
         fBytes.realloc(fReserved);
     }
     SkASSERT(fUsed + skip <= fReserved);
@@ -721,8 +798,29 @@ SkLiteDL::~SkLiteDL() {
 }
 
 void SkLiteDL::reset() {
+    this->destroyReusable();
     this->map(dtor_fns);
 
     // Leave fBytes and fReserved alone.
     fUsed   = 0;
 }
+
+void SkLiteDL::rewind() {
+    this->destroyReusable();
+
+    // Keep this frame's ops alive for the next one to recycle.
+    fReusable = fUsed;
+    fUsed     = 0;
+}
+
+void SkLiteDL::destroyReusable() {
+    auto end = fBytes.get() + fReusable;
+    for (uint8_t* ptr = fBytes.get() + fUsed; ptr < end; ) {
+        auto op = (Op*)ptr;
+        if (auto fn = dtor_fns[op->type]) {
+            fn(op);
+        }
+        ptr += op->skip;
+    }
+    fReusable = fUsed;
+}
@@ -21,7 +21,14 @@ public:
 
     void draw(SkCanvas* canvas);
 
+    // Destroys all ops, but keeps the storage they used for the next frame.
     void reset();
+
+    // Like reset(), but also keeps this frame's ops around until the next frame is recorded.
+    // While the next frame records the same kinds of ops in the same order, they're recycled in
+    // place, and those whose geometry, paint, path, etc. are unchanged aren't copied at all.
+    void rewind();
+
     bool empty() const { return fUsed == 0; }
 
 #ifdef SK_SUPPORT_LEGACY_DRAWFILTER
@@ -85,8 +92,12 @@ private:
     template <typename Fn, typename... Args>
     void map(const Fn[], Args...);
 
+    // Destroys any ops from the last frame that weren't recycled, i.e. those in [fUsed, fReusable).
+    void destroyReusable();
+
     SkAutoTMalloc<uint8_t> fBytes;
     size_t                 fUsed = 0;
+    size_t                 fReusable = 0;
     size_t                 fReserved = 0;
 };
 
@@ -28,6 +28,7 @@
 #include "SkShader.h"
 #include "SkStringUtils.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkStrokeRec.h"
 #include "SkSurfacePriv.h"
 #include "SkTextBlob.h"
@@ -1970,6 +1971,17 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
         srcPtr = &tmpPath;
     }
 
+    // A path effect makes a new path each time, so only strokes of src itself are kept. They are
+    // looked up by src's genID, which is gone once an outline is written over src.
+    bool useStrokeCache = srcPtr == &src && dst != &src && rec.needToApply() &&
+                          SkStrokeCache::ShouldCache(src);
+#ifdef SK_DEBUG
+    useStrokeCache &= !gDebugStrokerErrorSet;  // which overrides rec's resScale
+#endif
+    if (useStrokeCache && SkStrokeCache::Find(src, rec, dst)) {
+        return true;
+    }
+
     if (!rec.applyToPath(dst, *srcPtr)) {
         if (srcPtr == &tmpPath) {
             // If path's were copy-on-write, this trick would not be needed.
@@ -1980,6 +1992,8 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
         } else {
             *dst = *srcPtr;
         }
+    } else if (useStrokeCache) {
+        SkStrokeCache::Add(src, rec, *dst);
     }
     return !rec.isHairlineStyle();
 }
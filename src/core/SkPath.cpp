@@ -10,6 +10,7 @@
 #include "SkCubicClipper.h"
 #include "SkGeometry.h"
 #include "SkMath.h"
+#include "SkPathAnalysis.h"
 #include "SkPathPriv.h"
 #include "SkPathRef.h"
 #include "SkRRect.h"
@@ -2437,51 +2438,46 @@ private:
     bool                fIsCurve;
 };
 
-SkPath::Convexity SkPath::internalGetConvexity() const {
-    SkASSERT(kUnknown_Convexity == fConvexity);
+static SkPath::Convexity compute_convexity(const SkPath& path,
+                                           SkPathPriv::FirstDirection* firstDirection) {
     SkPoint         pts[4];
     SkPath::Verb    verb;
-    SkPath::Iter    iter(*this, true);
+    SkPath::Iter    iter(path, true);
 
     int             contourCount = 0;
     int             count;
     Convexicator    state;
 
-    if (!isFinite()) {
-        return kUnknown_Convexity;
-    }
     while ((verb = iter.next(pts, true, true)) != SkPath::kDone_Verb) {
         switch (verb) {
-            case kMove_Verb:
+            case SkPath::kMove_Verb:
                 if (++contourCount > 1) {
-                    fConvexity = kConcave_Convexity;
-                    return kConcave_Convexity;
+                    return SkPath::kConcave_Convexity;
                 }
                 pts[1] = pts[0];
                 // fall through
-            case kLine_Verb:
+            case SkPath::kLine_Verb:
                 count = 1;
                 state.setCurve(false);
                 break;
-            case kQuad_Verb:
+            case SkPath::kQuad_Verb:
                 // fall through
-            case kConic_Verb:
+            case SkPath::kConic_Verb:
                 // fall through
-            case kCubic_Verb:
-                count = 2 + (kCubic_Verb == verb);
+            case SkPath::kCubic_Verb:
+                count = 2 + (SkPath::kCubic_Verb == verb);
                 // As an additional enhancement, this could set curve true only
                 // if the curve is nonlinear
                 state.setCurve(true);
                 break;
-            case kClose_Verb:
+            case SkPath::kClose_Verb:
                 state.setCurve(false);
                 state.close();
                 count = 0;
                 break;
             default:
                 SkDEBUGFAIL("bad verb");
-                fConvexity = kConcave_Convexity;
-                return kConcave_Convexity;
+                return SkPath::kConcave_Convexity;
         }
 
         for (int i = 1; i <= count; i++) {
@@ -2489,16 +2485,35 @@ SkPath::Convexity SkPath::internalGetConvexity() const {
         }
         // early exit
         if (!state.isFinite()) {
-            return kUnknown_Convexity;
+            return SkPath::kUnknown_Convexity;
         }
-        if (kConcave_Convexity == state.getConvexity()) {
-            fConvexity = kConcave_Convexity;
-            return kConcave_Convexity;
+        if (SkPath::kConcave_Convexity == state.getConvexity()) {
+            return SkPath::kConcave_Convexity;
+        }
+    }
+    *firstDirection = state.getFirstDirection();
+    return state.getConvexity();
+}
+
+SkPath::Convexity SkPath::internalGetConvexity() const {
+    SkASSERT(kUnknown_Convexity == fConvexity);
+    if (!isFinite()) {
+        return kUnknown_Convexity;
+    }
+    // Copies of this path share its SkPathRef, and with it the convexity once any of them asks.
+    SkPathPriv::FirstDirection firstDirection;
+    Convexity convexity = SkPathPriv::SharedConvexity(*this, &firstDirection);
+    if (kUnknown_Convexity == convexity) {
+        firstDirection = SkPathPriv::kUnknown_FirstDirection;
+        convexity = compute_convexity(*this, &firstDirection);
+        if (kUnknown_Convexity == convexity) {
+            return kUnknown_Convexity;
         }
+        SkPathPriv::SetSharedConvexity(*this, convexity, firstDirection);
     }
-    fConvexity = state.getConvexity();
+    fConvexity = convexity;
     if (kConvex_Convexity == fConvexity && SkPathPriv::kUnknown_FirstDirection == fFirstDirection) {
-        fFirstDirection = state.getFirstDirection();
+        fFirstDirection = firstDirection;
     }
     return static_cast<Convexity>(fConvexity);
 }
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPathAnalysis.h"
+
+#include "SkGeometry.h"
+
+// Caps how finely one curve is flattened, however small the tolerance.
+static const int kMaxCurveLines = 1024;
+
+// Returns n so that error / n^2 is within tolerance.
+static int count_lines(SkScalar error, SkScalar tolerance) {
+    SkScalar lines = SkScalarCeilToScalar(SkScalarSqrt(error / tolerance));
+    return SkScalarIsFinite(lines) ? (int)SkTPin<SkScalar>(lines, 1, kMaxCurveLines)
+                                   : kMaxCurveLines;
+}
+
+// A quad's chords stray from it by at most |p0 - 2p1 + p2| / (4 n^2) when cut n times.
+static void flatten_quad(const SkPoint pts[3], SkScalar tolerance, SkPath* polyline) {
+    SkScalar dd = (pts[0] - pts[1] - pts[1] + pts[2]).length();
+    int lines = count_lines(dd / 4, tolerance);
+    for (int i = 1; i < lines; ++i) {
+        polyline->lineTo(SkEvalQuadAt(pts, (SkScalar)i / lines));
+    }
+    polyline->lineTo(pts[2]);
+}
+
+// A cubic's chords stray from it by at most 3 max|pi - 2pi+1 + pi+2| / (4 n^2).
+static void flatten_cubic(const SkPoint pts[4], SkScalar tolerance, SkPath* polyline) {
+    SkScalar dd = SkTMax((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                         (pts[1] - pts[2] - pts[2] + pts[3]).length());
+    int lines = count_lines(dd * 3 / 4, tolerance);
+    for (int i = 1; i < lines; ++i) {
+        SkPoint pt;
+        SkEvalCubicAt(pts, (SkScalar)i / lines, &pt, nullptr, nullptr);
+        polyline->lineTo(pt);
+    }
+    polyline->lineTo(pts[3]);
+}
+
+static void flatten(const SkPath& path, SkScalar tolerance, SkPath* polyline) {
+    polyline->incReserve(path.countPoints());
+    SkPath::Iter iter(path, false);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                polyline->moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                polyline->lineTo(pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                flatten_quad(pts, tolerance, polyline);
+                break;
+            case SkPath::kConic_Verb: {
+                // Half the tolerance to the quads, and half from them to the lines.
+                SkAutoConicToQuads quadder;
+                const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                              tolerance / 2);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    flatten_quad(&quadPts[2 * i], tolerance / 2, polyline);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                flatten_cubic(pts, tolerance, polyline);
+                break;
+            case SkPath::kClose_Verb:
+                polyline->close();
+                break;
+            case SkPath::kDone_Verb:
+                break;
+        }
+    }
+}
+
+bool SkPathAnalysis::findPolyline(SkScalar tolerance, SkPath* polyline) const {
+    for (int i = 0; i < fPolylineCount; ++i) {
+        if (fPolylines[i].fTolerance == tolerance) {
+            *polyline = fPolylines[i].fPath;
+            return true;
+        }
+    }
+    return false;
+}
+
+SkPath SkPathAnalysis::polyline(const SkPath& path, SkScalar tolerance) {
+    SkPath result;
+    if (!(tolerance > 0)) {
+        return result;
+    }
+    bool found;
+    {
+        SkAutoMutexAcquire lock(fPolylineMutex);
+        found = this->findPolyline(tolerance, &result);
+    }
+    if (!found) {
+        // Flattened unlocked, so that other tolerances are not held up. Should another thread
+        // flatten at this tolerance meanwhile, whichever is kept first is used.
+        flatten(path, tolerance, &result);
+        result.updateBoundsCache();  // Avoids races later to be the first to do this.
+
+        SkAutoMutexAcquire lock(fPolylineMutex);
+        if (!this->findPolyline(tolerance, &result)) {
+            fPolylines[fNextPolyline] = { tolerance, result };
+            fNextPolyline = (fNextPolyline + 1) % kMaxPolylines;
+            if (fPolylineCount < kMaxPolylines) {
+                ++fPolylineCount;
+            }
+        }
+    }
+    // Paths sharing points and verbs may still differ in fill type.
+    result.setFillType(path.getFillType());
+    return result;
+}
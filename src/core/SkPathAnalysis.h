@@ -0,0 +1,70 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPathAnalysis_DEFINED
+#define SkPathAnalysis_DEFINED
+
+#include "SkMutex.h"
+#include "SkOnce.h"
+#include "SkPathPriv.h"
+
+/**
+ *  The costlier things worked out about the points and verbs of one SkPathRef, kept with it so
+ *  that every SkPath sharing the ref, and every draw of those paths, works each out once. The
+ *  ref allocates its analysis the first time one is asked for; convexity, which every fill asks
+ *  for, is kept in the ref itself (see SkPathPriv::SharedConvexity()).
+ *
+ *  The ref drops its analysis whenever its genID is reset, so an analysis only ever describes
+ *  one set of contents. Each part is computed the first time it is asked for; concurrent
+ *  callers wait for that one computation rather than repeat it.
+ *
+ *  Get the analysis of a path with SkPathPriv::Analysis(); it stays valid until the path's
+ *  points or verbs change.
+ */
+class SkPathAnalysis {
+public:
+    /**
+     *  Returns whether compute() found tight bounds, setting them, and calls compute() only the
+     *  first time. compute() has the signature of TightBounds().
+     */
+    template <typename Fn>
+    bool tightBounds(const SkPath& path, SkRect* bounds, Fn&& compute) {
+        fTightBoundsOnce([&] { fHasTightBounds = compute(path, &fTightBounds); });
+        if (fHasTightBounds) {
+            *bounds = fTightBounds;
+        }
+        return fHasTightBounds;
+    }
+
+    /**
+     *  Returns path with every curve replaced by lines no farther than tolerance from it. The
+     *  last few tolerances asked for are kept, so callers that flatten the same path over and
+     *  over at one tolerance flatten it once. The polyline keeps path's fill type, and is empty
+     *  if tolerance is not positive.
+     */
+    SkPath polyline(const SkPath& path, SkScalar tolerance);
+
+private:
+    // Called with fPolylineMutex held.
+    bool findPolyline(SkScalar tolerance, SkPath* polyline) const;
+
+    SkOnce fTightBoundsOnce;
+    SkRect fTightBounds = SkRect::MakeEmpty();
+    bool   fHasTightBounds = false;
+
+    static const int kMaxPolylines = 4;
+    struct Polyline {
+        SkScalar fTolerance;
+        SkPath   fPath;
+    };
+    SkMutex  fPolylineMutex;
+    Polyline fPolylines[kMaxPolylines];
+    int      fPolylineCount = 0;
+    int      fNextPolyline = 0;  // the oldest, replaced when all are in use
+};
+
+#endif
@@ -10,6 +10,8 @@
 
 #include "SkPath.h"
 
+class SkPathAnalysis;
+
 class SkPathPriv {
 public:
     enum FirstDirection {
@@ -84,6 +86,30 @@ public:
         path.fPathRef->addGenIDChangeListener(listener);
     }
 
+    /**
+     *  Returns what has been worked out about the path's points and verbs, shared with every
+     *  path that shares them. See SkPathAnalysis.h.
+     */
+    static SkPathAnalysis* Analysis(const SkPath& path) {
+        return path.fPathRef->analysis();
+    }
+
+    /**
+     *  Returns the convexity that some path sharing path's points and verbs found, setting its
+     *  first direction, or kUnknown_Convexity if none has yet.
+     */
+    static SkPath::Convexity SharedConvexity(const SkPath& path, FirstDirection* firstDirection) {
+        uint8_t packed = path.fPathRef->fConvexity;
+        *firstDirection = (FirstDirection)(packed >> 2);
+        return (SkPath::Convexity)(packed & 3);
+    }
+
+    static void SetSharedConvexity(const SkPath& path, SkPath::Convexity convexity,
+                                   FirstDirection firstDirection) {
+        SkASSERT(SkPath::kUnknown_Convexity != convexity);
+        path.fPathRef->fConvexity = (uint8_t)(convexity | (firstDirection << 2));
+    }
+
     /**
      * This returns true for a rect that begins and ends at the same corner and has either a move
      * followed by four lines or a move followed by 3 lines and a close. None of the parameters are
@@ -8,6 +8,7 @@
 #include "SkBuffer.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkPathAnalysis.h"
 #include "SkPathRef.h"
 #include <limits>
 
@@ -26,6 +27,7 @@ SkPathRef::Editor::Editor(sk_sp<SkPathRef>* pathRef,
     fPathRef = pathRef->get();
     fPathRef->callGenIDChangeListeners();
     fPathRef->fGenerationID = 0;
+    fPathRef->resetAnalysis();
     SkDEBUGCODE(sk_atomic_inc(&fPathRef->fEditorsAttached);)
 }
 
@@ -35,6 +37,7 @@ SkPathRef::~SkPathRef() {
     this->callGenIDChangeListeners();
     SkDEBUGCODE(this->validate();)
     sk_free(fPoints);
+    delete fAnalysis.load();
 
     SkDEBUGCODE(fPoints = nullptr;)
     SkDEBUGCODE(fVerbs = nullptr;)
@@ -133,6 +136,8 @@ void SkPathRef::CreateTransformedCopy(sk_sp<SkPathRef>* dst,
         sk_careful_memcpy((*dst)->verbsMemWritable(), src.verbsMemBegin(),
                            src.fVerbCnt * sizeof(uint8_t));
         (*dst)->fConicWeights = src.fConicWeights;
+    } else {
+        (*dst)->resetAnalysis();
     }
 
     SkASSERT((*dst)->countPoints() == src.countPoints());
@@ -299,6 +304,7 @@ void SkPathRef::Rewind(sk_sp<SkPathRef>* pathRef) {
         (*pathRef)->fPointCnt = 0;
         (*pathRef)->fFreeSpace = (*pathRef)->currSize();
         (*pathRef)->fGenerationID = 0;
+        (*pathRef)->resetAnalysis();
         (*pathRef)->fConicWeights.rewind();
         (*pathRef)->fSegmentMask = 0;
         (*pathRef)->fIsOval = false;
@@ -428,6 +434,7 @@ void SkPathRef::interpolate(const SkPathRef& ending, SkScalar weight, SkPathRef*
         outValues[index] = outValues[index] * weight + inValues[index] * (1 - weight);
     }
     out->fBoundsIsDirty = true;
+    out->resetAnalysis();
     out->fIsOval = false;
     out->fIsRRect = false;
 }
@@ -606,6 +613,28 @@ void SkPathRef::callGenIDChangeListeners() {
     fGenIDChangeListeners.deleteAll();
 }
 
+SkPathAnalysis* SkPathRef::analysis() const {
+    SkPathAnalysis* analysis = fAnalysis.load(sk_memory_order_acquire);
+    if (!analysis) {
+        // Shared refs can be asked from several threads at once; the first to store one wins.
+        SkPathAnalysis* created = new SkPathAnalysis;
+        if (fAnalysis.compare_exchange(&analysis, created, sk_memory_order_acq_rel,
+                                       sk_memory_order_acquire)) {
+            analysis = created;
+        } else {
+            delete created;
+        }
+    }
+    return analysis;
+}
+
+// Only called while this is unique, so no other thread can be using the analysis.
+void SkPathRef::resetAnalysis() {
+    fConvexity = 0;
+    delete fAnalysis.load(sk_memory_order_relaxed);
+    fAnalysis.store(nullptr, sk_memory_order_relaxed);
+}
+
 SkRRect SkPathRef::getRRect() const {
     const SkRect& bounds = this->getBounds();
     SkVector radii[4] = {{0, 0}, {0, 0}, {0, 0}, {0, 0}};
@@ -8,6 +8,7 @@
 #include "SkAtomics.h"
 #include "SkImageDeserializer.h"
 #include "SkImageGenerator.h"
+#include "SkLazyPicture.h"
 #include "SkMessageBus.h"
 #include "SkPicture.h"
 #include "SkPictureData.h"
@@ -132,13 +133,14 @@ bool SkPicture::InternalOnly_BufferIsSKP(SkReadBuffer* buffer, SkPictInfo* pInfo
 
 sk_sp<SkPicture> SkPicture::Forwardport(const SkPictInfo& info,
                                         const SkPictureData* data,
-                                        SkReadBuffer* buffer) {
+                                        SkReadBuffer* buffer,
+                                        SkBBHFactory* bbhFactory) {
     if (!data) {
         return nullptr;
     }
     SkPicturePlayback playback(data);
     SkPictureRecorder r;
-    playback.draw(r.beginRecording(info.fCullRect), nullptr/*no callback*/, buffer);
+    playback.draw(r.beginRecording(info.fCullRect, bbhFactory), nullptr/*no callback*/, buffer);
     return r.finishRecordingAsPicture();
 }
 
@@ -165,14 +167,30 @@ sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, SkImageDeserializer
     return MakeFromStream(&stream, factory, nullptr);
 }
 
+sk_sp<SkPicture> SkPicture::MakeFromData(const SkData* data, SkImageDeserializer* factory,
+                                         SkExecutor* executor) {
+    if (!data) {
+        return nullptr;
+    }
+    SkMemoryStream stream(data->data(), data->size());
+    return MakeFromStream(&stream, factory, nullptr, nullptr, executor);
+}
+
+sk_sp<SkPicture> SkPicture::MakeLazyFromData(sk_sp<SkData> data) {
+    return SkLazyPicture::Make(std::move(data));
+}
+
 sk_sp<SkPicture> SkPicture::MakeFromStream(SkStream* stream, SkImageDeserializer* factory,
-                                           SkTypefacePlayback* typefaces) {
+                                           SkTypefacePlayback* typefaces,
+                                           const SkData* backingData,
+                                           SkExecutor* executor) {
     SkPictInfo info;
     if (!InternalOnly_StreamIsSKP(stream, &info) || !stream->readBool()) {
         return nullptr;
     }
     std::unique_ptr<SkPictureData> data(
-            SkPictureData::CreateFromStream(stream, info, factory, typefaces));
+            SkPictureData::CreateFromStream(stream, info, factory, typefaces, backingData,
+                                            executor));
     return Forwardport(info, data.get(), nullptr);
 }
 
@@ -195,25 +213,31 @@ SkPictureData* SkPicture::backport() const {
 }
 
 void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer) const {
-    this->serialize(stream, pixelSerializer, nullptr);
+    this->serialize(stream, pixelSerializer, nullptr, nullptr);
+}
+
+void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer,
+                          SkExecutor* executor) const {
+    this->serialize(stream, pixelSerializer, nullptr, executor);
 }
 
 sk_sp<SkData> SkPicture::serialize(SkPixelSerializer* pixelSerializer) const {
     SkDynamicMemoryWStream stream;
-    this->serialize(&stream, pixelSerializer, nullptr);
+    this->serialize(&stream, pixelSerializer, nullptr, nullptr);
     return stream.detachAsData();
 }
 
 void SkPicture::serialize(SkWStream* stream,
                           SkPixelSerializer* pixelSerializer,
-                          SkRefCntSet* typefaceSet) const {
+                          SkRefCntSet* typefaceSet,
+                          SkExecutor* executor) const {
     SkPictInfo info = this->createHeader();
     std::unique_ptr<SkPictureData> data(this->backport());
 
     stream->write(&info, sizeof(info));
     if (data) {
         stream->writeBool(true);
-        data->serialize(stream, pixelSerializer, typefaceSet);
+        data->serialize(stream, pixelSerializer, typefaceSet, executor);
     } else {
         stream->writeBool(false);
     }
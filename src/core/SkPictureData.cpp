@@ -7,11 +7,12 @@
 
 #include <new>
 
-#include "SkAutoMalloc.h"
+#include "SkImageDeserializer.h"
 #include "SkImageGenerator.h"
 #include "SkPictureData.h"
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
@@ -238,7 +239,7 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     }
 }
 
-void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
+void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer, SkExecutor* executor) const {
     int i, n;
 
     if ((n = fPaints.count()) > 0) {
@@ -251,9 +252,7 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
     if ((n = fPaths.count()) > 0) {
         write_tag_size(buffer, SK_PICT_PATH_BUFFER_TAG, n);
         buffer.writeInt(n);
-        for (int i = 0; i < n; i++) {
-            buffer.writePath(fPaths[i]);
-        }
+        buffer.writePaths(fPaths.begin(), n, executor);
     }
 
     if (fTextBlobCount > 0) {
@@ -272,15 +271,14 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
 
     if (fImageCount > 0) {
         write_tag_size(buffer, SK_PICT_IMAGE_BUFFER_TAG, fImageCount);
-        for (i = 0; i  < fImageCount; ++i) {
-            buffer.writeImage(fImageRefs[i]);
-        }
+        buffer.writeImages(fImageRefs, fImageCount, executor);
     }
 }
 
 void SkPictureData::serialize(SkWStream* stream,
                               SkPixelSerializer* pixelSerializer,
-                              SkRefCntSet* topLevelTypeFaceSet) const {
+                              SkRefCntSet* topLevelTypeFaceSet,
+                              SkExecutor* executor) const {
     // This can happen at pretty much any time, so might as well do it first.
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
@@ -296,7 +294,7 @@ void SkPictureData::serialize(SkWStream* stream,
     buffer.setFactoryRecorder(&factSet);
     buffer.setPixelSerializer(sk_ref_sp(pixelSerializer));
     buffer.setTypefaceRecorder(typefaceSet);
-    this->flattenToBuffer(buffer);
+    this->flattenToBuffer(buffer, executor);
 
     // Dummy serialize our sub-pictures for the side effect of filling
     // typefaceSet with typefaces from sub-pictures.
@@ -307,7 +305,7 @@ void SkPictureData::serialize(SkWStream* stream,
         size_t bytesWritten() const override { return fBytesWritten; }
     } devnull;
     for (int i = 0; i < fPictureCount; i++) {
-        fPictureRefs[i]->serialize(&devnull, pixelSerializer, typefaceSet);
+        fPictureRefs[i]->serialize(&devnull, pixelSerializer, typefaceSet, nullptr);
     }
 
     // We need to write factories before we write the buffer.
@@ -325,7 +323,7 @@ void SkPictureData::serialize(SkWStream* stream,
     if (fPictureCount > 0) {
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictureCount);
         for (int i = 0; i < fPictureCount; i++) {
-            fPictureRefs[i]->serialize(stream, pixelSerializer, typefaceSet);
+            fPictureRefs[i]->serialize(stream, pixelSerializer, typefaceSet, executor);
         }
     }
 
@@ -380,11 +378,32 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+// Read the next size bytes of stream.  If the stream is reading from backingData's memory,
+// return them as a subset of backingData instead of a copy.  SkReader32 needs its memory 4-byte
+// aligned, and the header leaves the op data at an odd offset, so unaligned bytes are copied.
+static sk_sp<SkData> share_or_copy_from_stream(SkStream* stream, size_t size,
+                                               const SkData* backingData, bool* shared) {
+    *shared = backingData && backingData->size() > 0 &&
+              stream->getMemoryBase() == backingData->data() && stream->hasPosition() &&
+              SkIsAlign4((uintptr_t)backingData->bytes() + stream->getPosition());
+    if (*shared) {
+        size_t offset = stream->getPosition();
+        if (offset > backingData->size() || size > backingData->size() - offset ||
+            stream->skip(size) != size) {
+            return nullptr;
+        }
+        return SkData::MakeSubset(backingData, offset, size);
+    }
+    return SkData::MakeFromStream(stream, size);
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
                                    SkImageDeserializer* factory,
-                                   SkTypefacePlayback* topLevelTFPlayback) {
+                                   SkTypefacePlayback* topLevelTFPlayback,
+                                   const SkData* backingData,
+                                   SkExecutor* executor) {
     /*
      *  By the time we encounter BUFFER_SIZE_TAG, we need to have already seen
      *  its dependents: FACTORY_TAG and TYPEFACE_TAG. These two are not required
@@ -397,13 +416,14 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     SkDEBUGCODE(bool haveBuffer = false;)
 
     switch (tag) {
-        case SK_PICT_READER_TAG:
+        case SK_PICT_READER_TAG: {
             SkASSERT(nullptr == fOpData);
-            fOpData = SkData::MakeFromStream(stream, size);
+            bool shared;
+            fOpData = share_or_copy_from_stream(stream, size, backingData, &shared);
             if (!fOpData) {
                 return false;
             }
-            break;
+        } break;
         case SK_PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
             size = stream->readU32();
@@ -436,7 +456,8 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             fPictureCount = 0;
             fPictureRefs = new const SkPicture* [size];
             for (uint32_t i = 0; i < size; i++) {
-                fPictureRefs[i] = SkPicture::MakeFromStream(stream, factory, topLevelTFPlayback).release();
+                fPictureRefs[i] = SkPicture::MakeFromStream(stream, factory, topLevelTFPlayback,
+                                                            backingData, executor).release();
                 if (!fPictureRefs[i]) {
                     return false;
                 }
@@ -444,13 +465,18 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
+            bool shared;
+            sk_sp<SkData> storage = share_or_copy_from_stream(stream, size, backingData, &shared);
+            if (!storage) {
                 return false;
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(storage->data(), storage->size());
+            if (shared) {
+                // Encoded images can share the bytes too.
+                buffer.setBackingData(storage);
+            }
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.getVersion());
 
@@ -471,7 +497,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             while (!buffer.eof() && buffer.isValid()) {
                 tag = buffer.readUInt();
                 size = buffer.readUInt();
-                if (!this->parseBufferTag(buffer, tag, size)) {
+                if (!this->parseBufferTag(buffer, tag, size, executor)) {
                     return false;
                 }
             }
@@ -544,7 +570,68 @@ bool new_array_from_buffer(SkReadBuffer& buffer, uint32_t inCount,
     return true;
 }
 
-bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size) {
+namespace {
+// Stands in for the real image deserializer while an image array is read, collecting the
+// encoded images so they can all be handed to the real one concurrently afterwards.  Until
+// then, the array holds the placeholders SkReadBuffer makes when deserializing fails.
+class DeferredImageDeserializer final : public SkImageDeserializer {
+public:
+    struct Pending {
+        int           fSlot;
+        sk_sp<SkData> fData;
+        SkIRect       fSubset;
+    };
+
+    void beginImage() { fSlot++; }
+
+    sk_sp<SkImage> makeFromData(SkData* data, const SkIRect* subset) override {
+        SkASSERT(subset);
+        fPending.push_back({ fSlot, sk_ref_sp(data), *subset });
+        return nullptr;
+    }
+    sk_sp<SkImage> makeFromMemory(const void* data, size_t length,
+                                  const SkIRect* subset) override {
+        return this->makeFromData(SkData::MakeWithCopy(data, length).get(), subset);
+    }
+
+    SkTArray<Pending> fPending;
+
+private:
+    int fSlot = -1;
+};
+}  // namespace
+
+static const SkImage* create_deferred_image_from_buffer(SkReadBuffer& buffer) {
+    static_cast<DeferredImageDeserializer*>(buffer.getImageDeserializer())->beginImage();
+    return buffer.readImage().release();
+}
+
+bool SkPictureData::parseImagesConcurrently(SkReadBuffer& buffer, uint32_t count,
+                                            SkExecutor* executor) {
+    SkImageDeserializer* factory = buffer.getImageDeserializer();
+    DeferredImageDeserializer deferred;
+    buffer.setImageDeserializer(&deferred);
+    bool success = new_array_from_buffer(buffer, count, &fImageRefs, &fImageCount,
+                                         create_deferred_image_from_buffer);
+    buffer.setImageDeserializer(factory);
+    if (!success) {
+        return false;
+    }
+
+    SkTaskGroup(*executor).batch(deferred.fPending.count(), [&](int i) {
+        const DeferredImageDeserializer::Pending& pending = deferred.fPending[i];
+        if (sk_sp<SkImage> image = factory->makeFromData(pending.fData.get(),
+                                                          &pending.fSubset)) {
+            // Each slot belongs to exactly one task.
+            fImageRefs[pending.fSlot]->unref();
+            fImageRefs[pending.fSlot] = image.release();
+        }
+    });
+    return true;
+}
+
+bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t size,
+                                   SkExecutor* executor) {
     switch (tag) {
         case SK_PICT_BITMAP_BUFFER_TAG:
             if (!new_array_from_buffer(buffer, size, &fBitmapImageRefs, &fBitmapImageCount,
@@ -583,8 +670,12 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
             }
             break;
         case SK_PICT_IMAGE_BUFFER_TAG:
-            if (!new_array_from_buffer(buffer, size, &fImageRefs, &fImageCount,
-                                       create_image_from_buffer)) {
+            if (executor) {
+                if (!this->parseImagesConcurrently(buffer, size, executor)) {
+                    return false;
+                }
+            } else if (!new_array_from_buffer(buffer, size, &fImageRefs, &fImageCount,
+                                              create_image_from_buffer)) {
                 return false;
             }
             break;
@@ -619,13 +710,15 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
 SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
                                                const SkPictInfo& info,
                                                SkImageDeserializer* factory,
-                                               SkTypefacePlayback* topLevelTFPlayback) {
+                                               SkTypefacePlayback* topLevelTFPlayback,
+                                               const SkData* backingData,
+                                               SkExecutor* executor) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
     if (!topLevelTFPlayback) {
         topLevelTFPlayback = &data->fTFPlayback;
     }
 
-    if (!data->parseStream(stream, factory, topLevelTFPlayback)) {
+    if (!data->parseStream(stream, factory, topLevelTFPlayback, backingData, executor)) {
         return nullptr;
     }
     return data.release();
@@ -644,7 +737,9 @@ SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
 
 bool SkPictureData::parseStream(SkStream* stream,
                                 SkImageDeserializer* factory,
-                                SkTypefacePlayback* topLevelTFPlayback) {
+                                SkTypefacePlayback* topLevelTFPlayback,
+                                const SkData* backingData,
+                                SkExecutor* executor) {
     for (;;) {
         uint32_t tag = stream->readU32();
         if (SK_PICT_EOF_TAG == tag) {
@@ -652,7 +747,8 @@ bool SkPictureData::parseStream(SkStream* stream,
         }
 
         uint32_t size = stream->readU32();
-        if (!this->parseStreamTag(stream, tag, size, factory, topLevelTFPlayback)) {
+        if (!this->parseStreamTag(stream, tag, size, factory, topLevelTFPlayback,
+                                  backingData, executor)) {
             return false; // we're invalid
         }
     }
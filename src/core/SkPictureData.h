@@ -15,6 +15,7 @@
 #include "SkPictureFlat.h"
 
 class SkData;
+class SkExecutor;
 class SkPictureRecord;
 class SkPixelSerializer;
 class SkReader32;
@@ -77,16 +78,21 @@ public:
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream.  If the stream reads from the memory of
+    // backingData, op data and encoded images share those bytes rather than copying them.
+    // If executor is not null, images are decoded on it concurrently.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            SkImageDeserializer*,
-                                           SkTypefacePlayback*);
+                                           SkTypefacePlayback*,
+                                           const SkData* backingData = nullptr,
+                                           SkExecutor* executor = nullptr);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
 
     virtual ~SkPictureData();
 
-    void serialize(SkWStream*, SkPixelSerializer*, SkRefCntSet*) const;
+    // If executor is not null, paths and images are flattened on it concurrently.
+    void serialize(SkWStream*, SkPixelSerializer*, SkRefCntSet*, SkExecutor* = nullptr) const;
     void flatten(SkWriteBuffer&) const;
 
     bool containsBitmaps() const;
@@ -101,7 +107,8 @@ protected:
     explicit SkPictureData(const SkPictInfo& info);
 
     // Does not affect ownership of SkStream.
-    bool parseStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*);
+    bool parseStream(SkStream*, SkImageDeserializer*, SkTypefacePlayback*,
+                     const SkData* backingData, SkExecutor*);
     bool parseBuffer(SkReadBuffer& buffer);
 
 public:
@@ -173,9 +180,13 @@ private:
     // these help us with reading/writing
     // Does not affect ownership of SkStream.
     bool parseStreamTag(SkStream*, uint32_t tag, uint32_t size,
-                        SkImageDeserializer*, SkTypefacePlayback*);
-    bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
-    void flattenToBuffer(SkWriteBuffer&) const;
+                        SkImageDeserializer*, SkTypefacePlayback*, const SkData* backingData,
+                        SkExecutor*);
+    bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size, SkExecutor* = nullptr);
+    // Parses an image array, decoding the images on executor.  The image deserializer set on
+    // the buffer must be thread-safe.
+    bool parseImagesConcurrently(SkReadBuffer&, uint32_t count, SkExecutor*);
+    void flattenToBuffer(SkWriteBuffer&, SkExecutor* = nullptr) const;
 
     SkTArray<SkPaint>  fPaints;
     SkTArray<SkPath>   fPaths;
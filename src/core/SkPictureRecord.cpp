@@ -6,14 +6,19 @@
  */
 
 #include "SkPictureRecord.h"
+#include "SkDeduper.h"
 #include "SkImage_Base.h"
+#include "SkOpts.h"
 #include "SkPatchUtils.h"
+#include "SkPathPriv.h"
 #include "SkPixelRef.h"
 #include "SkRRect.h"
 #include "SkRSXform.h"
 #include "SkTextBlob.h"
 #include "SkTSearch.h"
 #include "SkClipOpPriv.h"
+#include "SkTypeface.h"
+#include "SkWriteBuffer.h"
 
 #define HEAP_BLOCK_SIZE 4096
 
@@ -25,8 +30,35 @@ enum {
 // A lot of basic types get stored as a uint32_t: bools, ints, paint indices, etc.
 static int const kUInt32Size = 4;
 
+// Only used to key paints: writes images, pictures and typefaces as their unique IDs, and
+// factories as the order we first saw them in.
+class SkPictureRecord::PaintDeduper : public SkDeduper {
+public:
+    int findOrDefineImage(SkImage* image) override { return image->uniqueID(); }
+    int findOrDefinePicture(SkPicture* picture) override { return picture->uniqueID(); }
+    int findOrDefineTypeface(SkTypeface* typeface) override {
+        return typeface ? typeface->uniqueID() : 0;
+    }
+    int findOrDefineFactory(SkFlattenable* flattenable) override {
+        if (!flattenable) {
+            return 0;
+        }
+        SkFlattenable::Factory factory = flattenable->getFactory();
+        if (int* index = fFactories.find(factory)) {
+            return *index;
+        }
+        int index = fFactories.count() + 1;
+        fFactories.set(factory, index);
+        return index;
+    }
+
+private:
+    SkTHashMap<SkFlattenable::Factory, int> fFactories;
+};
+
 SkPictureRecord::SkPictureRecord(const SkISize& dimensions, uint32_t flags)
     : INHERITED(dimensions.width(), dimensions.height())
+    , fPaintDeduper(new PaintDeduper)
     , fRecordFlags(flags)
     , fInitialSaveCount(kNoInitialSave) {
 }
@@ -849,19 +881,47 @@ void SkPictureRecord::addPaintPtr(const SkPaint* paint) {
     fContentInfo.onAddPaintPtr(paint);
 
     if (paint) {
+        SkBinaryWriteBuffer buffer;
+        buffer.setDeduper(fPaintDeduper.get());
+        buffer.writePaint(*paint);
+        FlatPaint key;
+        key.fBytes = SkData::MakeUninitialized(buffer.bytesWritten());
+        buffer.writeToMemory(key.fBytes->writable_data());
+        key.fHash = SkOpts::hash(key.fBytes->data(), key.fBytes->size());
+
+        if (int* n = fPaintIndices.find(key)) {
+            this->addInt(*n);
+            return;
+        }
         fPaints.push_back(*paint);
+        fPaintIndices.set(key, fPaints.count());
         this->addInt(fPaints.count());
     } else {
         this->addInt(0);
     }
 }
 
+uint32_t SkPictureRecord::PathHash::operator()(const SkPath& p) {
+    uint32_t hash = p.getFillType();
+    hash = SkOpts::hash(SkPathPriv::VerbData(p), p.countVerbs(), hash);
+    hash = SkOpts::hash(SkPathPriv::PointData(p), p.countPoints() * sizeof(SkPoint), hash);
+    return SkOpts::hash(SkPathPriv::ConicWeightData(p),
+                        SkPathPriv::ConicWeightCnt(p) * sizeof(SkScalar), hash);
+}
+
 int SkPictureRecord::addPathToHeap(const SkPath& path) {
-    if (int* n = fPaths.find(path)) {
+    const uint64_t id = (uint64_t)path.getGenerationID() << 8 | path.getFillType();
+    if (int* n = fPathsByID.find(id)) {
         return *n;
     }
-    int n = fPaths.count() + 1;  // 0 is reserved for null / error.
-    fPaths.set(path, n);
+    int n;
+    if (int* found = fPaths.find(path)) {
+        n = *found;
+    } else {
+        n = fPaths.count() + 1;  // 0 is reserved for null / error.
+        fPaths.set(path, n);
+    }
+    fPathsByID.set(id, n);
     return n;
 }
 
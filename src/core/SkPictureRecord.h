@@ -261,10 +261,32 @@ private:
 
     SkTArray<SkPaint>  fPaints;
 
+    // Paints are deduplicated by their flattened bytes, so paints built separately with equal
+    // settings and effects share one entry.  PaintDeduper flattens the objects a paint refers
+    // to (images, typefaces, factories) as indices by identity, so equal bytes mean equal paints.
+    struct FlatPaint {
+        sk_sp<SkData> fBytes;
+        uint32_t      fHash;
+
+        bool operator==(const FlatPaint& that) const {
+            return fHash == that.fHash && fBytes->equals(that.fBytes.get());
+        }
+    };
+    struct FlatPaintHash {
+        uint32_t operator()(const FlatPaint& p) { return p.fHash; }
+    };
+    class PaintDeduper;
+    std::unique_ptr<PaintDeduper>           fPaintDeduper;
+    SkTHashMap<FlatPaint, int, FlatPaintHash> fPaintIndices;
+
+    // Paths are deduplicated by contents, not just generation ID, so separately built copies of
+    // the same path are only written once.  fPathsByID remembers the paths we've already seen by
+    // generation ID and fill type, which spares hashing the contents of paths drawn repeatedly.
     struct PathHash {
-        uint32_t operator()(const SkPath& p) { return p.getGenerationID(); }
+        uint32_t operator()(const SkPath& p);
     };
     SkTHashMap<SkPath, int, PathHash> fPaths;
+    SkTHashMap<uint64_t, int>         fPathsByID;
 
     SkWriter32 fWriter;
 
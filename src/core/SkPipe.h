@@ -33,6 +33,17 @@ public:
 
     void resetCache();
 
+    /**
+     *  Images and typefaces are defined once and then referred to by index in every later
+     *  stream, so the deserializer fed those streams holds on to all of them.  This caps the
+     *  encoded size of what it holds: when endWrite() finds the total over budget, it appends
+     *  messages to that stream telling the deserializer to forget the least recently drawn ones,
+     *  never ones drawn by the stream just written.  A forgotten resource is simply defined
+     *  again if it is drawn later.  0 (the default) means no limit.
+     */
+    void setResourceBudget(size_t bytes);
+    size_t getResourceBytes() const;
+
     sk_sp<SkData> writeImage(SkImage*);
     sk_sp<SkData> writePicture(SkPicture*);
 
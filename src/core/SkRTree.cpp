@@ -5,13 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkNx.h"
 #include "SkRTree.h"
+#include "SkTArray.h"
 
 SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio) {}
 
 SkRect SkRTree::getRootBound() const {
     if (fCount) {
-        return fRoot.fBounds;
+        return fRootBounds;
     } else {
         return SkRect::MakeEmpty();
     }
@@ -31,57 +33,39 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
 
         Branch* b = branches.push();
         b->fBounds = bounds;
-        b->fOpIndex = i;
+        b->fIndex = i;
     }
 
     fCount = branches.count();
     if (fCount) {
-        if (1 == fCount) {
-            fNodes.setReserve(1);
-            Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
-        } else {
-            fNodes.setReserve(CountNodes(fCount, fAspectRatio));
-            fRoot = this->bulkLoad(&branches);
-        }
+        this->bulkLoad(&branches);
     }
 }
 
-SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
-    SkDEBUGCODE(Node* p = fNodes.begin());
-    Node* out = fNodes.push();
-    SkASSERT(fNodes.begin() == p);  // If this fails, we didn't setReserve() enough.
-    out->fNumChildren = 0;
-    out->fLevel = level;
-    return out;
-}
-
-// This function parallels bulkLoad, but just counts how many nodes bulkLoad would allocate.
-int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
-    if (branches == 1) {
-        return 1;
-    }
+void SkRTree::ComputeNodeSizes(int branches, SkScalar aspectRatio, SkTDArray<int>* sizes) {
     int numBranches = branches / kMaxChildren;
     int remainder   = branches % kMaxChildren;
+
     if (remainder > 0) {
-        numBranches++;
+        ++numBranches;
+        // If the remainder isn't enough to fill a node, we'll add fewer nodes to other branches.
         if (remainder >= kMinChildren) {
             remainder = 0;
         } else {
             remainder = kMinChildren - remainder;
         }
     }
+
     int numStrips = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(numBranches) / aspectRatio));
     int numTiles  = SkScalarCeilToInt(SkIntToScalar(numBranches) / SkIntToScalar(numStrips));
     int currentBranch = 0;
-    int nodes = 0;
+
     for (int i = 0; i < numStrips; ++i) {
+        // Might be worth sorting by X here too.
         for (int j = 0; j < numTiles && currentBranch < branches; ++j) {
             int incrementBy = kMaxChildren;
             if (remainder != 0) {
+                // if need be, omit some nodes to make up for remainder
                 if (remainder <= kMaxChildren - kMinChildren) {
                     incrementBy -= remainder;
                     remainder = 0;
@@ -90,90 +74,132 @@ int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
                     remainder -= kMaxChildren - kMinChildren;
                 }
             }
-            nodes++;
-            currentBranch++;
-            for (int k = 1; k < incrementBy && currentBranch < branches; ++k) {
-                currentBranch++;
-            }
+            int size = SkTMin(incrementBy, branches - currentBranch);
+            sizes->push(size);
+            currentBranch += size;
         }
     }
-    return nodes + CountNodes(nodes, aspectRatio);
 }
 
-SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
-    if (branches->count() == 1) { // Only one branch.  It will be the root.
-        return (*branches)[0];
-    }
-
+void SkRTree::bulkLoad(SkTDArray<Branch>* branches) {
     // We might sort our branches here, but we expect Blink gives us a reasonable x,y order.
     // Skipping a call to sort (in Y) here resulted in a 17% win for recording with negligible
     // difference in playback speed.
-    int numBranches = branches->count() / kMaxChildren;
-    int remainder   = branches->count() % kMaxChildren;
-    int newBranches = 0;
-
-    if (remainder > 0) {
-        ++numBranches;
-        // If the remainder isn't enough to fill a node, we'll add fewer nodes to other branches.
-        if (remainder >= kMinChildren) {
-            remainder = 0;
-        } else {
-            remainder = kMinChildren - remainder;
+    struct Level {
+        SkTDArray<Branch> fBranches;
+        SkTDArray<int> fNodeSizes;
+    };
+    SkTArray<Level> levels;
+    levels.push_back().fBranches.swap(*branches);
+
+    // Group each level's branches into nodes, which become the branches of the level above,
+    // until a single branch is left to be the root.  Even a lone op gets a node of its own.
+    do {
+        SkTDArray<int> sizes;
+        const SkTDArray<Branch>& children = levels.back().fBranches;
+        ComputeNodeSizes(children.count(), fAspectRatio, &sizes);
+
+        SkTDArray<Branch> parents;
+        parents.setReserve(sizes.count());
+        int child = 0;
+        for (int i = 0; i < sizes.count(); ++i) {
+            Branch* b = parents.push();
+            b->fIndex = i;  // Index among this level's nodes.
+            b->fBounds = children[child].fBounds;
+            for (int k = 1; k < sizes[i]; ++k) {
+                b->fBounds.join(children[child + k].fBounds);
+            }
+            child += sizes[i];
         }
+        levels.back().fNodeSizes.swap(sizes);
+        levels.push_back().fBranches.swap(parents);
+    } while (levels.back().fBranches.count() > 1);
+
+    // Lay the nodes out breadth-first: the root, then each level below it in order.  STR
+    // groups consecutive branches, so each node's children are themselves consecutive.
+    const int nodeLevels = levels.count() - 1;
+    fRootBounds = levels.back().fBranches[0].fBounds;
+    SkAutoSTMalloc<16, int> levelOffsets(nodeLevels);
+    int nodeCount = 0;
+    for (int i = nodeLevels - 1; i >= 0; --i) {
+        levelOffsets[i] = nodeCount;
+        nodeCount += levels[i].fNodeSizes.count();
     }
-
-    int numStrips = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(numBranches) / fAspectRatio));
-    int numTiles  = SkScalarCeilToInt(SkIntToScalar(numBranches) / SkIntToScalar(numStrips));
-    int currentBranch = 0;
-
-    for (int i = 0; i < numStrips; ++i) {
-        // Might be worth sorting by X here too.
-        for (int j = 0; j < numTiles && currentBranch < branches->count(); ++j) {
-            int incrementBy = kMaxChildren;
-            if (remainder != 0) {
-                // if need be, omit some nodes to make up for remainder
-                if (remainder <= kMaxChildren - kMinChildren) {
-                    incrementBy -= remainder;
-                    remainder = 0;
+    fNodes.setReserve(nodeCount);
+    fNodes.setCount(nodeCount);
+
+    for (int i = 0; i < nodeLevels; ++i) {
+        const SkTDArray<Branch>& children = levels[i].fBranches;
+        const SkTDArray<int>& sizes = levels[i].fNodeSizes;
+        int child = 0;
+        for (int j = 0; j < sizes.count(); ++j) {
+            Node* node = &fNodes[levelOffsets[i] + j];
+            node->fNumChildren = SkToU16(sizes[j]);
+            node->fLevel = SkToU16(i);
+            for (int k = 0; k < kPaddedChildren; ++k) {
+                if (k < sizes[j]) {
+                    const Branch& b = children[child + k];
+                    node->fLeft  [k] = b.fBounds.fLeft;
+                    node->fTop   [k] = b.fBounds.fTop;
+                    node->fRight [k] = b.fBounds.fRight;
+                    node->fBottom[k] = b.fBounds.fBottom;
+                    node->fChildren[k] = 0 == i ? b.fIndex : levelOffsets[i - 1] + b.fIndex;
                 } else {
-                    incrementBy = kMinChildren;
-                    remainder -= kMaxChildren - kMinChildren;
+                    // Inside out, so this never intersects anything.
+                    node->fLeft  [k] = node->fTop   [k] = SK_ScalarInfinity;
+                    node->fRight [k] = node->fBottom[k] = SK_ScalarNegativeInfinity;
+                    node->fChildren[k] = -1;
                 }
             }
-            Node* n = allocateNodeAtLevel(level);
-            n->fNumChildren = 1;
-            n->fChildren[0] = (*branches)[currentBranch];
-            Branch b;
-            b.fBounds = (*branches)[currentBranch].fBounds;
-            b.fSubtree = n;
-            ++currentBranch;
-            for (int k = 1; k < incrementBy && currentBranch < branches->count(); ++k) {
-                b.fBounds.join((*branches)[currentBranch].fBounds);
-                n->fChildren[k] = (*branches)[currentBranch];
-                ++n->fNumChildren;
-                ++currentBranch;
-            }
-            (*branches)[newBranches] = b;
-            ++newBranches;
+            child += sizes[j];
         }
     }
-    branches->setCount(newBranches);
-    return this->bulkLoad(branches, level + 1);
 }
 
 void SkRTree::search(const SkRect& query, SkTDArray<int>* results) const {
-    if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+    if (0 == fCount || !SkRect::Intersects(fRootBounds, query)) {
+        return;
     }
-}
+    const Sk4f queryL(query.fLeft),  queryT(query.fTop),
+               queryR(query.fRight), queryB(query.fBottom);
+
+    // Depth-first, visiting children in order, so results come out sorted like the ops.
+    // Each level holds at most kMaxChildren pending nodes.
+    SkAutoSTMalloc<16 * kMaxChildren, int32_t> stack(this->getDepth() * kMaxChildren);
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0) {
+        const Node& node = fNodes[stack[--stackSize]];
+
+        // Same test as SkRect::Intersects(): max(lefts) < min(rights), and likewise for y.
+        // Each lane of hits is all ones or all zeros.
+        uint32_t hits[kPaddedChildren];
+        bool anyHits = false;
+        for (int i = 0; i < kPaddedChildren; i += 4) {
+            Sk4f l = Sk4f::Max(Sk4f::Load(node.fLeft   + i), queryL),
+                 t = Sk4f::Max(Sk4f::Load(node.fTop    + i), queryT),
+                 r = Sk4f::Min(Sk4f::Load(node.fRight  + i), queryR),
+                 b = Sk4f::Min(Sk4f::Load(node.fBottom + i), queryB);
+            Sk4f mask = (l < r).thenElse(t < b, 0.0f);
+            anyHits |= mask.anyTrue();
+            mask.store(hits + i);
+        }
+        if (!anyHits) {
+            continue;
+        }
 
-void SkRTree::search(Node* node, const SkRect& query, SkTDArray<int>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+        if (0 == node.fLevel) {
+            for (int i = 0; i < node.fNumChildren; ++i) {
+                if (hits[i] != 0) {
+                    results->push(node.fChildren[i]);
+                }
+            }
+        } else {
+            // Push in reverse so the first child is searched first.
+            for (int i = node.fNumChildren; i-- > 0;) {
+                if (hits[i] != 0) {
+                    stack[stackSize++] = node.fChildren[i];
+                }
             }
         }
     }
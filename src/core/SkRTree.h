@@ -27,6 +27,11 @@
  *
  *  Beckmann, N.; Kriegel, H. P.; Schneider, R.; Seeger, B. (1990). "The R*-tree:
  *      an efficient and robust access method for points and rectangles"
+ *
+ * Once loaded, the tree is stored as one flat array of nodes in breadth-first order, the root
+ * first.  Each node keeps its children's bounds as separate left/top/right/bottom arrays, so
+ * search() can test four children at a time with SkNx, and walks the tree with an explicit
+ * stack rather than recursion.
  */
 class SkRTree : public SkBBoxHierarchy {
 public:
@@ -47,7 +52,7 @@ public:
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fNodes[0].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -59,36 +64,34 @@ public:
                      kMaxChildren = 11;
 
 private:
-    struct Node;
+    // Children are tested four at a time, so round up.  Unused lanes hold empty bounds.
+    static const int kPaddedChildren = SkAlign4(kMaxChildren);
 
     struct Branch {
-        union {
-            Node* fSubtree;
-            int fOpIndex;
-        };
+        int fIndex;  // The op index at level 0, otherwise the index of the node below.
         SkRect fBounds;
     };
 
     struct Node {
+        float fLeft  [kPaddedChildren];
+        float fTop   [kPaddedChildren];
+        float fRight [kPaddedChildren];
+        float fBottom[kPaddedChildren];
+        int32_t fChildren[kPaddedChildren];  // Node indices, or op indices if fLevel is 0.
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
     };
 
-    void search(Node* root, const SkRect& query, SkTDArray<int>* results) const;
-
-    // Consumes the input array.
-    Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
-
-    // How many times will bulkLoad() call allocateNodeAtLevel()?
-    static int CountNodes(int branches, SkScalar aspectRatio);
+    // Groups branches into nodes level by level, from the leaves up, then lays the nodes out.
+    void bulkLoad(SkTDArray<Branch>* branches);
 
-    Node* allocateNodeAtLevel(uint16_t level);
+    // How many of a level's consecutive branches go in each of its nodes.
+    static void ComputeNodeSizes(int branches, SkScalar aspectRatio, SkTDArray<int>* sizes);
 
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
     SkScalar fAspectRatio;
-    Branch fRoot;
+    SkRect fRootBounds;
     SkTDArray<Node> fNodes;
 
     typedef SkBBoxHierarchy INHERITED;
@@ -216,6 +216,22 @@ uint32_t SkReadBuffer::getArrayCount() {
     return *(uint32_t*)fReader.peek();
 }
 
+sk_sp<SkData> SkReadBuffer::readByteArrayAsSubset(size_t len) {
+    SkASSERT(fBackingData);
+    (void)this->readUInt();  // Skip array count, already checked by our caller.
+    const uint8_t* bytes = (const uint8_t*)this->skip(SkAlign4(len));
+    if (!bytes || bytes < fBackingData->bytes() ||
+        bytes + len > fBackingData->bytes() + fBackingData->size()) {
+        this->validate(false);
+        return SkData::MakeEmpty();
+    }
+    if (!SkIsAlign4((uintptr_t)bytes)) {
+        // Keep subsets as aligned as the buffer is expected to be.
+        return SkData::MakeWithCopy(bytes, len);
+    }
+    return SkData::MakeSubset(fBackingData.get(), bytes - fBackingData->bytes(), len);
+}
+
 sk_sp<SkImage> SkReadBuffer::readBitmapAsImage() {
     const int width = this->readInt();
     const int height = this->readInt();
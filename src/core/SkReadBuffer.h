@@ -165,6 +165,9 @@ public:
         if (!this->validateAvailable(len)) {
             return SkData::MakeEmpty();
         }
+        if (fBackingData) {
+            return this->readByteArrayAsSubset(len);
+        }
         void* buffer = sk_malloc_throw(len);
         this->readByteArray(buffer, len);
         return SkData::MakeFromMalloc(buffer, len);
@@ -173,6 +176,12 @@ public:
     // helpers to get info about arrays and binary data
     virtual uint32_t getArrayCount();
 
+    /**
+     *  Declare that this buffer's memory lies within data.  readByteArrayAsData() then returns
+     *  subsets of data that share its bytes, instead of copies.
+     */
+    void setBackingData(sk_sp<SkData> data) { fBackingData = std::move(data); }
+
     sk_sp<SkImage> readBitmapAsImage();
     sk_sp<SkImage> readImage();
     virtual sk_sp<SkTypeface> readTypeface();
@@ -208,6 +217,7 @@ public:
     // If nullptr is passed, then the default deserializer will be used
     // which calls SkImage::MakeFromEncoded()
     void setImageDeserializer(SkImageDeserializer* factory);
+    SkImageDeserializer* getImageDeserializer() const { return fImageDeserializer; }
 
     // Default impelementations don't check anything.
     virtual bool validate(bool isValid) { return isValid; }
@@ -245,11 +255,13 @@ protected:
 
 private:
     bool readArray(void* value, size_t size, size_t elementSize);
+    sk_sp<SkData> readByteArrayAsSubset(size_t len);
 
     uint32_t fFlags;
     int fVersion;
 
     void* fMemoryPtr;
+    sk_sp<SkData> fBackingData;
 
     SkTypeface** fTFArray;
     int        fTFCount;
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRecordDiff.h"
+
+#include "SkBigPicture.h"
+#include "SkImage.h"
+#include "SkPicture.h"
+#include "SkRecordDraw.h"
+#include "SkRecords.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include "SkTextBlob.h"
+
+using namespace SkRecords;
+
+namespace {
+
+// Field comparisons.  These only need to be exact for things that are equal;
+// anything we're unsure of can compare unequal and just costs some extra damage.
+bool same(const SkPaint& a, const SkPaint& b) { return a == b; }
+bool same(const SkPath& a, const SkPath& b) {
+    return a.getGenerationID() == b.getGenerationID() && a.getFillType() == b.getFillType();
+}
+bool same(const ClipOpAndAA& a, const ClipOpAndAA& b) {
+    return a.op() == b.op() && a.aa() == b.aa();
+}
+bool same(const SkImage* a, const SkImage* b) { return a->uniqueID() == b->uniqueID(); }
+bool same(const SkPicture* a, const SkPicture* b) { return a->uniqueID() == b->uniqueID(); }
+
+template <typename T>
+bool same(const Optional<T>& a, const Optional<T>& b) {
+    const T* pa = a;
+    const T* pb = b;
+    return (!pa && !pb) || (pa && pb && *pa == *pb);
+}
+template <>
+bool same(const Optional<SkPaint>& a, const Optional<SkPaint>& b) {
+    const SkPaint* pa = a;
+    const SkPaint* pb = b;
+    return (!pa && !pb) || (pa && pb && same(*pa, *pb));
+}
+
+template <typename T>
+bool same(const PODArray<T>& a, const PODArray<T>& b, size_t count) {
+    return 0 == memcmp((const T*)a, (const T*)b, count * sizeof(T));
+}
+
+// Op comparisons.  Types we don't list never compare equal.
+template <typename T>
+bool same(const T&, const T&) { return false; }
+
+bool same(const NoOp&, const NoOp&) { return true; }
+bool same(const Save&, const Save&) { return true; }
+bool same(const Restore& a, const Restore& b) { return a.matrix == b.matrix; }
+bool same(const SaveLayer& a, const SaveLayer& b) {
+    return same(a.bounds, b.bounds) && same(a.paint, b.paint)
+        && a.backdrop == b.backdrop && a.saveLayerFlags == b.saveLayerFlags;
+}
+bool same(const SetMatrix& a, const SetMatrix& b) { return a.matrix == b.matrix; }
+bool same(const Concat& a, const Concat& b) { return a.matrix == b.matrix; }
+bool same(const Translate& a, const Translate& b) { return a.dx == b.dx && a.dy == b.dy; }
+bool same(const TranslateZ& a, const TranslateZ& b) { return a.z == b.z; }
+
+bool same(const ClipPath& a, const ClipPath& b) {
+    return same(a.path, b.path) && same(a.opAA, b.opAA);
+}
+bool same(const ClipRRect& a, const ClipRRect& b) {
+    return a.rrect == b.rrect && same(a.opAA, b.opAA);
+}
+bool same(const ClipRect& a, const ClipRect& b) {
+    return a.rect == b.rect && same(a.opAA, b.opAA);
+}
+bool same(const ClipRegion& a, const ClipRegion& b) {
+    return a.region == b.region && a.op == b.op;
+}
+
+bool same(const DrawArc& a, const DrawArc& b) {
+    return same(a.paint, b.paint) && a.oval == b.oval && a.startAngle == b.startAngle
+        && a.sweepAngle == b.sweepAngle && a.useCenter == b.useCenter;
+}
+bool same(const DrawDRRect& a, const DrawDRRect& b) {
+    return same(a.paint, b.paint) && a.outer == b.outer && a.inner == b.inner;
+}
+bool same(const DrawImage& a, const DrawImage& b) {
+    return same(a.paint, b.paint) && same(a.image.get(), b.image.get())
+        && a.left == b.left && a.top == b.top;
+}
+bool same(const DrawImageRect& a, const DrawImageRect& b) {
+    return same(a.paint, b.paint) && same(a.image.get(), b.image.get())
+        && same(a.src, b.src) && a.dst == b.dst && a.constraint == b.constraint;
+}
+bool same(const DrawImageNine& a, const DrawImageNine& b) {
+    return same(a.paint, b.paint) && same(a.image.get(), b.image.get())
+        && a.center == b.center && a.dst == b.dst;
+}
+bool same(const DrawOval& a, const DrawOval& b) {
+    return same(a.paint, b.paint) && a.oval == b.oval;
+}
+bool same(const DrawPaint& a, const DrawPaint& b) { return same(a.paint, b.paint); }
+bool same(const DrawPath& a, const DrawPath& b) {
+    return same(a.paint, b.paint) && same(a.path, b.path);
+}
+bool same(const DrawPicture& a, const DrawPicture& b) {
+    return same(a.paint, b.paint) && same(a.picture.get(), b.picture.get())
+        && a.matrix == b.matrix;
+}
+bool same(const DrawPoints& a, const DrawPoints& b) {
+    return same(a.paint, b.paint) && a.mode == b.mode && a.count == b.count
+        && 0 == memcmp(a.pts, b.pts, a.count * sizeof(SkPoint));
+}
+bool same(const DrawPosText& a, const DrawPosText& b) {
+    return same(a.paint, b.paint) && a.byteLength == b.byteLength
+        && same(a.text, b.text, a.byteLength)
+        && same(a.pos, b.pos, a.paint.countText(a.text, a.byteLength));
+}
+bool same(const DrawPosTextH& a, const DrawPosTextH& b) {
+    return same(a.paint, b.paint) && a.byteLength == b.byteLength && a.y == b.y
+        && same(a.text, b.text, a.byteLength)
+        && same(a.xpos, b.xpos, a.paint.countText(a.text, a.byteLength));
+}
+bool same(const DrawRRect& a, const DrawRRect& b) {
+    return same(a.paint, b.paint) && a.rrect == b.rrect;
+}
+bool same(const DrawRect& a, const DrawRect& b) {
+    return same(a.paint, b.paint) && a.rect == b.rect;
+}
+bool same(const DrawRects& a, const DrawRects& b) {
+    return same(a.paint, b.paint) && a.count == b.count && same(a.rects, b.rects, a.count);
+}
+bool same(const DrawRegion& a, const DrawRegion& b) {
+    return same(a.paint, b.paint) && a.region == b.region;
+}
+bool same(const DrawText& a, const DrawText& b) {
+    return same(a.paint, b.paint) && a.byteLength == b.byteLength && a.x == b.x && a.y == b.y
+        && same(a.text, b.text, a.byteLength);
+}
+bool same(const DrawTextBlob& a, const DrawTextBlob& b) {
+    return same(a.paint, b.paint) && a.blob->uniqueID() == b.blob->uniqueID()
+        && a.x == b.x && a.y == b.y;
+}
+bool same(const DrawVertices& a, const DrawVertices& b) {
+    return same(a.paint, b.paint) && a.vertices == b.vertices && a.bmode == b.bmode;
+}
+
+// Visits the op at index in other, comparing it to the op of the same type we've already got.
+template <typename T>
+struct SameAs {
+    const T& op;
+
+    bool operator()(const T& other) { return same(op, other); }
+    template <typename U>
+    bool operator()(const U&) { return false; }
+};
+
+struct Compare {
+    const SkRecord& other;
+    int index;
+
+    template <typename T>
+    bool operator()(const T& op) { return other.visit(index, SameAs<T>{op}); }
+};
+
+}  // namespace
+
+void SkRecordComputeDamage(const SkRecord& before, const SkRect& beforeCull,
+                           const SkRecord& after,  const SkRect& afterCull,
+                           const SkMatrix& ctm, SkRegion* damage) {
+    SkASSERT(damage);
+
+    const int beforeCount = before.count(),
+              afterCount  = after.count();
+    SkAutoTMalloc<SkRect> beforeBounds(beforeCount),
+                          afterBounds(afterCount);
+    SkRecordFillBounds(beforeCull, before, beforeBounds.get());
+    SkRecordFillBounds(afterCull,  after,  afterBounds.get());
+
+    // An op that matches draws the same thing in the same place.  Comparing bounds
+    // too catches an identical op whose effect moved, e.g. because a matrix before it changed.
+    auto matches = [&](int i, int j) {
+        return beforeBounds[i] == afterBounds[j] && before.visit(i, Compare{after, j});
+    };
+
+    SkTDArray<SkIRect> rects;
+    auto addDamage = [&](const SkRect& bounds) {
+        if (bounds.isEmpty()) {
+            return;
+        }
+        SkRect dev;
+        ctm.mapRect(&dev, bounds);
+        // Outset a pixel for antialiasing and hairlines that spill past their geometry.
+        dev.outset(1, 1);
+        dev.roundOut(rects.append());
+    };
+
+    // Skip the common prefix and suffix.  Small edits usually leave most of a picture alone.
+    const int minCount = SkTMin(beforeCount, afterCount);
+    int prefix = 0;
+    while (prefix < minCount && matches(prefix, prefix)) {
+        prefix++;
+    }
+    int suffix = 0;
+    while (suffix < minCount - prefix &&
+           matches(beforeCount - 1 - suffix, afterCount - 1 - suffix)) {
+        suffix++;
+    }
+
+    const int beforeEnd = beforeCount - suffix,
+              afterEnd  = afterCount  - suffix;
+    if (beforeEnd - prefix == afterEnd - prefix) {
+        // The same number of ops changed in place, so we can pair them up and skip any that match.
+        for (int i = prefix; i < beforeEnd; i++) {
+            if (!matches(i, i)) {
+                addDamage(beforeBounds[i]);
+                addDamage(afterBounds[i]);
+            }
+        }
+    } else {
+        // Ops were added or removed.  Everything in between is damaged.
+        for (int i = prefix; i < beforeEnd; i++) {
+            addDamage(beforeBounds[i]);
+        }
+        for (int i = prefix; i < afterEnd; i++) {
+            addDamage(afterBounds[i]);
+        }
+    }
+
+    damage->setRects(rects.begin(), rects.count());
+}
+
+void SkPictureComputeDamage(const SkPicture* before, const SkPicture* after,
+                            const SkMatrix& ctm, SkRegion* damage) {
+    SkASSERT(before && after && damage);
+
+    const SkBigPicture* bigBefore = before->asSkBigPicture();
+    const SkBigPicture* bigAfter  = after->asSkBigPicture();
+    if (bigBefore && bigAfter) {
+        SkRecordComputeDamage(*bigBefore->record(), before->cullRect(),
+                              *bigAfter->record(),  after->cullRect(),
+                              ctm, damage);
+        return;
+    }
+
+    damage->setEmpty();
+    if (before->uniqueID() != after->uniqueID()) {
+        for (const SkRect& cull : { before->cullRect(), after->cullRect() }) {
+            SkRect dev;
+            ctm.mapRect(&dev, cull);
+            dev.outset(1, 1);
+            damage->op(dev.roundOut(), SkRegion::kUnion_Op);
+        }
+    }
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordDiff_DEFINED
+#define SkRecordDiff_DEFINED
+
+#include "SkMatrix.h"
+#include "SkRecord.h"
+#include "SkRegion.h"
+
+class SkPicture;
+
+// Compute the device-space area where drawing after may differ from drawing before, both drawn
+// with the given matrix onto the same content.  Everything outside damage draws identically, so
+// a caller that re-rasterizes can clipRegion(damage) and play back only the changed areas.
+//
+// Ops are compared one by one: paints by value, paths by generation ID, images, blobs and
+// pictures by identity, along with the bounds SkRecordFillBounds() computes for each op.
+// Any op that differs (or that we can't compare) damages its bounds in both records.
+// The result is conservative: it may be larger than the pixels that really changed.
+void SkRecordComputeDamage(const SkRecord& before, const SkRect& beforeCull,
+                           const SkRecord& after,  const SkRect& afterCull,
+                           const SkMatrix& ctm, SkRegion* damage);
+
+// As above, for two pictures.  Pictures that aren't backed by an SkRecord are compared by
+// unique ID, and damage their entire cull rects if they differ.
+void SkPictureComputeDamage(const SkPicture* before, const SkPicture* after,
+                            const SkMatrix& ctm, SkRegion* damage);
+
+#endif//SkRecordDiff_DEFINED
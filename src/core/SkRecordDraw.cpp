@@ -127,6 +127,17 @@ DRAW(DrawPosText, drawPosText(r.text, r.byteLength, r.pos, r.paint));
 DRAW(DrawPosTextH, drawPosTextH(r.text, r.byteLength, r.xpos, r.y, r.paint));
 DRAW(DrawRRect, drawRRect(r.rrect, r.paint));
 DRAW(DrawRect, drawRect(r.rect, r.paint));
+template <> void Draw::draw(const DrawRects& r) {
+    // One quick reject for the whole run; anything it would reject, drawRect() would too.
+    SkRect storage;
+    if (r.paint.canComputeFastBounds() &&
+        fCanvas->quickReject(r.paint.computeFastBounds(r.bounds, &storage))) {
+        return;
+    }
+    for (int i = 0; i < r.count; i++) {
+        fCanvas->drawRect(r.rects[i], r.paint);
+    }
+}
 DRAW(DrawRegion, drawRegion(r.region, r.paint));
 DRAW(DrawText, drawText(r.text, r.byteLength, r.x, r.y, r.paint));
 DRAW(DrawTextBlob, drawTextBlob(r.blob.get(), r.x, r.y, r.paint));
@@ -405,6 +416,7 @@ private:
     Bounds bounds(const NoOp&)  const { return Bounds::MakeEmpty(); }    // NoOps don't draw.
 
     Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
+    Bounds bounds(const DrawRects& op) const { return this->adjustAndMap(op.bounds, &op.paint); }
     Bounds bounds(const DrawRegion& op) const {
         SkRect rect = SkRect::Make(op.region.getBounds());
         return this->adjustAndMap(rect, &op.paint);
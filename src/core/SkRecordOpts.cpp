@@ -288,6 +288,71 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Not pattern-based: a Greedy run can't end at the end of the record, and we need the paint of each
+// DrawRect in the run anyway.  Runs are capped so that a single DrawRects' bounds stay tight
+// enough for the bounding box hierarchy to be useful.
+void SkRecordCoalesceDrawRects(SkRecord* record) {
+    static const int kMaxRectsPerRun = 64;
+
+    int i = 0;
+    while (i < record->count()) {
+        Is<DrawRect> first;
+        if (!record->mutate(i, first)) {
+            i++;
+            continue;
+        }
+        const SkPaint& paint = first.get()->paint;
+
+        // Find the run of DrawRects (possibly with NoOps between) that share this paint.
+        int count = 1, last = i, j = i + 1;
+        for (; j < record->count() && count < kMaxRectsPerRun; j++) {
+            Is<DrawRect> draw;
+            if (record->mutate(j, draw)) {
+                if (draw.get()->paint != paint) {
+                    break;
+                }
+                count++;
+                last = j;
+            } else if (!record->mutate(j, Is<NoOp>())) {
+                break;
+            }
+        }
+        if (count < 2) {
+            i = j;
+            continue;
+        }
+
+        SkRect* rects = record->alloc<SkRect>(count);
+        SkRect bounds;
+        for (int k = i, n = 0; k <= last; k++) {
+            Is<DrawRect> draw;
+            if (record->mutate(k, draw)) {
+                // Not SkRect::join(), which would skip empty (but possibly stroked) rects.
+                SkRect sorted = draw.get()->rect;
+                sorted.sort();
+                if (n == 0) {
+                    bounds = sorted;
+                } else {
+                    bounds.fLeft   = SkTMin(bounds.fLeft,   sorted.fLeft);
+                    bounds.fTop    = SkTMin(bounds.fTop,    sorted.fTop);
+                    bounds.fRight  = SkTMax(bounds.fRight,  sorted.fRight);
+                    bounds.fBottom = SkTMax(bounds.fBottom, sorted.fBottom);
+                }
+                rects[n++] = draw.get()->rect;
+            }
+        }
+
+        SkPaint runPaint = paint;
+        for (int k = i + 1; k <= last; k++) {
+            record->replace<NoOp>(k);
+        }
+        new (record->replace<DrawRects>(i)) DrawRects{runPaint, bounds, count, rects};
+        i = last + 1;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkRecordOptimize(SkRecord* record) {
     // This might be useful  as a first pass in the future if we want to weed
     // out junk for other optimization passes.  Right now, nothing needs it,
@@ -305,6 +370,7 @@ void SkRecordOptimize(SkRecord* record) {
     SkRecordNoopSaveLayerDrawRestores(record);
 #endif
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+    SkRecordCoalesceDrawRects(record);
 
     record->defrag();
 }
@@ -317,6 +383,7 @@ void SkRecordOptimize2(SkRecord* record) {
     SkRecordNoopSaveLayerDrawRestores(record);
 #endif
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+    SkRecordCoalesceDrawRects(record);
 
     record->defrag();
 }
@@ -26,6 +26,9 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// Merges runs of DrawRect with identical paints (NoOps allowed in between) into single DrawRects.
+void SkRecordCoalesceDrawRects(SkRecord*);
+
 // Experimental optimizers
 void SkRecordOptimize2(SkRecord*);
 
@@ -60,6 +60,13 @@ public:
         return true;
     }
 
+    // The rects in a DrawRects may overlap, so its paint can't stand in for a layer's.
+    bool operator()(DrawRects*) {
+        static_assert(DrawRects::kTags & kDraw_Tag, "");
+        fPaint = nullptr;
+        return true;
+    }
+
     template <typename T>
     SK_WHEN(!(T::kTags & kDraw_Tag), bool) operator()(T* draw) {
         fPaint = nullptr;
@@ -7,6 +7,7 @@
 
 #include "SkStrokerPriv.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
 #include "SkPathPriv.h"
 
 enum {
@@ -1291,6 +1292,7 @@ SkStroke::SkStroke() {
     fCap        = SkPaint::kDefault_Cap;
     fJoin       = SkPaint::kDefault_Join;
     fDoFill     = false;
+    fUsePolylineStroker = true;
 }
 
 SkStroke::SkStroke(const SkPaint& p) {
@@ -1300,6 +1302,7 @@ SkStroke::SkStroke(const SkPaint& p) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fUsePolylineStroker = true;
 }
 
 SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
@@ -1309,6 +1312,7 @@ SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fUsePolylineStroker = true;
 }
 
 void SkStroke::setWidth(SkScalar width) {
@@ -1333,6 +1337,298 @@ void SkStroke::setJoin(SkPaint::Join join) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Sets unitNormal as set_normal_unitnormal() would for the line from before to after, unless
+// SkPathStroker::lineTo() would skip the line, or could not orient it.
+static bool set_line_unit_normal(const SkPoint& before, const SkPoint& after, SkScalar resScale,
+                                 SkScalar teenyTolerance, SkVector* unitNormal) {
+    if (before.equalsWithinTolerance(after, teenyTolerance) ||
+        !unitNormal->setNormalize((after.fX - before.fX) * resScale,
+                                  (after.fY - before.fY) * resScale)) {
+        return false;
+    }
+    unitNormal->rotateCCW();
+    return true;
+}
+
+// Sets the unit normals of the count - 1 lines joining pts, two lines at a time, with the same
+// float operations as set_line_unit_normal(). Returns false as soon as it meets a line that
+// set_line_unit_normal() refuses.
+static bool set_line_unit_normals(const SkPoint pts[], int count, SkScalar resScale,
+                                  SkScalar teenyTolerance, SkVector unitNormals[]) {
+    const Sk4f scale(resScale);
+    const Sk4f teeny(teenyTolerance);
+    const Sk4f nearlyZeroSquared(SK_ScalarNearlyZero * SK_ScalarNearlyZero);
+    const Sk4f infinity(SK_ScalarInfinity);
+    const Sk4f ccw(1, -1, 1, -1);
+
+    int i = 0;
+    for (; i + 2 < count; i += 2) {
+        Sk4f delta = Sk4f::Load(&pts[i + 1]) - Sk4f::Load(&pts[i]);  // dx0 dy0 dx1 dy1
+        Sk4f absDelta = delta.abs();
+        Sk4f longest = Sk4f::Max(absDelta, SkNx_shuffle<1, 0, 3, 2>(absDelta));
+        Sk4f scaled = delta * scale;
+        Sk4f squared = scaled * scaled;
+        Sk4f lengthSquared = squared + SkNx_shuffle<1, 0, 3, 2>(squared);
+        if ((longest > teeny).allTrue() && (lengthSquared > nearlyZeroSquared).allTrue() &&
+            (lengthSquared < infinity).allTrue()) {
+            // Sk4f's sqrt() and division are only estimates on some ARM cores, so take the two
+            // lengths the way setNormalize() does.
+            float lengthsSquared[4];
+            lengthSquared.store(lengthsSquared);
+            const float inverse0 = 1 / sk_float_sqrt(lengthsSquared[0]),
+                        inverse1 = 1 / sk_float_sqrt(lengthsSquared[2]);
+            Sk4f unit = scaled * Sk4f(inverse0, inverse0, inverse1, inverse1);
+            (SkNx_shuffle<1, 0, 3, 2>(unit) * ccw).store(&unitNormals[i]);  // rotateCCW()
+        } else if (!set_line_unit_normal(pts[i], pts[i + 1], resScale, teenyTolerance,
+                                         &unitNormals[i]) ||
+                   !set_line_unit_normal(pts[i + 1], pts[i + 2], resScale, teenyTolerance,
+                                         &unitNormals[i + 1])) {
+            // Either a line to refuse, or lengths that overflow floats, which setNormalize()
+            // works out in doubles.
+            return false;
+        }
+    }
+    for (; i + 1 < count; ++i) {
+        if (!set_line_unit_normal(pts[i], pts[i + 1], resScale, teenyTolerance,
+                                  &unitNormals[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ *  Strokes paths of lines alone, such as long chart polylines, with the outline SkPathStroker
+ *  makes for them. It works out all the normals of a contour before it joins any, and builds
+ *  the outline in SkStrokerPriv::Outlines reserved for the whole path, copying it into the
+ *  result once. Lines that SkPathStroker skips, or orients by looking ahead, are left to it:
+ *  stroke() returns false on meeting one, without touching dst.
+ */
+class SkPolylineStroker {
+public:
+    SkPolylineStroker(SkScalar radius, SkScalar miterLimit, SkPaint::Cap cap, SkPaint::Join join,
+                      SkScalar resScale, bool canIgnoreCenter)
+            : fRadius(radius)
+            , fInvMiterLimit(0)
+            , fResScale(resScale)
+            , fTeenyTolerance(SK_ScalarNearlyZero * SkScalarInvert(resScale * 4))
+            , fIsButt(SkPaint::kButt_Cap == cap)
+            , fRoundJoin(SkPaint::kRound_Join == join)
+            , fCanIgnoreCenter(canIgnoreCenter) {
+        // As SkPathStroker's constructor.
+        if (join == SkPaint::kMiter_Join) {
+            if (miterLimit <= SK_Scalar1) {
+                join = SkPaint::kBevel_Join;
+            } else {
+                fInvMiterLimit = SkScalarInvert(miterLimit);
+            }
+        }
+        fCapper = SkStrokerPriv::OutlineCapFactory(cap);
+        fJoiner = SkStrokerPriv::OutlineJoinFactory(join);
+    }
+
+    bool stroke(const SkPath& src, SkPath* dst);
+
+private:
+    bool strokeContour(const SkPoint pts[], int count, bool close, bool capEndIsLine);
+    void copyTo(SkPath* dst) const;
+
+    SkScalar fRadius;
+    SkScalar fInvMiterLimit;
+    SkScalar fResScale;
+    SkScalar fTeenyTolerance;
+    bool     fIsButt;
+    bool     fRoundJoin;
+    bool     fCanIgnoreCenter;
+
+    SkStrokerPriv::OutlineCapProc  fCapper;
+    SkStrokerPriv::OutlineJoinProc fJoiner;
+
+    SkStrokerPriv::Outline fInner, fOuter;  // as SkPathStroker's
+    SkTDArray<SkVector>    fUnitNormals;    // of the current contour's lines
+};
+
+bool SkPolylineStroker::stroke(const SkPath& src, SkPath* dst) {
+    SkASSERT(SkPath::kLine_SegmentMask == src.getSegmentMasks());
+    if (!src.isFinite()) {
+        return false;
+    }
+
+    // Each point starts a line on either side, and a join whose inside goes through the point.
+    // The inside is then reversed onto the outline; round joins add a conic or two outside.
+    const int count = src.countPoints();
+    fInner.reserve(3 * count, 3 * count);
+    fOuter.reserve(6 * count, (fRoundJoin ? 8 : 6) * count);
+    fUnitNormals.setReserve(count);
+
+    // Walks the verbs as SkPath::Iter(src, false) would, giving up on what it cannot make.
+    const SkPathRef& ref = *src.fPathRef;
+    const SkPoint* pts = ref.points();
+    const int verbCount = ref.countVerbs();
+    int contourStart = -1;
+    int ptIndex = 0;
+    for (int i = 0; i < verbCount; ++i) {
+        switch (ref.atVerb(i)) {
+            case SkPath::kMove_Verb:
+                if (i == verbCount - 1) {
+                    break;  // the iterator skips a trailing moveTo
+                }
+                if (contourStart >= 0 && !this->strokeContour(&pts[contourStart],
+                                                              ptIndex - contourStart,
+                                                              false, false)) {
+                    return false;
+                }
+                contourStart = ptIndex++;
+                break;
+            case SkPath::kLine_Verb:
+                if (contourStart < 0) {
+                    return false;
+                }
+                ++ptIndex;
+                break;
+            case SkPath::kClose_Verb:
+                if (contourStart < 0 || !this->strokeContour(&pts[contourStart],
+                                                             ptIndex - contourStart,
+                                                             true, true)) {
+                    return false;
+                }
+                contourStart = -1;
+                break;
+            default:
+                return false;
+        }
+    }
+    if (contourStart >= 0 && !this->strokeContour(&pts[contourStart], ptIndex - contourStart,
+                                                  false, true)) {
+        return false;
+    }
+    this->copyTo(dst);
+    return true;
+}
+
+// Does what SkPathStroker's moveTo(), lineTo()s and finishContour() do for these points.
+// capEndIsLine is what finishContour() is passed when the contour is not closed.
+bool SkPolylineStroker::strokeContour(const SkPoint pts[], int count, bool close,
+                                      bool capEndIsLine) {
+    // SkPath::Iter closes a contour with a line back to its start.
+    const bool closingLine = close && pts[count - 1] != pts[0];
+    const int lines = count - 1 + closingLine;
+    if (0 == lines) {
+        // Square and round caps mark a closed contour of one point, as a line of no length.
+        return !close || fIsButt;
+    }
+    fUnitNormals.setCount(lines);
+    SkVector* unitNormals = fUnitNormals.begin();
+    if (!set_line_unit_normals(pts, count, fResScale, fTeenyTolerance, unitNormals)) {
+        return false;
+    }
+    if (closingLine) {
+        const SkPoint closing[] = { pts[count - 1], pts[0] };
+        if (!set_line_unit_normals(closing, 2, fResScale, fTeenyTolerance,
+                                   &unitNormals[count - 1])) {
+            return false;
+        }
+    }
+
+    SkVector normal;
+    unitNormals[0].scale(fRadius, &normal);
+    const SkVector firstNormal = normal;
+    const SkPoint firstOuterPt = SkPoint::Make(pts[0].fX + normal.fX, pts[0].fY + normal.fY);
+    fOuter.moveTo(firstOuterPt);
+    fInner.moveTo(pts[0].fX - normal.fX, pts[0].fY - normal.fY);
+    for (int i = 0; i < lines; ++i) {
+        if (i > 0) {
+            unitNormals[i].scale(fRadius, &normal);
+            fJoiner(&fOuter, &fInner, unitNormals[i - 1], pts[i], unitNormals[i],
+                    fRadius, fInvMiterLimit, true, true);
+        }
+        const SkPoint& end = i + 1 < count ? pts[i + 1] : pts[0];
+        fOuter.lineTo(end.fX + normal.fX, end.fY + normal.fY);
+        fInner.lineTo(end.fX - normal.fX, end.fY - normal.fY);
+    }
+
+    const SkPoint& lastPt = closingLine ? pts[0] : pts[count - 1];
+    if (close) {
+        fJoiner(&fOuter, &fInner, unitNormals[lines - 1], lastPt, unitNormals[0],
+                fRadius, fInvMiterLimit, true, true);
+        fOuter.close();
+        if (fCanIgnoreCenter) {
+            if (!fOuter.computeBounds().contains(fInner.computeBounds())) {
+                SkASSERT(fInner.computeBounds().contains(fOuter.computeBounds()));
+                fInner.swap(fOuter);
+            }
+        } else {
+            fOuter.moveTo(fInner.lastPt());
+            fOuter.reversePathTo(fInner);
+            fOuter.close();
+        }
+    } else {
+        fCapper(&fOuter, lastPt, normal, fInner.lastPt(), capEndIsLine ? &fInner : nullptr);
+        fOuter.reversePathTo(fInner);
+        fCapper(&fOuter, pts[0], -firstNormal, firstOuterPt, &fInner);
+        fOuter.close();
+    }
+    fInner.rewind();
+    return true;
+}
+
+// dst is empty. Copies the outline into it with one editor, lines a run at a time, and keeps
+// SkPath's own record of its last moveTo as SkPath's append methods would.
+void SkPolylineStroker::copyTo(SkPath* dst) const {
+    SkASSERT(dst->isEmpty());
+    const uint8_t* verbs = fOuter.verbs();
+    const SkPoint* pts = fOuter.points();
+    const SkScalar* conicWeights = fOuter.conicWeights();
+    const int verbCount = fOuter.countVerbs();
+    int lastMoveToIndex = dst->fLastMoveToIndex;
+
+    SkPathRef::Editor ed(&dst->fPathRef, verbCount, fOuter.countPoints());
+    for (int i = 0; i < verbCount;) {
+        switch (verbs[i]) {
+            case SkPath::kMove_Verb:
+                lastMoveToIndex = SkToInt(pts - fOuter.points());
+                *ed.growForVerb(SkPath::kMove_Verb) = *pts++;
+                i += 1;
+                break;
+            case SkPath::kLine_Verb: {
+                int run = 1;
+                while (i + run < verbCount && SkPath::kLine_Verb == verbs[i + run]) {
+                    ++run;
+                }
+                memcpy(ed.growForRepeatedVerb(SkPath::kLine_Verb, run), pts,
+                       run * sizeof(SkPoint));
+                pts += run;
+                i += run;
+                break;
+            }
+            case SkPath::kQuad_Verb:
+                memcpy(ed.growForVerb(SkPath::kQuad_Verb), pts, 2 * sizeof(SkPoint));
+                pts += 2;
+                i += 1;
+                break;
+            case SkPath::kConic_Verb:
+                memcpy(ed.growForVerb(SkPath::kConic_Verb, *conicWeights++), pts,
+                       2 * sizeof(SkPoint));
+                pts += 2;
+                i += 1;
+                break;
+            case SkPath::kClose_Verb:
+                ed.growForVerb(SkPath::kClose_Verb);
+                lastMoveToIndex ^= ~lastMoveToIndex >> (8 * sizeof(lastMoveToIndex) - 1);
+                i += 1;
+                break;
+            default:
+                SkDEBUGFAIL("unexpected verb");
+                i += 1;
+                break;
+        }
+    }
+    dst->fLastMoveToIndex = lastMoveToIndex;
+    dst->setIsVolatile(true);  // as SkPathStroker's outline, which it swaps into dst
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 // If src==dst, then we use a tmp path to record the stroke, and then swap
 // its contents with src when we're done.
 class AutoTmpPath {
@@ -1359,40 +1655,10 @@ private:
     bool            fSwapWithSrc;
 };
 
-void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
-    SkASSERT(dst);
-
-    SkScalar radius = SkScalarHalf(fWidth);
-
-    AutoTmpPath tmp(src, &dst);
-
-    if (radius <= 0) {
-        return;
-    }
-
-    // If src is really a rect, call our specialty strokeRect() method
-    {
-        SkRect rect;
-        bool isClosed;
-        SkPath::Direction dir;
-        if (src.isRect(&rect, &isClosed, &dir) && isClosed) {
-            this->strokeRect(rect, dst, dir);
-            // our answer should preserve the inverseness of the src
-            if (src.isInverseFillType()) {
-                SkASSERT(!dst->isInverseFillType());
-                dst->toggleInverseFillType();
-            }
-            return;
-        }
-    }
-
-    // We can always ignore centers for stroke and fill convex line-only paths
-    // TODO: remove the line-only restriction
-    bool ignoreCenter = fDoFill && (src.getSegmentMasks() == SkPath::kLine_SegmentMask) && 
-                        src.isLastContourClosed() && src.isConvex();
-
-    SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(), this->getJoin(),
-                            fResScale, ignoreCenter);
+static void stroke_segments(const SkPath& src, SkScalar radius, SkScalar miterLimit,
+                            SkPaint::Cap cap, SkPaint::Join join, SkScalar resScale,
+                            bool ignoreCenter, SkPath* dst) {
+    SkPathStroker   stroker(src, radius, miterLimit, cap, join, resScale, ignoreCenter);
     SkPath::Iter    iter(src, false);
     SkPath::Verb    lastSegment = SkPath::kMove_Verb;
 
@@ -1420,7 +1686,7 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
                 lastSegment = SkPath::kCubic_Verb;
                 break;
             case SkPath::kClose_Verb:
-                if (SkPaint::kButt_Cap != this->getCap()) {
+                if (SkPaint::kButt_Cap != cap) {
                     /* If the stroke consists of a moveTo followed by a close, treat it
                        as if it were followed by a zero-length line. Lines without length
                        can have square and round end caps. */
@@ -1445,6 +1711,47 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     }
 DONE:
     stroker.done(dst, lastSegment == SkPath::kLine_Verb);
+}
+
+void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
+    SkASSERT(dst);
+
+    SkScalar radius = SkScalarHalf(fWidth);
+
+    AutoTmpPath tmp(src, &dst);
+
+    if (radius <= 0) {
+        return;
+    }
+
+    // If src is really a rect, call our specialty strokeRect() method
+    {
+        SkRect rect;
+        bool isClosed;
+        SkPath::Direction dir;
+        if (src.isRect(&rect, &isClosed, &dir) && isClosed) {
+            this->strokeRect(rect, dst, dir);
+            // our answer should preserve the inverseness of the src
+            if (src.isInverseFillType()) {
+                SkASSERT(!dst->isInverseFillType());
+                dst->toggleInverseFillType();
+            }
+            return;
+        }
+    }
+
+    // We can always ignore centers for stroke and fill convex line-only paths
+    // TODO: remove the line-only restriction
+    bool lineOnly = src.getSegmentMasks() == SkPath::kLine_SegmentMask;
+    bool polyline = lineOnly && fUsePolylineStroker;
+    bool ignoreCenter = fDoFill && lineOnly && src.isLastContourClosed() && src.isConvex();
+
+    SkPolylineStroker polylineStroker(radius, fMiterLimit, this->getCap(), this->getJoin(),
+                                      fResScale, ignoreCenter);
+    if (!polyline || !polylineStroker.stroke(src, dst)) {
+        stroke_segments(src, radius, fMiterLimit, this->getCap(), this->getJoin(), fResScale,
+                        ignoreCenter, dst);
+    }
 
     if (fDoFill && !ignoreCenter) {
         if (SkPathPriv::CheapIsFirstDirection(src, SkPathPriv::kCCW_FirstDirection)) {
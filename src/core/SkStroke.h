@@ -67,12 +67,18 @@ public:
     ////////////////////////////////////////////////////////////////
 
 private:
+    // Whether strokePath() strokes paths of lines alone with a stroker made for them, rather
+    // than the general one. Tests and benches turn it off to compare the two.
+    void setUsePolylineStroker(bool use) { fUsePolylineStroker = SkToU8(use); }
+
     SkScalar    fWidth, fMiterLimit;
     SkScalar    fResScale;
     uint8_t     fCap, fJoin;
     SkBool8     fDoFill;
+    SkBool8     fUsePolylineStroker;
 
     friend class SkPaint;
+    friend class StrokeTester;  // for unit testing and benchmarking
 };
 
 #endif
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+
+#include "SkMutex.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Below this many points, a path strokes in about the time it takes to find its outline.
+static const int kMinCachedPoints = 64;
+
+// How many outlines built once, and not kept, are remembered. Enough for the plots of a few
+// charts redrawn together.
+static const int kMaxSeenStrokes = 64;
+
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(const SkPath& path, const SkStrokeRec& rec)
+        : fGenID(path.getGenerationID())
+        , fPointCount(path.countPoints())
+        , fWidth(rec.getWidth())
+        // Only miter joins look at the limit, so other joins share their outlines whatever it is.
+        , fMiterLimit(SkPaint::kMiter_Join == rec.getJoin() ? rec.getMiter() : 0)
+        , fResScale(rec.getResScale())
+        , fParams(rec.getCap() | rec.getJoin() << 2 |
+                  (SkStrokeRec::kStrokeAndFill_Style == rec.getStyle()) << 4 |
+                  path.isInverseFillType() << 5) {
+        static_assert(sizeof(StrokeKey) == sizeof(SkResourceCache::Key) + kFieldBytes,
+                      "stroke_key_tight_packing");
+        this->init(&gStrokeKeyNamespaceLabel, 0, kFieldBytes);
+    }
+
+    static const size_t kFieldBytes = 2 * sizeof(uint32_t) + sizeof(int32_t) +
+                                      3 * sizeof(SkScalar);
+
+    uint32_t fGenID;
+    int32_t  fPointCount;  // should genIDs come round again
+    SkScalar fWidth;
+    SkScalar fMiterLimit;
+    SkScalar fResScale;
+    uint32_t fParams;  // cap, join, whether to fill too, and whether the fill is inverse
+};
+
+struct StrokeRec : public SkResourceCache::Rec {
+    StrokeRec(const StrokeKey& key, const SkPath& stroke)
+        : fKey(key)
+        , fStroke(stroke) {
+        // Copies of the outline may be read from several threads.
+        fStroke.updateBoundsCache();
+    }
+
+    StrokeKey fKey;
+    SkPath    fStroke;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fStroke.countPoints() * sizeof(SkPoint) + fStroke.countVerbs();
+    }
+    const char* getCategory() const override { return "stroke"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const StrokeRec& rec = static_cast<const StrokeRec&>(baseRec);
+        *static_cast<SkPath*>(contextData) = rec.fStroke;
+        return true;
+    }
+};
+SK_DECLARE_STATIC_MUTEX(gSeenMutex);
+static uint32_t gSeenHashes[kMaxSeenStrokes];
+static int      gSeenCount;
+static int      gNextSeen;  // the oldest, replaced when all are in use
+
+// Returns whether key was built before; if not, remembers it. Hashes are compared rather than
+// whole keys: should two collide, an outline is kept after one build instead of two.
+static bool seen_before(const StrokeKey& key) {
+    SkAutoMutexAcquire lock(gSeenMutex);
+    for (int i = 0; i < gSeenCount; ++i) {
+        if (gSeenHashes[i] == key.hash()) {
+            return true;
+        }
+    }
+    gSeenHashes[gNextSeen] = key.hash();
+    gNextSeen = (gNextSeen + 1) % kMaxSeenStrokes;
+    if (gSeenCount < kMaxSeenStrokes) {
+        ++gSeenCount;
+    }
+    return false;
+}
+} // namespace
+
+bool SkStrokeCache::ShouldCache(const SkPath& path) {
+    return !path.isVolatile() && path.countPoints() >= kMinCachedPoints;
+}
+
+bool SkStrokeCache::Find(const SkPath& path, const SkStrokeRec& rec, SkPath* stroke,
+                         SkResourceCache* localCache) {
+    StrokeKey key(path, rec);
+    return CHECK_LOCAL(localCache, find, Find, key, StrokeRec::Visitor, stroke);
+}
+
+void SkStrokeCache::Add(const SkPath& path, const SkStrokeRec& rec, const SkPath& stroke,
+                        SkResourceCache* localCache) {
+    StrokeKey key(path, rec);
+    if (!seen_before(key)) {
+        return;
+    }
+    return CHECK_LOCAL(localCache, add, Add, new StrokeRec(key, stroke));
+}
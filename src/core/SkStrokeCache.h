@@ -0,0 +1,52 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "SkStrokeRec.h"
+
+/**
+ *  Stroked outlines of paths, kept in SkResourceCache by the source path's genID and the stroke
+ *  parameters, so that a path stroked again and again, like a chart redrawn each frame while
+ *  its data stays put, is stroked once.
+ *
+ *  A path's genID changes with its points, so outlines of a path since edited or deleted are
+ *  never found again, and age out of the cache. Outlines are only kept once a path has been
+ *  stroked twice, so that paths that change every frame, like a scrolling chart's, do not push
+ *  out what other caches hold.
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  Returns whether strokes of path are worth keeping. Volatile paths are not: they are not
+     *  drawn again. Short ones neither, which stroke about as fast as the cache finds them.
+     */
+    static bool ShouldCache(const SkPath& path);
+
+    /**
+     *  Returns true, and sets stroke, if the cache holds the outline of path stroked with rec.
+     *
+     *  stroke then shares its SkPathRef with the cache, as a copy of a path would, so the first
+     *  edit gives it one of its own. Transforming it in place, as SkDraw does on the way to
+     *  device space, maps the points straight into that new one: a hit costs an allocation and
+     *  a copy of the verbs, not a copy of the whole outline before the transform.
+     */
+    static bool Find(const SkPath& path, const SkStrokeRec& rec, SkPath* stroke,
+                     SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Adds stroke as the outline of path stroked with rec, if it was built before. The first
+     *  time, it is only remembered as built.
+     */
+    static void Add(const SkPath& path, const SkStrokeRec& rec, const SkPath& stroke,
+                    SkResourceCache* localCache = nullptr);
+};
+
+#endif
@@ -9,13 +9,15 @@
 #include "SkGeometry.h"
 #include "SkPath.h"
 
-static void ButtCapper(SkPath* path, const SkPoint& pivot, const SkVector& normal,
-                       const SkPoint& stop, SkPath*) {
+template <typename Path>
+static void ButtCapper(Path* path, const SkPoint& pivot, const SkVector& normal,
+                       const SkPoint& stop, Path*) {
     path->lineTo(stop.fX, stop.fY);
 }
 
-static void RoundCapper(SkPath* path, const SkPoint& pivot, const SkVector& normal,
-                        const SkPoint& stop, SkPath*) {
+template <typename Path>
+static void RoundCapper(Path* path, const SkPoint& pivot, const SkVector& normal,
+                        const SkPoint& stop, Path*) {
     SkVector parallel;
     normal.rotateCW(&parallel);
 
@@ -25,8 +27,9 @@ static void RoundCapper(SkPath* path, const SkPoint& pivot, const SkVector& norm
     path->conicTo(projectedCenter - normal, stop, SK_ScalarRoot2Over2);
 }
 
-static void SquareCapper(SkPath* path, const SkPoint& pivot, const SkVector& normal,
-                         const SkPoint& stop, SkPath* otherPath) {
+template <typename Path>
+static void SquareCapper(Path* path, const SkPoint& pivot, const SkVector& normal,
+                         const SkPoint& stop, Path* otherPath) {
     SkVector parallel;
     normal.rotateCW(&parallel);
 
@@ -64,7 +67,8 @@ static AngleType Dot2AngleType(SkScalar dot) {
     }
 }
 
-static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector& after) {
+template <typename Path>
+static void HandleInnerJoin(Path* inner, const SkPoint& pivot, const SkVector& after) {
 #if 1
     /*  In the degenerate case that the stroke radius is larger than our segments
         just connecting the two inner segments may "show through" as a funny
@@ -78,14 +82,15 @@ static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector&
     inner->lineTo(pivot.fX - after.fX, pivot.fY - after.fY);
 }
 
-static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void BluntJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool) {
     SkVector    after;
     afterUnitNormal.scale(radius, &after);
 
     if (!is_clockwise(beforeUnitNormal, afterUnitNormal)) {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Path*>(outer, inner);
         after.negate();
     }
 
@@ -93,7 +98,8 @@ static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     HandleInnerJoin(inner, pivot, after);
 }
 
-static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void RoundJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool) {
     SkScalar    dotProd = SkPoint::DotProduct(beforeUnitNormal, afterUnitNormal);
@@ -107,7 +113,7 @@ static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     SkRotationDirection dir = kCW_SkRotationDirection;
 
     if (!is_clockwise(before, after)) {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Path*>(outer, inner);
         before.negate();
         after.negate();
         dir = kCCW_SkRotationDirection;
@@ -129,7 +135,8 @@ static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
 #define kOneOverSqrt2   (0.707106781f)
 
-static void MiterJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void MiterJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit,
                         bool prevIsLine, bool currIsLine) {
@@ -152,7 +159,7 @@ static void MiterJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
     ccw = !is_clockwise(before, after);
     if (ccw) {
-        SkTSwap<SkPath*>(outer, inner);
+        SkTSwap<Path*>(outer, inner);
         before.negate();
         after.negate();
     }
@@ -212,7 +219,7 @@ DO_BLUNT:
 
 SkStrokerPriv::CapProc SkStrokerPriv::CapFactory(SkPaint::Cap cap) {
     const SkStrokerPriv::CapProc gCappers[] = {
-        ButtCapper, RoundCapper, SquareCapper
+        ButtCapper<SkPath>, RoundCapper<SkPath>, SquareCapper<SkPath>
     };
 
     SkASSERT((unsigned)cap < SkPaint::kCapCount);
@@ -221,9 +228,98 @@ SkStrokerPriv::CapProc SkStrokerPriv::CapFactory(SkPaint::Cap cap) {
 
 SkStrokerPriv::JoinProc SkStrokerPriv::JoinFactory(SkPaint::Join join) {
     const SkStrokerPriv::JoinProc gJoiners[] = {
-        MiterJoiner, RoundJoiner, BluntJoiner
+        MiterJoiner<SkPath>, RoundJoiner<SkPath>, BluntJoiner<SkPath>
     };
 
     SkASSERT((unsigned)join < SkPaint::kJoinCount);
     return gJoiners[join];
 }
+
+SkStrokerPriv::OutlineCapProc SkStrokerPriv::OutlineCapFactory(SkPaint::Cap cap) {
+    const SkStrokerPriv::OutlineCapProc gCappers[] = {
+        ButtCapper<Outline>, RoundCapper<Outline>, SquareCapper<Outline>
+    };
+
+    SkASSERT((unsigned)cap < SkPaint::kCapCount);
+    return gCappers[cap];
+}
+
+SkStrokerPriv::OutlineJoinProc SkStrokerPriv::OutlineJoinFactory(SkPaint::Join join) {
+    const SkStrokerPriv::OutlineJoinProc gJoiners[] = {
+        MiterJoiner<Outline>, RoundJoiner<Outline>, BluntJoiner<Outline>
+    };
+
+    SkASSERT((unsigned)join < SkPaint::kJoinCount);
+    return gJoiners[join];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+SkRect SkStrokerPriv::Outline::computeBounds() const {
+    // As SkPathRef computes its bounds, so that containment tests agree with SkPath's.
+    SkRect bounds;
+    bounds.setBoundsCheck(fPts.begin(), fPts.count());
+    return bounds;
+}
+
+void SkStrokerPriv::Outline::conicTo(const SkPoint& pt1, const SkPoint& pt2, SkScalar weight) {
+    // Mirrors SkPath::conicTo(), which drops to lines or a quad for some weights.
+    if (!(weight > 0)) {
+        this->lineTo(pt2);
+    } else if (!SkScalarIsFinite(weight)) {
+        this->lineTo(pt1);
+        this->lineTo(pt2);
+    } else {
+        SkASSERT(fPts.count() > 0);
+        if (SK_Scalar1 == weight) {
+            *fVerbs.append() = SkPath::kQuad_Verb;
+        } else {
+            *fVerbs.append() = SkPath::kConic_Verb;
+            *fConicWeights.append() = weight;
+        }
+        SkPoint* pts = fPts.append(2);
+        pts[0] = pt1;
+        pts[1] = pt2;
+    }
+}
+
+void SkStrokerPriv::Outline::close() {
+    if (fVerbs.count() > 0 && SkPath::kClose_Verb != fVerbs.top()) {
+        *fVerbs.append() = SkPath::kClose_Verb;
+    }
+}
+
+// As SkPath::reversePathTo(): appends the last contour of that backwards, without its moveTo.
+void SkStrokerPriv::Outline::reversePathTo(const Outline& that) {
+    if (0 == that.fVerbs.count()) {
+        return;
+    }
+    const uint8_t* verbs = that.fVerbs.begin();
+    const uint8_t* verb = that.fVerbs.end();
+    const SkPoint* pts = that.fPts.end() - 1;
+    const SkScalar* conicWeights = that.fConicWeights.end();
+    while (verb > verbs) {
+        switch (*--verb) {
+            case SkPath::kMove_Verb:
+                return;
+            case SkPath::kLine_Verb:
+                pts -= 1;
+                this->lineTo(pts[0]);
+                break;
+            case SkPath::kQuad_Verb:
+                pts -= 2;
+                this->conicTo(pts[1], pts[0], SK_Scalar1);
+                break;
+            case SkPath::kConic_Verb:
+                pts -= 2;
+                this->conicTo(pts[1], pts[0], *--conicWeights);
+                break;
+            case SkPath::kClose_Verb:
+                SkASSERT(verb == that.fVerbs.end() - 1);
+                break;
+            default:
+                SkDEBUGFAIL("bad verb");
+                break;
+        }
+    }
+}
@@ -10,6 +10,7 @@
 #define SkStrokerPriv_DEFINED
 
 #include "SkStroke.h"
+#include "SkTDArray.h"
 
 #define CWX(x, y)   (-y)
 #define CWY(x, y)   (x)
@@ -35,6 +36,78 @@ public:
 
     static CapProc  CapFactory(SkPaint::Cap);
     static JoinProc JoinFactory(SkPaint::Join);
+
+    /**
+     *  Points and verbs appended just as SkPath appends them, but without an SkPathRef::Editor
+     *  for each append. The polyline stroker builds its outline in these, and copies it into
+     *  an SkPath once, when it is done.
+     */
+    class Outline {
+    public:
+        void reserve(int verbs, int points) {
+            fVerbs.setReserve(fVerbs.count() + verbs);
+            fPts.setReserve(fPts.count() + points);
+        }
+        void rewind() {
+            fVerbs.rewind();
+            fPts.rewind();
+            fConicWeights.rewind();
+        }
+        void swap(Outline& that) {
+            fVerbs.swap(that.fVerbs);
+            fPts.swap(that.fPts);
+            fConicWeights.swap(that.fConicWeights);
+        }
+
+        int countVerbs() const { return fVerbs.count(); }
+        int countPoints() const { return fPts.count(); }
+        const uint8_t* verbs() const { return fVerbs.begin(); }
+        const SkPoint* points() const { return fPts.begin(); }
+        const SkScalar* conicWeights() const { return fConicWeights.begin(); }
+        SkPoint lastPt() const { return fPts.top(); }
+        SkRect computeBounds() const;
+
+        void moveTo(SkScalar x, SkScalar y) {
+            *fVerbs.append() = SkPath::kMove_Verb;
+            fPts.append()->set(x, y);
+        }
+        void moveTo(const SkPoint& pt) { this->moveTo(pt.fX, pt.fY); }
+        void lineTo(SkScalar x, SkScalar y) {
+            SkASSERT(fPts.count() > 0);
+            *fVerbs.append() = SkPath::kLine_Verb;
+            fPts.append()->set(x, y);
+        }
+        void lineTo(const SkPoint& pt) { this->lineTo(pt.fX, pt.fY); }
+        void conicTo(const SkPoint& pt1, const SkPoint& pt2, SkScalar weight);
+        void setLastPt(SkScalar x, SkScalar y) {
+            SkASSERT(fPts.count() > 0);
+            fPts[fPts.count() - 1].set(x, y);
+        }
+        void close();
+        void reversePathTo(const Outline&);
+
+    private:
+        SkTDArray<uint8_t>  fVerbs;
+        SkTDArray<SkPoint>  fPts;
+        SkTDArray<SkScalar> fConicWeights;
+    };
+
+    typedef void (*OutlineCapProc)(Outline* path,
+                                   const SkPoint& pivot,
+                                   const SkVector& normal,
+                                   const SkPoint& stop,
+                                   Outline* otherPath);
+
+    typedef void (*OutlineJoinProc)(Outline* outer, Outline* inner,
+                                    const SkVector& beforeUnitNormal,
+                                    const SkPoint& pivot,
+                                    const SkVector& afterUnitNormal,
+                                    SkScalar radius, SkScalar invMiterLimit,
+                                    bool prevIsLine, bool currIsLine);
+
+    // The same cappers and joiners, appending to Outlines.
+    static OutlineCapProc  OutlineCapFactory(SkPaint::Cap);
+    static OutlineJoinProc OutlineJoinFactory(SkPaint::Join);
 };
 
 #endif
@@ -9,9 +9,11 @@
 #include "SkBitmap.h"
 #include "SkData.h"
 #include "SkDeduper.h"
+#include "SkExecutor.h"
 #include "SkPixelRef.h"
 #include "SkPtrRecorder.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 #include "SkTypeface.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -175,12 +177,16 @@ void SkBinaryWriteBuffer::writeImage(const SkImage* image) {
         return;
     }
 
+    sk_sp<SkData> encoded(image->encode(this->getPixelSerializer()));
+    this->writeEncodedImage(image, encoded.get());
+}
+
+void SkBinaryWriteBuffer::writeEncodedImage(const SkImage* image, SkData* encoded) {
     this->writeInt(image->width());
     this->writeInt(image->height());
 
-    sk_sp<SkData> encoded(image->encode(this->getPixelSerializer()));
     if (encoded && encoded->size() > 0) {
-        write_encoded_bitmap(this, encoded.get(), SkIPoint::Make(0, 0));
+        write_encoded_bitmap(this, encoded, SkIPoint::Make(0, 0));
         return;
     }
 
@@ -194,6 +200,38 @@ void SkBinaryWriteBuffer::writeImage(const SkImage* image) {
     this->writeUInt(0); // signal no pixels (in place of the size of the encoded data)
 }
 
+void SkBinaryWriteBuffer::writePaths(const SkPath paths[], int count, SkExecutor* executor) {
+    if (!executor || count < 2) {
+        this->INHERITED::writePaths(paths, count, executor);
+        return;
+    }
+    SkAutoTMalloc<size_t> offsets(count + 1);
+    offsets[0] = 0;
+    for (int i = 0; i < count; ++i) {
+        offsets[i + 1] = offsets[i] + paths[i].writeToMemory(nullptr);
+    }
+    char* dst = (char*)fWriter.reserve(offsets[count]);
+    SkTaskGroup(*executor).batch(count, [&](int i) {
+        SkAssertResult(paths[i].writeToMemory(dst + offsets[i]) == offsets[i + 1] - offsets[i]);
+    });
+}
+
+void SkBinaryWriteBuffer::writeImages(const SkImage* const images[], int count,
+                                      SkExecutor* executor) {
+    if (!executor || count < 2 || fDeduper) {
+        this->INHERITED::writeImages(images, count, executor);
+        return;
+    }
+    SkAutoTArray<sk_sp<SkData>> encoded(count);
+    SkPixelSerializer* serializer = this->getPixelSerializer();
+    SkTaskGroup(*executor).batch(count, [&](int i) {
+        encoded[i].reset(images[i]->encode(serializer));
+    });
+    for (int i = 0; i < count; ++i) {
+        this->writeEncodedImage(images[i], encoded[i].get());
+    }
+}
+
 void SkBinaryWriteBuffer::writeTypeface(SkTypeface* obj) {
     if (fDeduper) {
         this->write32(fDeduper->findOrDefineTypeface(obj));
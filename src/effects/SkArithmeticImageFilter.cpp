@@ -41,6 +41,7 @@ public:
 protected:
     sk_sp<SkSpecialImage> onFilterImage(SkSpecialImage* source, const Context&,
                                         SkIPoint* offset) const override;
+    bool onCanFilterInTiles() const override { return true; }
 
 #if SK_SUPPORT_GPU
     sk_sp<SkSpecialImage> filterImageGPU(SkSpecialImage* source,
@@ -141,11 +142,15 @@ static bool intersect(SkPixmap* dst, SkPixmap* src, int srcDx, int srcDy) {
 sk_sp<SkSpecialImage> ArithmeticImageFilterImpl::onFilterImage(SkSpecialImage* source,
                                                                const Context& ctx,
                                                                SkIPoint* offset) const {
-    SkIPoint backgroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> background(this->filterInput(0, source, ctx, &backgroundOffset));
-
-    SkIPoint foregroundOffset = SkIPoint::Make(0, 0);
-    sk_sp<SkSpecialImage> foreground(this->filterInput(1, source, ctx, &foregroundOffset));
+    SkASSERT(2 == this->countInputs());
+    sk_sp<SkSpecialImage> inputs[2];
+    SkIPoint inputOffsets[2];
+    this->filterInputs(source, ctx, inputs, inputOffsets);
+
+    sk_sp<SkSpecialImage> background(std::move(inputs[0]));
+    SkIPoint backgroundOffset = inputOffsets[0];
+    sk_sp<SkSpecialImage> foreground(std::move(inputs[1]));
+    SkIPoint foregroundOffset = inputOffsets[1];
 
     SkIRect foregroundBounds = SkIRect::EmptyIRect();
     if (foreground) {
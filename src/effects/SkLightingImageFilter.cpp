@@ -8,6 +8,8 @@
 #include "SkLightingImageFilter.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkImageFilterPriv.h"
+#include "SkNx.h"
 #include "SkPoint3.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
@@ -77,6 +79,74 @@ static inline void fast_normalize(SkPoint3* vector) {
     vector->fZ *= scale;
 }
 
+// The estimate sk_float_rsqrt() makes, in each lane.  Sk4f makes the same one itself where it has
+// SSE or NEON; without them its rsqrt() is exact, so call the scalar one lane by lane.
+static inline Sk4f rsqrt4(const Sk4f& x) {
+#if !defined(SKNX_NO_SIMD) && \
+    (SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2 || defined(SK_ARM_HAS_NEON))
+    return x.rsqrt();
+#else
+    float lanes[4];
+    x.store(lanes);
+    for (float& lane : lanes) {
+        lane = sk_float_rsqrt(lane);
+    }
+    return Sk4f::Load(lanes);
+#endif
+}
+
+// SkScalarClampMax(x, 1) in each lane, NaN included: that comes out 1, which Sk4f::Min() only
+// promises on SSE.
+static inline Sk4f clamp_max_one(const Sk4f& x) {
+    return Sk4f::Max((x < 1.0f).thenElse(x, 1.0f), 0.0f);
+}
+
+// Four SkPoint3s, one per lane, for lighting four neighboring pixels at once.  The math follows
+// the SkPoint3 versions operation for operation, so a pixel lights the same either way.
+struct Point3x4 {
+    Sk4f fX, fY, fZ;
+
+    static Point3x4 Splat(const SkPoint3& p) { return { Sk4f(p.fX), Sk4f(p.fY), Sk4f(p.fZ) }; }
+
+    Sk4f dot(const Point3x4& o) const { return fX * o.fX + fY * o.fY + fZ * o.fZ; }
+    Point3x4 makeScale(const Sk4f& scale) const { return { fX * scale, fY * scale, fZ * scale }; }
+
+    void fastNormalize() {
+        Sk4f scale = rsqrt4(this->dot(*this) + SK_ScalarNearlyZero);
+        fX = fX * scale;
+        fY = fY * scale;
+        fZ = fZ * scale;
+    }
+};
+
+// There is no vector pow(), so raise each lane in turn.
+static inline Sk4f pow4(const Sk4f& x, SkScalar exponent) {
+    float lanes[4];
+    x.store(lanes);
+    for (float& lane : lanes) {
+        lane = SkScalarPow(lane, exponent);
+    }
+    return Sk4f::Load(lanes);
+}
+
+// Rounds and clamps like SkClampMax(SkScalarRoundToInt(x), 255).
+static inline Sk4i round_to_channel(const Sk4f& x) {
+    return SkNx_cast<int32_t>(Sk4f::Min(Sk4f::Max((x + 0.5f).floor(), 0.0f), 255.0f));
+}
+
+static inline void store_argb(const Sk4f& a, const Sk4f& r, const Sk4f& g, const Sk4f& b,
+                              SkPMColor* dst, int n) {
+    Sk4i argb = (round_to_channel(a) << SK_A32_SHIFT) | (round_to_channel(r) << SK_R32_SHIFT) |
+                (round_to_channel(g) << SK_G32_SHIFT) | (round_to_channel(b) << SK_B32_SHIFT);
+    if (4 == n) {
+        argb.store(dst);
+    } else {
+        int32_t lanes[4];
+        argb.store(lanes);
+        memcpy(dst, lanes, n * sizeof(SkPMColor));
+    }
+}
+
 class DiffuseLightingType {
 public:
     DiffuseLightingType(SkScalar kd)
@@ -91,6 +161,13 @@ public:
                             SkClampMax(SkScalarRoundToInt(color.fY), 255),
                             SkClampMax(SkScalarRoundToInt(color.fZ), 255));
     }
+    void light4(const Point3x4& normal, const Point3x4& surfaceToLight,
+                const Point3x4& lightColor, SkPMColor* dst, int n) const {
+        Sk4f colorScale = fKD * normal.dot(surfaceToLight);
+        colorScale = clamp_max_one(colorScale);
+        Point3x4 color = lightColor.makeScale(colorScale);
+        store_argb(Sk4f(255), color.fX, color.fY, color.fZ, dst, n);
+    }
 private:
     SkScalar fKD;
 };
@@ -116,6 +193,17 @@ public:
                             SkClampMax(SkScalarRoundToInt(color.fY), 255),
                             SkClampMax(SkScalarRoundToInt(color.fZ), 255));
     }
+    void light4(const Point3x4& normal, const Point3x4& surfaceToLight,
+                const Point3x4& lightColor, SkPMColor* dst, int n) const {
+        Point3x4 halfDir = surfaceToLight;
+        halfDir.fZ = halfDir.fZ + SK_Scalar1;
+        halfDir.fastNormalize();
+        Sk4f colorScale = fKS * pow4(normal.dot(halfDir), fShininess);
+        colorScale = clamp_max_one(colorScale);
+        Point3x4 color = lightColor.makeScale(colorScale);
+        store_argb(Sk4f::Max(Sk4f::Max(color.fX, color.fY), color.fZ),
+                   color.fX, color.fY, color.fZ, dst, n);
+    }
 private:
     SkScalar fKS;
     SkScalar fShininess;
@@ -206,95 +294,182 @@ public:
     }
 };
 
+// Sobel normals for the rows at the top and bottom edges of the lit area, and for those between.
+struct TopRow {
+    static const bool kHasAbove = false, kHasBelow = true;
+    static SkPoint3 Left (int m[9], SkScalar s) { return topLeftNormal (m, s); }
+    static SkPoint3 Mid  (int m[9], SkScalar s) { return topNormal     (m, s); }
+    static SkPoint3 Right(int m[9], SkScalar s) { return topRightNormal(m, s); }
+};
+struct InteriorRow {
+    static const bool kHasAbove = true, kHasBelow = true;
+    static SkPoint3 Left (int m[9], SkScalar s) { return leftNormal    (m, s); }
+    static SkPoint3 Mid  (int m[9], SkScalar s) { return interiorNormal(m, s); }
+    static SkPoint3 Right(int m[9], SkScalar s) { return rightNormal   (m, s); }
+};
+struct BottomRow {
+    static const bool kHasAbove = true, kHasBelow = false;
+    static SkPoint3 Left (int m[9], SkScalar s) { return bottomLeftNormal (m, s); }
+    static SkPoint3 Mid  (int m[9], SkScalar s) { return bottomNormal     (m, s); }
+    static SkPoint3 Right(int m[9], SkScalar s) { return bottomRightNormal(m, s); }
+};
+
+// Loads column x of the 3x3 neighborhood of row y into column col of m.
+template <class Row, class PixelFetcher>
+inline void fetchColumn(const SkBitmap& src, int x, int y, const SkIRect& srcBounds,
+                        int m[9], int col) {
+    m[col]     = Row::kHasAbove ? PixelFetcher::Fetch(src, x, y - 1, srcBounds) : 0;
+    m[col + 3] = PixelFetcher::Fetch(src, x, y, srcBounds);
+    m[col + 6] = Row::kHasBelow ? PixelFetcher::Fetch(src, x, y + 1, srcBounds) : 0;
+}
+
+template <class Row, class LightingType, class LightType, class PixelFetcher>
+void lightRow(const LightingType& lightingType,
+              const LightType* l,
+              const SkBitmap& src,
+              SkScalar surfaceScale,
+              const SkIRect& edges,
+              int left, int right, int y,
+              SkPMColor* dptr) {
+    const SkIRect srcBounds = src.bounds();
+    int m[9] = { 0 };
+    if (left > edges.left()) {
+        fetchColumn<Row, PixelFetcher>(src, left - 1, y, srcBounds, m, 1);
+    }
+    fetchColumn<Row, PixelFetcher>(src, left, y, srcBounds, m, 2);
+
+    for (int x = left; x < right; ++x) {
+        shiftMatrixLeft(m);
+        if (x + 1 < edges.right()) {
+            fetchColumn<Row, PixelFetcher>(src, x + 1, y, srcBounds, m, 2);
+        }
+
+        SkPoint3 normal = x == edges.left()      ? Row::Left (m, surfaceScale)
+                        : x == edges.right() - 1 ? Row::Right(m, surfaceScale)
+                                                 : Row::Mid  (m, surfaceScale);
+        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+        *dptr++ = lightingType.light(normal, surfaceToLight, l->lightColor(surfaceToLight));
+    }
+}
+
+// Lights [left, right) of an interior row y four pixels at a time, from the alpha of columns
+// [left - 1, right + 1) of rows y - 1, y and y + 1, as floats.  Each of those rows is padded
+// with zeros so that the last, partial group may read past right + 1.  Only interior normals are
+// computed, so none of these pixels may be on the left or right edge.
+template <class LightingType, class LightType>
+void lightInteriorSpan(const LightingType& lightingType,
+                       const LightType* l,
+                       const float* above, const float* row, const float* below,
+                       SkScalar surfaceScale,
+                       int left, int right, int y,
+                       SkPMColor* dptr) {
+    const Sk4f laneOffsets(0, 1, 2, 3);
+    // Scaling by a quarter is exact, so folding it into surfaceScale rounds no differently.
+    const Sk4f normalScale(-surfaceScale * gOneQuarter);
+    for (int x = left; x < right; x += 4) {
+        const int i = x - left;
+        Sk4f ul = Sk4f::Load(above + i), uc = Sk4f::Load(above + i + 1),
+             ur = Sk4f::Load(above + i + 2);
+        Sk4f ml = Sk4f::Load(row   + i), mc = Sk4f::Load(row   + i + 1),
+             mr = Sk4f::Load(row   + i + 2);
+        Sk4f dl = Sk4f::Load(below + i), dc = Sk4f::Load(below + i + 1),
+             dr = Sk4f::Load(below + i + 2);
+
+        // interiorNormal(): the Sobel sums are small integers, so they come out exact.
+        Point3x4 normal = {
+            ((ur - ul) + (mr - ml) * 2 + (dr - dl)) * normalScale,
+            ((dl - ul) + (dc - uc) * 2 + (dr - ur)) * normalScale,
+            Sk4f(1),
+        };
+        normal.fastNormalize();
+
+        Point3x4 surfaceToLight = l->surfaceToLight4(Sk4f(SkIntToScalar(x)) + laneOffsets, y,
+                                                     mc, surfaceScale);
+        lightingType.light4(normal, surfaceToLight, l->lightColor4(surfaceToLight), dptr + i,
+                            SkTMin(4, right - x));
+    }
+}
+
+// Lights an interior row, running the pixels off the left and right edges through
+// lightInteriorSpan(), unless onePixelAtATime.  scratch has room for three rows of
+// bounds.width() + 5 floats.
+template <class LightingType, class LightType, class PixelFetcher>
+void lightInteriorRow(const LightingType& lightingType,
+                      const LightType* l,
+                      const SkBitmap& src,
+                      SkScalar surfaceScale,
+                      const SkIRect& edges,
+                      int left, int right, int y,
+                      bool onePixelAtATime,
+                      float* scratch,
+                      SkPMColor* dptr) {
+    const int midLeft  = SkTMax(left, edges.left() + 1);
+    const int midRight = SkTMin(right, edges.right() - 1);
+    if (midLeft >= midRight || onePixelAtATime) {
+        lightRow<InteriorRow, LightingType, LightType, PixelFetcher>(
+            lightingType, l, src, surfaceScale, edges, left, right, y, dptr);
+        return;
+    }
+
+    if (left < midLeft) {
+        lightRow<InteriorRow, LightingType, LightType, PixelFetcher>(
+            lightingType, l, src, surfaceScale, edges, left, midLeft, y, dptr);
+    }
+
+    const SkIRect srcBounds = src.bounds();
+    const int columns = midRight - midLeft + 2;
+    const int stride = columns + 3;
+    float* rows[3] = { scratch, scratch + stride, scratch + 2 * stride };
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < columns; ++c) {
+            rows[r][c] = SkIntToScalar(PixelFetcher::Fetch(src, midLeft - 1 + c, y - 1 + r,
+                                                           srcBounds));
+        }
+        rows[r][columns] = rows[r][columns + 1] = rows[r][columns + 2] = 0;
+    }
+    lightInteriorSpan(lightingType, l, rows[0], rows[1], rows[2], surfaceScale,
+                      midLeft, midRight, y, dptr + (midLeft - left));
+
+    if (midRight < right) {
+        lightRow<InteriorRow, LightingType, LightType, PixelFetcher>(
+            lightingType, l, src, surfaceScale, edges, midRight, right, y,
+            dptr + (midRight - left));
+    }
+}
+
+// Lights rows [top, bottom) of bounds.  The one-sided normals are used along the edges of the
+// lit area, edges, which contains bounds: it is bounds itself, except that the sides of a tile
+// (or of a band) are not edges.  Neighbors outside bounds are still read, as far as they lie
+// within edges, so bands and tiles light exactly as they would as part of the whole.
 template <class LightingType, class LightType, class PixelFetcher>
 void lightBitmap(const LightingType& lightingType,
                  const SkImageFilterLight* light,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
-                 const SkIRect& bounds) {
+                 const SkIRect& bounds,
+                 const SkIRect& edges,
+                 bool onePixelAtATime,
+                 int top, int bottom) {
     SkASSERT(dst->width() == bounds.width() && dst->height() == bounds.height());
+    SkASSERT(bounds.top() <= top && top <= bottom && bottom <= bounds.bottom());
+    SkASSERT(edges.contains(bounds) && edges.width() >= 2 && edges.height() >= 2);
     const LightType* l = static_cast<const LightType*>(light);
-    int left = bounds.left(), right = bounds.right();
-    int bottom = bounds.bottom();
-    int y = bounds.top();
-    SkIRect srcBounds = src.bounds();
-    SkPMColor* dptr = dst->getAddr32(0, 0);
-    {
-        int x = left;
-        int m[9];
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-            m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(topNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(topRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
-
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     y - 1, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     y,     srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-        m[7] = PixelFetcher::Fetch(src, x,     y + 1, srcBounds);
-        m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
-            m[2] = PixelFetcher::Fetch(src, x + 1, y - 1, srcBounds);
-            m[5] = PixelFetcher::Fetch(src, x + 1, y,     srcBounds);
-            m[8] = PixelFetcher::Fetch(src, x + 1, y + 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
-        }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
-
-    {
-        int x = left;
-        int m[9];
-        m[1] = PixelFetcher::Fetch(src, x,     bottom - 2, srcBounds);
-        m[2] = PixelFetcher::Fetch(src, x + 1, bottom - 2, srcBounds);
-        m[4] = PixelFetcher::Fetch(src, x,     bottom - 1, srcBounds);
-        m[5] = PixelFetcher::Fetch(src, x + 1, bottom - 1, srcBounds);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomLeftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x)
-        {
-            shiftMatrixLeft(m);
-            m[2] = PixelFetcher::Fetch(src, x + 1, bottom - 2, srcBounds);
-            m[5] = PixelFetcher::Fetch(src, x + 1, bottom - 1, srcBounds);
-            surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(bottomNormal(m, surfaceScale), surfaceToLight,
-                                         l->lightColor(surfaceToLight));
+    SkAutoTMalloc<float> scratch(3 * (bounds.width() + 5));
+
+    for (int y = top; y < bottom; ++y) {
+        SkPMColor* dptr = dst->getAddr32(0, y - bounds.top());
+        if (y == edges.top()) {
+            lightRow<TopRow, LightingType, LightType, PixelFetcher>(
+                lightingType, l, src, surfaceScale, edges, bounds.left(), bounds.right(), y, dptr);
+        } else if (y < edges.bottom() - 1) {
+            lightInteriorRow<LightingType, LightType, PixelFetcher>(
+                lightingType, l, src, surfaceScale, edges, bounds.left(), bounds.right(), y,
+                onePixelAtATime, scratch.get(), dptr);
+        } else {
+            lightRow<BottomRow, LightingType, LightType, PixelFetcher>(
+                lightingType, l, src, surfaceScale, edges, bounds.left(), bounds.right(), y, dptr);
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(bottomRightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
     }
 }
 
@@ -304,14 +479,25 @@ void lightBitmap(const LightingType& lightingType,
                  const SkBitmap& src,
                  SkBitmap* dst,
                  SkScalar surfaceScale,
-                 const SkIRect& bounds) {
-    if (src.bounds().contains(bounds)) {
-        lightBitmap<LightingType, LightType, UncheckedPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    } else {
-        lightBitmap<LightingType, LightType, DecalPixelFetcher>(
-            lightingType, light, src, dst, surfaceScale, bounds);
-    }
+                 const SkIRect& bounds,
+                 const SkIRect& edges,
+                 bool onePixelAtATime,
+                 const SkImageFilter::Context& ctx) {
+    // The pixels read: bounds and its neighbors, as far as they lie on the surface.
+    SkIRect reads = bounds.makeOutset(1, 1);
+    SkAssertResult(reads.intersect(edges));
+    const bool unchecked = src.bounds().contains(reads);
+    SkImageFilterForEachBand(ctx, bounds, [&](int top, int bottom) {
+        if (unchecked) {
+            lightBitmap<LightingType, LightType, UncheckedPixelFetcher>(
+                lightingType, light, src, dst, surfaceScale, bounds, edges, onePixelAtATime,
+                top, bottom);
+        } else {
+            lightBitmap<LightingType, LightType, DecalPixelFetcher>(
+                lightingType, light, src, dst, surfaceScale, bounds, edges, onePixelAtATime,
+                top, bottom);
+        }
+    });
 }
 
 SkPoint3 readPoint3(SkReadBuffer& buffer) {
@@ -354,10 +540,32 @@ protected:
         : INHERITED(std::move(light), surfaceScale, std::move(input), cropRect) {
     }
 
+    // Each output pixel's normal comes from its input neighbors, one pixel out.
+    SkIRect onFilterNodeBounds(const SkIRect& src, const SkMatrix&,
+                               MapDirection direction) const override {
+        return kReverse_MapDirection == direction ? src.makeOutset(1, 1) : src;
+    }
+
+    bool onCanFilterInTiles() const override { return true; }
+
+    // The area lit from inputBounds, clipped to the whole output.  The one-sided normals belong
+    // along its sides, and so along the clip as it always has been, but not along the sides of a
+    // tile of filterImageInTiles(), which must light as it would as part of the whole.
+    SkIRect litBounds(const Context& ctx, const SkIRect& inputBounds) const {
+        SkIRect lit;
+        this->getCropRect().applyTo(inputBounds, ctx.ctm(), this->affectsTransparentBlack(),
+                                    &lit);
+        if (!lit.intersect(ctx.fullClipBounds())) {
+            return SkIRect::MakeEmpty();
+        }
+        return lit;
+    }
+
 #if SK_SUPPORT_GPU
     sk_sp<SkSpecialImage> filterImageGPU(SkSpecialImage* source,
                                          SkSpecialImage* input,
                                          const SkIRect& bounds,
+                                         const SkIRect& edges,
                                          const SkMatrix& matrix,
                                          const OutputProperties& outputProperties) const;
     virtual sk_sp<GrFragmentProcessor> makeFragmentProcessor(GrResourceProvider*,
@@ -407,6 +615,7 @@ sk_sp<SkSpecialImage> SkLightingImageFilterInternal::filterImageGPU(
                                                    SkSpecialImage* source,
                                                    SkSpecialImage* input,
                                                    const SkIRect& offsetBounds,
+                                                   const SkIRect& edges,
                                                    const SkMatrix& matrix,
                                                    const OutputProperties& outputProperties) const {
     SkASSERT(source->isTextureBacked());
@@ -425,41 +634,33 @@ sk_sp<SkSpecialImage> SkLightingImageFilterInternal::filterImageGPU(
     }
 
     SkIRect dstIRect = SkIRect::MakeWH(offsetBounds.width(), offsetBounds.height());
-    SkRect dstRect = SkRect::Make(dstIRect);
 
     // setup new clip
     GrFixedClip clip(dstIRect);
 
+    // Only the sides of the lit area that fall within the output get the one-sided normals;
+    // wherever a tile cuts through it, the interior ones carry on to the neighbors beyond.
+    const int w = dstIRect.width(), h = dstIRect.height();
+    const SkIRect dstEdges = edges.makeOffset(-offsetBounds.x(), -offsetBounds.y());
+    const int xs[4] = { 0, 0 == dstEdges.left() ? 1 : 0, w == dstEdges.right() ? w - 1 : w, w };
+    const int ys[4] = { 0, 0 == dstEdges.top()  ? 1 : 0, h == dstEdges.bottom() ? h - 1 : h, h };
+
     const SkIRect inputBounds = SkIRect::MakeWH(input->width(), input->height());
-    SkRect topLeft = SkRect::MakeXYWH(0, 0, 1, 1);
-    SkRect top = SkRect::MakeXYWH(1, 0, dstRect.width() - 2, 1);
-    SkRect topRight = SkRect::MakeXYWH(dstRect.width() - 1, 0, 1, 1);
-    SkRect left = SkRect::MakeXYWH(0, 1, 1, dstRect.height() - 2);
-    SkRect interior = dstRect.makeInset(1, 1);
-    SkRect right = SkRect::MakeXYWH(dstRect.width() - 1, 1, 1, dstRect.height() - 2);
-    SkRect bottomLeft = SkRect::MakeXYWH(0, dstRect.height() - 1, 1, 1);
-    SkRect bottom = SkRect::MakeXYWH(1, dstRect.height() - 1, dstRect.width() - 2, 1);
-    SkRect bottomRight = SkRect::MakeXYWH(dstRect.width() - 1, dstRect.height() - 1, 1, 1);
-
-    const SkIRect* pSrcBounds = inputBounds.contains(offsetBounds) ? nullptr : &inputBounds;
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, topLeft,
-                   kTopLeft_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, top,
-                   kTop_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, topRight,
-                   kTopRight_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, left,
-                   kLeft_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, interior,
-                   kInterior_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, right,
-                   kRight_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, bottomLeft,
-                   kBottomLeft_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, bottom,
-                   kBottom_BoundaryMode, pSrcBounds, offsetBounds);
-    this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip, bottomRight,
-                   kBottomRight_BoundaryMode, pSrcBounds, offsetBounds);
+    SkIRect reads = offsetBounds.makeOutset(1, 1);
+    SkAssertResult(reads.intersect(edges));
+    const SkIRect* pSrcBounds = inputBounds.contains(reads) ? nullptr : &inputBounds;
+
+    // BoundaryMode lists the nine regions row by row, top to bottom, left to right.
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col) {
+            SkIRect rect = SkIRect::MakeLTRB(xs[col], ys[row], xs[col + 1], ys[row + 1]);
+            if (!rect.isEmpty()) {
+                this->drawRect(renderTargetContext.get(), inputProxy, matrix, clip,
+                               SkRect::Make(rect), (BoundaryMode)(3 * row + col), pSrcBounds,
+                               offsetBounds);
+            }
+        }
+    }
 
     return SkSpecialImage::MakeDeferredFromGpu(
                                        context,
@@ -807,6 +1008,10 @@ public:
         return fDirection;
     }
     const SkPoint3& lightColor(const SkPoint3&) const { return this->color(); }
+    Point3x4 surfaceToLight4(const Sk4f& x, int y, const Sk4f& z, SkScalar surfaceScale) const {
+        return Point3x4::Splat(fDirection);
+    }
+    Point3x4 lightColor4(const Point3x4&) const { return Point3x4::Splat(this->color()); }
     LightType type() const override { return kDistant_LightType; }
     const SkPoint3& direction() const { return fDirection; }
     GrGLLight* createGLLight() const override {
@@ -863,7 +1068,15 @@ public:
         fast_normalize(&direction);
         return direction;
     }
+    Point3x4 surfaceToLight4(const Sk4f& x, int y, const Sk4f& z, SkScalar surfaceScale) const {
+        Point3x4 direction = { fLocation.fX - x,
+                               Sk4f(fLocation.fY - SkIntToScalar(y)),
+                               fLocation.fZ - z * surfaceScale };
+        direction.fastNormalize();
+        return direction;
+    }
     const SkPoint3& lightColor(const SkPoint3&) const { return this->color(); }
+    Point3x4 lightColor4(const Point3x4&) const { return Point3x4::Splat(this->color()); }
     LightType type() const override { return kPoint_LightType; }
     const SkPoint3& location() const { return fLocation; }
     GrGLLight* createGLLight() const override {
@@ -966,6 +1179,13 @@ public:
         fast_normalize(&direction);
         return direction;
     }
+    Point3x4 surfaceToLight4(const Sk4f& x, int y, const Sk4f& z, SkScalar surfaceScale) const {
+        Point3x4 direction = { fLocation.fX - x,
+                               Sk4f(fLocation.fY - SkIntToScalar(y)),
+                               fLocation.fZ - z * surfaceScale };
+        direction.fastNormalize();
+        return direction;
+    }
     SkPoint3 lightColor(const SkPoint3& surfaceToLight) const {
         SkScalar cosAngle = -surfaceToLight.dot(fS);
         SkScalar scale = 0;
@@ -977,6 +1197,15 @@ public:
         }
         return this->color().makeScale(scale);
     }
+    Point3x4 lightColor4(const Point3x4& surfaceToLight) const {
+        const SkPoint3 negS = SkPoint3::Make(-fS.fX, -fS.fY, -fS.fZ);
+        Sk4f cosAngle = surfaceToLight.dot(Point3x4::Splat(negS));
+        Sk4f scale = pow4(cosAngle, fSpecularExponent);
+        scale = (cosAngle < fCosInnerConeAngle).thenElse(
+                scale * ((cosAngle - fCosOuterConeAngle) * fConeScale), scale);
+        scale = (cosAngle >= fCosOuterConeAngle).thenElse(scale, 0.0f);
+        return Point3x4::Splat(this->color()).makeScale(scale);
+    }
     GrGLLight* createGLLight() const override {
 #if SK_SUPPORT_GPU
         return new GrGLSpotLight;
@@ -1250,21 +1479,24 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(SkSpecialImage
     if (!this->applyCropRect(ctx, inputBounds, &bounds)) {
         return nullptr;
     }
+    SkIRect edges = this->litBounds(ctx, inputBounds);
 
     offset->fX = bounds.left();
     offset->fY = bounds.top();
     bounds.offset(-inputOffset);
+    edges.offset(-inputOffset);
 
 #if SK_SUPPORT_GPU
     if (source->isTextureBacked()) {
         SkMatrix matrix(ctx.ctm());
         matrix.postTranslate(SkIntToScalar(-offset->fX), SkIntToScalar(-offset->fY));
 
-        return this->filterImageGPU(source, input.get(), bounds, matrix, ctx.outputProperties());
+        return this->filterImageGPU(source, input.get(), bounds, edges, matrix,
+                                    ctx.outputProperties());
     }
 #endif
 
-    if (bounds.width() < 2 || bounds.height() < 2) {
+    if (edges.width() < 2 || edges.height() < 2) {
         return nullptr;
     }
 
@@ -1305,7 +1537,10 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(SkSpecialImage
                                                              inputBM,
                                                              &dst,
                                                              surfaceScale(),
-                                                             bounds);
+                                                             bounds,
+                                                             edges,
+                                                             this->lightsOnePixelAtATime(),
+                                                             ctx);
             break;
         case SkImageFilterLight::kPoint_LightType:
             lightBitmap<DiffuseLightingType, SkPointLight>(lightingType,
@@ -1313,7 +1548,10 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(SkSpecialImage
                                                            inputBM,
                                                            &dst,
                                                            surfaceScale(),
-                                                           bounds);
+                                                           bounds,
+                                                           edges,
+                                                           this->lightsOnePixelAtATime(),
+                                                           ctx);
             break;
         case SkImageFilterLight::kSpot_LightType:
             lightBitmap<DiffuseLightingType, SkSpotLight>(lightingType,
@@ -1321,7 +1559,10 @@ sk_sp<SkSpecialImage> SkDiffuseLightingImageFilter::onFilterImage(SkSpecialImage
                                                           inputBM,
                                                           &dst,
                                                           surfaceScale(),
-                                                          bounds);
+                                                          bounds,
+                                                          edges,
+                                                          this->lightsOnePixelAtATime(),
+                                                          ctx);
             break;
     }
 
@@ -1417,21 +1658,24 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(SkSpecialImag
     if (!this->applyCropRect(ctx, inputBounds, &bounds)) {
         return nullptr;
     }
+    SkIRect edges = this->litBounds(ctx, inputBounds);
 
     offset->fX = bounds.left();
     offset->fY = bounds.top();
     bounds.offset(-inputOffset);
+    edges.offset(-inputOffset);
 
 #if SK_SUPPORT_GPU
     if (source->isTextureBacked()) {
         SkMatrix matrix(ctx.ctm());
         matrix.postTranslate(SkIntToScalar(-offset->fX), SkIntToScalar(-offset->fY));
 
-        return this->filterImageGPU(source, input.get(), bounds, matrix, ctx.outputProperties());
+        return this->filterImageGPU(source, input.get(), bounds, edges, matrix,
+                                    ctx.outputProperties());
     }
 #endif
 
-    if (bounds.width() < 2 || bounds.height() < 2) {
+    if (edges.width() < 2 || edges.height() < 2) {
         return nullptr;
     }
 
@@ -1473,7 +1717,10 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(SkSpecialImag
                                                               inputBM,
                                                               &dst,
                                                               surfaceScale(),
-                                                              bounds);
+                                                              bounds,
+                                                              edges,
+                                                              this->lightsOnePixelAtATime(),
+                                                              ctx);
             break;
         case SkImageFilterLight::kPoint_LightType:
             lightBitmap<SpecularLightingType, SkPointLight>(lightingType,
@@ -1481,7 +1728,10 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(SkSpecialImag
                                                             inputBM,
                                                             &dst,
                                                             surfaceScale(),
-                                                            bounds);
+                                                            bounds,
+                                                            edges,
+                                                            this->lightsOnePixelAtATime(),
+                                                            ctx);
             break;
         case SkImageFilterLight::kSpot_LightType:
             lightBitmap<SpecularLightingType, SkSpotLight>(lightingType,
@@ -1489,7 +1739,10 @@ sk_sp<SkSpecialImage> SkSpecularLightingImageFilter::onFilterImage(SkSpecialImag
                                                            inputBM,
                                                            &dst,
                                                            surfaceScale(),
-                                                           bounds);
+                                                           bounds,
+                                                           edges,
+                                                           this->lightsOnePixelAtATime(),
+                                                           ctx);
             break;
     }
 
@@ -8,6 +8,8 @@
 #include "SkMatrixConvolutionImageFilter.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkImageFilterPriv.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkSpecialImage.h"
 #include "SkWriteBuffer.h"
@@ -24,6 +26,49 @@
 // by the size of a scalar to know how many scalars we can read.
 static const int32_t gMaxKernelSize = SK_MaxS32 / sizeof(SkScalar);
 
+// Returns the row and column factors of kernel, as described for fSeparableKernel, if it is
+// (to float precision) their product and two passes over them would cost fewer taps, or null.
+static SkScalar* make_separable_kernel(const SkISize& kernelSize, const SkScalar* kernel) {
+    const int w = kernelSize.width(), h = kernelSize.height();
+    // The intermediate pass is about as costly per tap as the final one.
+    if (w * h <= 2 * (w + h)) {
+        return nullptr;
+    }
+
+    // Factor around the largest element, so the division below is as exact as it can be.
+    int pivot = 0;
+    for (int i = 1; i < w * h; ++i) {
+        if (SkScalarAbs(kernel[i]) > SkScalarAbs(kernel[pivot])) {
+            pivot = i;
+        }
+    }
+    const SkScalar maxAbs = SkScalarAbs(kernel[pivot]);
+    if (0 == maxAbs || !SkScalarIsFinite(maxAbs)) {
+        return nullptr;
+    }
+    const int pivotX = pivot % w, pivotY = pivot / w;
+
+    std::unique_ptr<SkScalar[]> factors(new SkScalar[w + h]);
+    SkScalar* row = factors.get();
+    SkScalar* col = factors.get() + w;
+    for (int x = 0; x < w; ++x) {
+        row[x] = kernel[pivotY * w + x];
+    }
+    for (int y = 0; y < h; ++y) {
+        col[y] = kernel[y * w + pivotX] / kernel[pivot];
+    }
+
+    const SkScalar tolerance = maxAbs * 1e-6f;
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            if (SkScalarAbs(kernel[y * w + x] - col[y] * row[x]) > tolerance) {
+                return nullptr;
+            }
+        }
+    }
+    return factors.release();
+}
+
 SkMatrixConvolutionImageFilter::SkMatrixConvolutionImageFilter(const SkISize& kernelSize,
                                                                const SkScalar* kernel,
                                                                SkScalar gain,
@@ -43,6 +88,7 @@ SkMatrixConvolutionImageFilter::SkMatrixConvolutionImageFilter(const SkISize& ke
     size_t size = (size_t) sk_64_mul(fKernelSize.width(), fKernelSize.height());
     fKernel = new SkScalar[size];
     memcpy(fKernel, kernel, size * sizeof(SkScalar));
+    fSeparableKernel = make_separable_kernel(fKernelSize, fKernel);
     SkASSERT(kernelSize.fWidth >= 1 && kernelSize.fHeight >= 1);
     SkASSERT(kernelOffset.fX >= 0 && kernelOffset.fX < kernelSize.fWidth);
     SkASSERT(kernelOffset.fY >= 0 && kernelOffset.fY < kernelSize.fHeight);
@@ -117,6 +163,7 @@ void SkMatrixConvolutionImageFilter::flatten(SkWriteBuffer& buffer) const {
 
 SkMatrixConvolutionImageFilter::~SkMatrixConvolutionImageFilter() {
     delete[] fKernel;
+    delete[] fSeparableKernel;
 }
 
 class UncheckedPixelFetcher {
@@ -161,6 +208,25 @@ public:
     }
 };
 
+static inline Sk4f load_channels(SkPMColor c) {
+    return SkNx_cast<float>(Sk4b::Load(&c));
+}
+
+// Applies gain and bias to the summed channels, and clamps them: each to [0, 255], and the colors
+// to alpha when it was convolved too.  Otherwise the colors are premultiplied by src's alpha.
+template <bool convolveAlpha>
+static inline SkPMColor finish_pixel(const Sk4f& sum, SkScalar gain, SkScalar bias, SkPMColor src) {
+    Sk4f c = Sk4f::Min(Sk4f::Max((sum * gain + bias).floor(), 0.0f), 255.0f);
+    if (convolveAlpha) {
+        c = Sk4f::Min(c, c[SK_A32_SHIFT / 8]);
+        SkPMColor dst;
+        SkNx_cast<uint8_t>(c).store(&dst);
+        return dst;
+    }
+    return SkPreMultiplyARGB(SkGetPackedA32(src), (U8CPU)c[SK_R32_SHIFT / 8],
+                             (U8CPU)c[SK_G32_SHIFT / 8], (U8CPU)c[SK_B32_SHIFT / 8]);
+}
+
 template<class PixelFetcher, bool convolveAlpha>
 void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
                                                   SkBitmap* result,
@@ -170,37 +236,22 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     if (!rect.intersect(bounds)) {
         return;
     }
+    // All four channels are summed at once, in the lanes of an Sk4f.
     for (int y = rect.fTop; y < rect.fBottom; ++y) {
         SkPMColor* dptr = result->getAddr32(rect.fLeft - bounds.fLeft, y - bounds.fTop);
         for (int x = rect.fLeft; x < rect.fRight; ++x) {
-            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
+            Sk4f sum(0);
             for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
                 for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
                     SkPMColor s = PixelFetcher::fetch(src,
                                                       x + cx - fKernelOffset.fX,
                                                       y + cy - fKernelOffset.fY,
                                                       bounds);
-                    SkScalar k = fKernel[cy * fKernelSize.fWidth + cx];
-                    if (convolveAlpha) {
-                        sumA += SkGetPackedA32(s) * k;
-                    }
-                    sumR += SkGetPackedR32(s) * k;
-                    sumG += SkGetPackedG32(s) * k;
-                    sumB += SkGetPackedB32(s) * k;
+                    sum = sum + load_channels(s) * fKernel[cy * fKernelSize.fWidth + cx];
                 }
             }
-            int a = convolveAlpha
-                  ? SkClampMax(SkScalarFloorToInt(sumA * fGain + fBias), 255)
-                  : 255;
-            int r = SkClampMax(SkScalarFloorToInt(sumR * fGain + fBias), a);
-            int g = SkClampMax(SkScalarFloorToInt(sumG * fGain + fBias), a);
-            int b = SkClampMax(SkScalarFloorToInt(sumB * fGain + fBias), a);
-            if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
-            } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
-            }
+            *dptr++ = finish_pixel<convolveAlpha>(sum, fGain, fBias,
+                                                  convolveAlpha ? 0 : *src.getAddr32(x, y));
         }
     }
 }
@@ -241,6 +292,97 @@ void SkMatrixConvolutionImageFilter::filterBorderPixels(const SkBitmap& src,
     }
 }
 
+// Convolves rows [rect.top(), rect.bottom()) of rect with the row factors, into a ring of
+// fKernelSize.height() rows of channel sums, then those with the column factors.  Each source row
+// is convolved once per band instead of once per output row it reaches.
+template<class PixelFetcher, bool convolveAlpha>
+void SkMatrixConvolutionImageFilter::filterPixelsSeparable(const SkBitmap& src,
+                                                           SkBitmap* result,
+                                                           const SkIRect& r,
+                                                           const SkIRect& bounds) const {
+    SkIRect rect(r);
+    if (!rect.intersect(bounds)) {
+        return;
+    }
+    const int w = fKernelSize.width(), h = fKernelSize.height();
+    const SkScalar* rowKernel = fSeparableKernel;
+    const SkScalar* colKernel = fSeparableKernel + w;
+    const int width = rect.width();
+
+    // Sums for source row sy live in ring row sy % h.
+    SkAutoTMalloc<float> ring(h * width * 4);
+    auto ringRow = [&](int sy) { return ring.get() + ((sy % h + h) % h) * width * 4; };
+
+    auto convolveRow = [&](int sy) {
+        float* sums = ringRow(sy);
+        const bool rowInside = sy >= bounds.top() && sy < bounds.bottom();
+        for (int x = rect.left(); x < rect.right(); ++x) {
+            const int sx = x - fKernelOffset.fX;
+            Sk4f sum(0);
+            if (rowInside && sx >= bounds.left() && sx + w <= bounds.right()) {
+                const SkPMColor* sptr = src.getAddr32(sx, sy);
+                for (int cx = 0; cx < w; ++cx) {
+                    sum = sum + load_channels(sptr[cx]) * rowKernel[cx];
+                }
+            } else {
+                for (int cx = 0; cx < w; ++cx) {
+                    sum = sum + load_channels(PixelFetcher::fetch(src, sx + cx, sy, bounds)) *
+                                rowKernel[cx];
+                }
+            }
+            sum.store(sums + (x - rect.left()) * 4);
+        }
+    };
+
+    for (int sy = rect.top() - fKernelOffset.fY; sy < rect.top() - fKernelOffset.fY + h - 1; ++sy) {
+        convolveRow(sy);
+    }
+    for (int y = rect.top(); y < rect.bottom(); ++y) {
+        const int firstRow = y - fKernelOffset.fY;
+        convolveRow(firstRow + h - 1);
+
+        SkPMColor* dptr = result->getAddr32(rect.left() - bounds.left(), y - bounds.top());
+        for (int x = 0; x < width; ++x) {
+            Sk4f sum(0);
+            for (int cy = 0; cy < h; ++cy) {
+                sum = sum + Sk4f::Load(ringRow(firstRow + cy) + x * 4) * colKernel[cy];
+            }
+            *dptr++ = finish_pixel<convolveAlpha>(
+                    sum, fGain, fBias, convolveAlpha ? 0 : *src.getAddr32(rect.left() + x, y));
+        }
+    }
+}
+
+void SkMatrixConvolutionImageFilter::filterSeparablePixels(const SkBitmap& src,
+                                                           SkBitmap* result,
+                                                           const SkIRect& rect,
+                                                           const SkIRect& bounds) const {
+    SkASSERT(fSeparableKernel);
+    switch (fTileMode) {
+        case kClamp_TileMode:
+            if (fConvolveAlpha) {
+                filterPixelsSeparable<ClampPixelFetcher, true>(src, result, rect, bounds);
+            } else {
+                filterPixelsSeparable<ClampPixelFetcher, false>(src, result, rect, bounds);
+            }
+            break;
+        case kRepeat_TileMode:
+            if (fConvolveAlpha) {
+                filterPixelsSeparable<RepeatPixelFetcher, true>(src, result, rect, bounds);
+            } else {
+                filterPixelsSeparable<RepeatPixelFetcher, false>(src, result, rect, bounds);
+            }
+            break;
+        case kClampToBlack_TileMode:
+            if (fConvolveAlpha) {
+                filterPixelsSeparable<ClampToBlackPixelFetcher, true>(src, result, rect, bounds);
+            } else {
+                filterPixelsSeparable<ClampToBlackPixelFetcher, false>(src, result, rect, bounds);
+            }
+            break;
+    }
+}
+
 // FIXME:  This should be refactored to SkImageFilterUtils for
 // use by other filters.  For now, we assume the input is always
 // premultiplied and unpremultiply it
@@ -368,6 +510,15 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(SkSpecialIma
     offset->fX = bounds.fLeft;
     offset->fY = bounds.fTop;
     bounds.offset(-inputOffset);
+    if (fSeparableKernel) {
+        // The row pass handles the borders itself, so there is no need to split them off.
+        SkImageFilterForEachBand(ctx, bounds, [&](int top, int bottom) {
+            SkIRect band = SkIRect::MakeLTRB(bounds.left(), top, bounds.right(), bottom);
+            this->filterSeparablePixels(inputBM, &dst, band, bounds);
+        });
+        return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()),
+                                              dst);
+    }
     SkIRect interior = SkIRect::MakeXYWH(bounds.left() + fKernelOffset.fX,
                                          bounds.top() + fKernelOffset.fY,
                                          bounds.width() - fKernelSize.fWidth + 1,
@@ -381,7 +532,10 @@ sk_sp<SkSpecialImage> SkMatrixConvolutionImageFilter::onFilterImage(SkSpecialIma
                                       bounds.right(), interior.bottom());
     this->filterBorderPixels(inputBM, &dst, top, bounds);
     this->filterBorderPixels(inputBM, &dst, left, bounds);
-    this->filterInteriorPixels(inputBM, &dst, interior, bounds);
+    SkImageFilterForEachBand(ctx, interior, [&](int top, int bottom) {
+        SkIRect band = SkIRect::MakeLTRB(interior.left(), top, interior.right(), bottom);
+        this->filterInteriorPixels(inputBM, &dst, band, bounds);
+    });
     this->filterBorderPixels(inputBM, &dst, right, bounds);
     this->filterBorderPixels(inputBM, &dst, bottom, bounds);
     return SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(bounds.width(), bounds.height()),
@@ -402,6 +556,11 @@ SkIRect SkMatrixConvolutionImageFilter::onFilterNodeBounds(const SkIRect& src, c
     return dst;
 }
 
+bool SkMatrixConvolutionImageFilter::onCanFilterInTiles() const {
+    // Repeating wraps around the input's bounds, which the clip may have cut short.
+    return kRepeat_TileMode != fTileMode;
+}
+
 bool SkMatrixConvolutionImageFilter::affectsTransparentBlack() const {
     // Because the kernel is applied in device-space, we have no idea what
     // pixels it will affect in object-space.
@@ -86,9 +86,8 @@ sk_sp<SkSpecialImage> SkMergeImageFilter::onFilterImage(SkSpecialImage* source,
     std::unique_ptr<SkIPoint[]> offsets(new SkIPoint[inputCount]);
 
     // Filter all of the inputs.
+    this->filterInputs(source, ctx, inputs.get(), offsets.get());
     for (int i = 0; i < inputCount; ++i) {
-        offsets[i].setZero();
-        inputs[i] = this->filterInput(i, source, ctx, &offsets[i]);
         if (!inputs[i]) {
             continue;
         }
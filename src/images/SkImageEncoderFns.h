@@ -17,6 +17,8 @@
 #include "SkColorPriv.h"
 #include "SkColorSpace_Base.h"
 #include "SkICC.h"
+#include "SkNx.h"
+#include "SkOpts.h"
 #include "SkPreConfig.h"
 #include "SkRasterPipeline.h"
 #include "SkUnPreMultiply.h"
@@ -89,6 +91,39 @@ static inline void transform_scanline_565(char* SK_RESTRICT dst, const char* SK_
     }
 }
 
+/**
+ * Transform from kRGB_565_Config to 4-bytes-per-pixel RGBX, where X is an opaque alpha.
+ * This is vectorized, so it is faster than transform_scanline_565 if the destination can
+ * tolerate the extra byte.  Channels are expanded by bit replication, like SkPacked16ToR32(),
+ * so the bytes match transform_scanline_565's.
+ */
+static inline void transform_scanline_565_to_RGBX(char* SK_RESTRICT dst,
+                                                  const char* SK_RESTRICT src, int width, int,
+                                                  const SkPMColor*) {
+    const uint16_t* srcP = (const uint16_t*)src;
+    uint32_t* dstP = (uint32_t*)dst;
+    for (; width >= 4; width -= 4) {
+        Sk4i c = SkNx_cast<int32_t>(Sk4h::Load(srcP));
+        Sk4i r = (c >> SK_R16_SHIFT) & SK_R16_MASK,
+             g = (c >> SK_G16_SHIFT) & SK_G16_MASK,
+             b = (c >> SK_B16_SHIFT) & SK_B16_MASK;
+        r = (r << 3) | (r >> 2);
+        g = (g << 2) | (g >> 4);
+        b = (b << 3) | (b >> 2);
+        (r | (g << 8) | (b << 16) | Sk4i((int32_t)0xFF000000)).store(dstP);
+        srcP += 4;
+        dstP += 4;
+    }
+    char* tail = (char*)dstP;
+    for (int i = 0; i < width; i++) {
+        unsigned c = *srcP++;
+        *tail++ = SkPacked16ToR32(c);
+        *tail++ = SkPacked16ToG32(c);
+        *tail++ = SkPacked16ToB32(c);
+        *tail++ = (char)0xFF;
+    }
+}
+
 /**
  * Transform from kRGBA_8888_SkColorType to 3-bytes-per-pixel RGB.
  * Alpha channel data is abandoned.
@@ -134,6 +169,18 @@ static inline void transform_scanline_444(char* SK_RESTRICT dst, const char* SK_
     }
 }
 
+/**
+ * Transform from kARGB_4444_Config to 4-bytes-per-pixel RGBX, where X is the (ignored) alpha.
+ */
+static inline void transform_scanline_444_to_RGBX(char* SK_RESTRICT dst,
+                                                  const char* SK_RESTRICT src, int width, int,
+                                                  const SkPMColor*) {
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline::load_4444, (const void**) &src);
+    p.append(SkRasterPipeline::store_8888, (void**) &dst);
+    p.run(0, width);
+}
+
 /**
  * Transform from legacy kPremul, kRGBA_8888_SkColorType to 4-bytes-per-pixel unpremultiplied RGBA.
  */
@@ -183,17 +230,11 @@ static inline void transform_scanline_sbgrA(char* SK_RESTRICT dst, const char* S
 
 /**
  * Transform from kUnpremul, kBGRA_8888_SkColorType to 4-bytes-per-pixel unpremultiplied RGBA.
+ * Also transforms from kOpaque, kBGRA_8888_SkColorType to 4-bytes-per-pixel RGBX.
  */
 static inline void transform_scanline_BGRA(char* SK_RESTRICT dst, const char* SK_RESTRICT src,
                                            int width, int, const SkPMColor*) {
-    const uint32_t* srcP = (const SkPMColor*)src;
-    for (int i = 0; i < width; i++) {
-        uint32_t c = *srcP++;
-        *dst++ = (c >> 16) & 0xFF;
-        *dst++ = (c >>  8) & 0xFF;
-        *dst++ = (c >>  0) & 0xFF;
-        *dst++ = (c >> 24) & 0xFF;
-    }
+    SkOpts::RGBA_to_BGRA((uint32_t*) dst, src, width);
 }
 
 /**
@@ -10,8 +10,38 @@
 
 #include "SkImageEncoder.h"
 
+class SkExecutor;
+
 struct SkEncodeOptions {
+    /**
+     *  PNG only.  The filter types libpng may choose between for each row.  These values match
+     *  PNG_FILTER_NONE, PNG_FILTER_SUB, etc.  As in libpng, kAll leaves kIndex_8 unfiltered.
+     */
+    enum class PNGFilterFlags : int {
+        kNone  = 0x08,
+        kSub   = 0x10,
+        kUp    = 0x20,
+        kAvg   = 0x40,
+        kPaeth = 0x80,
+        kAll   = kNone | kSub | kUp | kAvg | kPaeth,
+    };
+
     SkTransferFunctionBehavior fUnpremulBehavior = SkTransferFunctionBehavior::kIgnore;
+
+    /**
+     *  PNG only.  Trading size for speed: fewer filter types to try and a lower zlib level
+     *  (0 to 9) make encoding faster.  kSub with level 1 is a good choice for encodes that
+     *  must be fast, e.g. tiles that will be thrown away soon.
+     */
+    PNGFilterFlags fPNGFilterFlags = PNGFilterFlags::kAll;
+    int            fPNGZLibLevel = 6;
+
+    /**
+     *  PNG only.  If non-null, bands of rows are filtered and deflated concurrently on this
+     *  executor.  The output is a single valid zlib stream, but is not byte-identical to
+     *  (and is usually slightly larger than) the output of a serial encode.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 #ifdef SK_HAS_JPEG_LIBRARY
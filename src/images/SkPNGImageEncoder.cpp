@@ -14,13 +14,16 @@
 #include "SkDither.h"
 #include "SkImageEncoderFns.h"
 #include "SkMath.h"
+#include "SkNx.h"
 #include "SkStream.h"
 #include "SkString.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUnPreMultiply.h"
 #include "SkUtils.h"
 
 #include "png.h"
+#include "zlib.h"
 
 // Suppress most PNG warnings when calling image decode functions.
 static const bool c_suppressPNGImageDecoderWarnings = true;
@@ -51,6 +54,8 @@ static void set_icc(png_structp png_ptr, png_infop info_ptr, sk_sp<SkData> icc)
     png_set_iCCP(png_ptr, info_ptr, name, 0, iccPtr, icc->size());
 }
 
+// Opaque pixels are transformed to RGBX (or 16-bit RGBX for F16), so that the transforms can work
+// on whole pixels.  libpng (or write_idat_parallel()) strips the filler.
 static transform_scanline_proc choose_proc(const SkImageInfo& info,
                                            SkTransferFunctionBehavior unpremulBehavior) {
     const bool isSRGBTransferFn =
@@ -59,7 +64,7 @@ static transform_scanline_proc choose_proc(const SkImageInfo& info,
         case kRGBA_8888_SkColorType:
             switch (info.alphaType()) {
                 case kOpaque_SkAlphaType:
-                    return transform_scanline_RGBX;
+                    return transform_scanline_memcpy;
                 case kUnpremul_SkAlphaType:
                     return transform_scanline_memcpy;
                 case kPremul_SkAlphaType:
@@ -72,7 +77,7 @@ static transform_scanline_proc choose_proc(const SkImageInfo& info,
         case kBGRA_8888_SkColorType:
             switch (info.alphaType()) {
                 case kOpaque_SkAlphaType:
-                    return transform_scanline_BGRX;
+                    return transform_scanline_BGRA;
                 case kUnpremul_SkAlphaType:
                     return transform_scanline_BGRA;
                 case kPremul_SkAlphaType:
@@ -83,11 +88,11 @@ static transform_scanline_proc choose_proc(const SkImageInfo& info,
                     return nullptr;
             }
         case kRGB_565_SkColorType:
-            return transform_scanline_565;
+            return transform_scanline_565_to_RGBX;
         case kARGB_4444_SkColorType:
             switch (info.alphaType()) {
                 case kOpaque_SkAlphaType:
-                    return transform_scanline_444;
+                    return transform_scanline_444_to_RGBX;
                 case kPremul_SkAlphaType:
                     // 4444 is assumed to be legacy premul.
                     return transform_scanline_4444;
@@ -178,7 +183,7 @@ static inline int pack_palette(SkColorTable* ctable, png_color* SK_RESTRICT pale
 }
 
 static bool do_encode(SkWStream*, const SkPixmap&, int, int, png_color_8&,
-                      SkTransferFunctionBehavior unpremulBehavior);
+                      const SkEncodeOptions&);
 
 bool SkEncodeImageAsPNG(SkWStream* stream, const SkPixmap& pixmap, const SkEncodeOptions& opts) {
     if (SkTransferFunctionBehavior::kRespect == opts.fUnpremulBehavior) {
@@ -192,6 +197,10 @@ bool SkEncodeImageAsPNG(SkWStream* stream, const SkPixmap& pixmap, const SkEncod
         return false;
     }
 
+    if (opts.fPNGZLibLevel < 0 || opts.fPNGZLibLevel > 9) {
+        return false;
+    }
+
     const SkColorType colorType = pixmap.colorType();
     const SkAlphaType alphaType = pixmap.alphaType();
     switch (alphaType) {
@@ -275,7 +284,7 @@ bool SkEncodeImageAsPNG(SkWStream* stream, const SkPixmap& pixmap, const SkEncod
         // or 4 bit indices.
     }
 
-    return do_encode(stream, pixmap, pngColorType, bitDepth, sig_bit, opts.fUnpremulBehavior);
+    return do_encode(stream, pixmap, pngColorType, bitDepth, sig_bit, opts);
 }
 
 static int num_components(int pngColorType) {
@@ -293,8 +302,313 @@ static int num_components(int pngColorType) {
     }
 }
 
+// The filter types a PNG row may be written with.  The type is stored in the first byte of each
+// filtered row.
+enum PngFilterType {
+    kNone_PngFilterType,
+    kSub_PngFilterType,
+    kUp_PngFilterType,
+    kAvg_PngFilterType,
+    kPaeth_PngFilterType,
+
+    kLast_PngFilterType = kPaeth_PngFilterType,
+};
+static const int kPngFilterTypeCount = kLast_PngFilterType + 1;
+
+// Unfiltered rows are stored with this many zero bytes in front of them, so the filters can always
+// read the "left" pixel, and at least 4 bytes behind them, so the last Sk4b load stays in bounds.
+static const int kPngRowPad = 8;
+
+// Each band of rows handed to a task holds roughly this much filtered data.  This matches pigz.
+static const size_t kPngBandBytes = 128 * 1024;
+
+// The deflate window, which is also the largest useful preset dictionary.
+static const size_t kPngWindowBytes = 32 * 1024;
+
+static inline Sk4i abs_4i(const Sk4i& v) {
+    return (v < 0).thenElse(Sk4i(0) - v, v);
+}
+
+static inline Sk4i load_4i(const uint8_t* ptr) {
+    return SkNx_cast<int32_t>(Sk4b::Load(ptr));
+}
+
+/*
+ *  Filters one row with a single filter type, four bytes at a time.  x is the unfiltered row and b
+ *  is the unfiltered row above it; both have kPngRowPad zero bytes in front of them.  Returns the
+ *  sum of the filtered bytes interpreted as signed magnitudes, the heuristic libpng uses to pick
+ *  among filter types.
+ */
+template <PngFilterType kType>
+static uint32_t filter_row(uint8_t* dst, const uint8_t* x, const uint8_t* b, int bpp, int n) {
+    const uint8_t* a = x - bpp;
+    const uint8_t* c = b - bpp;
+
+    auto filter = [](const Sk4i& x, const Sk4i& a, const Sk4i& b, const Sk4i& c) -> Sk4i {
+        switch (kType) {
+            case kNone_PngFilterType:
+                return x;
+            case kSub_PngFilterType:
+                return x - a;
+            case kUp_PngFilterType:
+                return x - b;
+            case kAvg_PngFilterType:
+                return x - ((a + b) >> 1);
+            case kPaeth_PngFilterType: {
+                Sk4i pa = abs_4i(b - c),
+                     pb = abs_4i(a - c),
+                     pc = abs_4i(a + b - c - c);
+                Sk4i notA = (pa > pb) | (pa > pc);
+                return x - notA.thenElse((pb > pc).thenElse(c, b), a);
+            }
+        }
+        return x;
+    };
+
+    Sk4i cost(0);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        Sk4i f = filter(load_4i(x + i), load_4i(a + i), load_4i(b + i), load_4i(c + i)) & 0xFF;
+        SkNx_cast<uint8_t>(f).store(dst + i);
+        cost = cost + (f < 128).thenElse(f, Sk4i(256) - f);
+    }
+    uint32_t sum = cost[0] + cost[1] + cost[2] + cost[3];
+
+    if (i < n) {
+        // The padding behind each row keeps these loads in bounds.  Only keep the lanes we need.
+        Sk4i f = filter(load_4i(x + i), load_4i(a + i), load_4i(b + i), load_4i(c + i)) & 0xFF;
+        for (int k = 0; i < n; i++, k++) {
+            dst[i] = f[k];
+            sum += f[k] < 128 ? f[k] : 256 - f[k];
+        }
+    }
+    return sum;
+}
+
+/*
+ *  Writes the adaptively filtered version of row x into dst: the filter type byte, followed by
+ *  n filtered bytes.  Only the filter types in filterFlags (PNG_FILTER_NONE, etc.) are tried.
+ *  scratch must have room for kPngFilterTypeCount rows of n bytes.
+ */
+static void filter_row_adaptive(uint8_t* dst, const uint8_t* x, const uint8_t* b, int bpp, int n,
+                                int filterFlags, uint8_t* scratch) {
+    typedef uint32_t (*FilterProc)(uint8_t*, const uint8_t*, const uint8_t*, int, int);
+    static const FilterProc kProcs[kPngFilterTypeCount] = {
+        filter_row<kNone_PngFilterType>,
+        filter_row<kSub_PngFilterType>,
+        filter_row<kUp_PngFilterType>,
+        filter_row<kAvg_PngFilterType>,
+        filter_row<kPaeth_PngFilterType>,
+    };
+
+    int best = -1;
+    uint32_t bestCost = 0;
+    for (int type = 0; type < kPngFilterTypeCount; type++) {
+        if (!(filterFlags & (PNG_FILTER_NONE << type))) {
+            continue;
+        }
+
+        uint32_t cost = kProcs[type](scratch + type*n, x, b, bpp, n);
+        if (best < 0 || cost < bestCost) {
+            best = type;
+            bestCost = cost;
+        }
+    }
+    SkASSERT(best >= 0);
+
+    dst[0] = (uint8_t) best;
+    memcpy(dst + 1, scratch + best*n, n);
+}
+
+/*
+ *  Deflates len bytes of src as a raw deflate stream, primed with the dictLen bytes in front of
+ *  src.  Unless last is set, the stream ends with a sync flush so that it may be concatenated
+ *  with the stream for the bytes that follow.
+ */
+static bool deflate_band(const uint8_t* src, size_t len, size_t dictLen, bool last, int level,
+                         SkAutoTMalloc<uint8_t>* dst, size_t* dstLen) {
+    z_stream z;
+    sk_bzero(&z, sizeof(z_stream));
+    if (Z_OK != deflateInit2(&z, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY)) {
+        return false;
+    }
+
+    if (dictLen > 0 && Z_OK != deflateSetDictionary(&z, src - dictLen, (uInt) dictLen)) {
+        deflateEnd(&z);
+        return false;
+    }
+
+    // A sync flush adds an empty stored block that deflateBound() does not account for.
+    size_t capacity = deflateBound(&z, (uLong) len) + 16;
+    dst->reset(capacity);
+    z.next_in = const_cast<uint8_t*>(src);
+    z.avail_in = (uInt) len;
+    z.next_out = dst->get();
+    z.avail_out = (uInt) capacity;
+
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    for (;;) {
+        if (Z_STREAM_ERROR == deflate(&z, flush)) {
+            deflateEnd(&z);
+            return false;
+        }
+
+        if (z.avail_out != 0) {
+            break;
+        }
+
+        // Out of room (this should not happen given deflateBound()), so grow and keep going.
+        size_t used = capacity;
+        capacity *= 2;
+        dst->realloc(capacity);
+        z.next_out = dst->get() + used;
+        z.avail_out = (uInt) (capacity - used);
+    }
+
+    *dstLen = capacity - z.avail_out;
+    deflateEnd(&z);
+    return true;
+}
+
+static uint16_t zlib_header(int level) {
+    int levelFlags;
+    if (level < 2) {
+        levelFlags = 0;
+    } else if (level < 6) {
+        levelFlags = 1;
+    } else if (6 == level) {
+        levelFlags = 2;
+    } else {
+        levelFlags = 3;
+    }
+
+    // 32K window deflate, with the check bits set so the header is a multiple of 31.
+    uint16_t header = (Z_DEFLATED + ((15 - 8) << 4)) << 8;
+    header |= levelFlags << 6;
+    header += 31 - (header % 31);
+    return header;
+}
+
+/*
+ *  Writes the IDAT chunks for pixmap, splitting the work across executor in the style of pigz.
+ *  Bands of rows are transformed and filtered in parallel.  Then each band is deflated on its own,
+ *  primed with the filtered bytes just before it, and the raw deflate streams are stitched into a
+ *  single zlib stream with one IDAT chunk per band.
+ */
+static bool write_idat_parallel(png_structp png_ptr, const SkPixmap& pixmap,
+                                transform_scanline_proc proc, int procBytesPerPixel,
+                                int pngBytesPerPixel, int filterFlags, int level,
+                                SkExecutor* executor) {
+    const int width = pixmap.width();
+    const int height = pixmap.height();
+    const int srcBytesPerPixel = SkColorTypeBytesPerPixel(pixmap.colorType());
+    const int rowBytes = width * pngBytesPerPixel;
+    const size_t filteredRowBytes = 1 + rowBytes;
+    const int bandRows = SkTMax(1, (int) (kPngBandBytes / filteredRowBytes));
+    const int bandCount = (height + bandRows - 1) / bandRows;
+
+    SkAutoTMalloc<uint8_t> filtered(filteredRowBytes * height);
+    SkTaskGroup tasks(*executor);
+    tasks.batch(bandCount, [&](int band) {
+        const int top = band * bandRows;
+        const int bottom = SkTMin(top + bandRows, height);
+
+        // Two unfiltered rows (this one and the one above), room for each filter type, and room
+        // for a transformed row that still has its filler bytes.
+        const size_t paddedRowBytes = kPngRowPad + rowBytes + kPngRowPad;
+        const size_t fillerRowBytes = width * procBytesPerPixel;
+        SkAutoTMalloc<uint8_t> storage(2 * paddedRowBytes + kPngFilterTypeCount * rowBytes +
+                                       fillerRowBytes);
+        sk_bzero(storage.get(), 2 * paddedRowBytes);
+        uint8_t* prev = storage.get() + kPngRowPad;
+        uint8_t* curr = prev + paddedRowBytes;
+        uint8_t* scratch = storage.get() + 2 * paddedRowBytes;
+        uint8_t* fillerRow = scratch + kPngFilterTypeCount * rowBytes;
+
+        auto transform = [&](uint8_t* dst, int y) {
+            const char* src = (const char*) pixmap.addr(0, y);
+            if (procBytesPerPixel == pngBytesPerPixel) {
+                proc((char*) dst, src, width, srcBytesPerPixel, nullptr);
+                return;
+            }
+
+            // Strip the filler, as libpng would.
+            proc((char*) fillerRow, src, width, srcBytesPerPixel, nullptr);
+            for (int i = 0; i < width; i++) {
+                memcpy(dst + i * pngBytesPerPixel, fillerRow + i * procBytesPerPixel,
+                       pngBytesPerPixel);
+            }
+        };
+
+        if (top > 0) {
+            transform(prev, top - 1);
+        }
+        for (int y = top; y < bottom; y++) {
+            transform(curr, y);
+            filter_row_adaptive(filtered.get() + y * filteredRowBytes, curr, prev,
+                                pngBytesPerPixel, rowBytes, filterFlags, scratch);
+            SkTSwap(prev, curr);
+        }
+    });
+    tasks.wait();
+
+    struct Band {
+        SkAutoTMalloc<uint8_t> fData;
+        size_t                 fLength = 0;
+        uLong                  fAdler = 0;
+        bool                   fSuccess = false;
+    };
+    SkAutoTArray<Band> bands(bandCount);
+    tasks.batch(bandCount, [&](int band) {
+        const size_t start = band * bandRows * filteredRowBytes;
+        const size_t end = SkTMin(band * bandRows + bandRows, height) * filteredRowBytes;
+        const uint8_t* src = filtered.get() + start;
+        bands[band].fAdler = adler32(adler32(0L, Z_NULL, 0), src, (uInt) (end - start));
+        bands[band].fSuccess = deflate_band(src, end - start, SkTMin(start, kPngWindowBytes),
+                                            band == bandCount - 1, level, &bands[band].fData,
+                                            &bands[band].fLength);
+    });
+    tasks.wait();
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+    for (int band = 0; band < bandCount; band++) {
+        if (!bands[band].fSuccess) {
+            return false;
+        }
+        const size_t start = band * bandRows * filteredRowBytes;
+        const size_t end = SkTMin(band * bandRows + bandRows, height) * filteredRowBytes;
+        adler = adler32_combine(adler, bands[band].fAdler, (z_off_t) (end - start));
+    }
+
+    const uint16_t header = zlib_header(level);
+    const uint8_t headerBytes[2] = { (uint8_t) (header >> 8), (uint8_t) (header & 0xFF) };
+    const uint8_t adlerBytes[4] = { (uint8_t) (adler >> 24), (uint8_t) (adler >> 16),
+                                    (uint8_t) (adler >>  8), (uint8_t) (adler >>  0) };
+    for (int band = 0; band < bandCount; band++) {
+        const bool first = (0 == band);
+        const bool last = (bandCount - 1 == band);
+        const size_t length = (first ? sizeof(headerBytes) : 0) + bands[band].fLength +
+                              (last ? sizeof(adlerBytes) : 0);
+        png_write_chunk_start(png_ptr, (png_bytep) "IDAT", (png_uint_32) length);
+        if (first) {
+            png_write_chunk_data(png_ptr, (png_bytep) headerBytes, sizeof(headerBytes));
+        }
+        png_write_chunk_data(png_ptr, bands[band].fData.get(), bands[band].fLength);
+        if (last) {
+            png_write_chunk_data(png_ptr, (png_bytep) adlerBytes, sizeof(adlerBytes));
+        }
+        png_write_chunk_end(png_ptr);
+    }
+
+    // We wrote the image data ourselves, so libpng would complain from png_write_end().
+    // Nothing follows the image data, so IEND is all that is left.
+    png_write_chunk(png_ptr, (png_bytep) "IEND", nullptr, 0);
+    return true;
+}
+
 static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, int pngColorType, int bitDepth,
-                      png_color_8& sig_bit, SkTransferFunctionBehavior unpremulBehavior) {
+                      png_color_8& sig_bit, const SkEncodeOptions& opts) {
+    const SkTransferFunctionBehavior unpremulBehavior = opts.fUnpremulBehavior;
     png_structp png_ptr;
     png_infop info_ptr;
 
@@ -356,20 +670,37 @@ static bool do_encode(SkWStream* stream, const SkPixmap& pixmap, int pngColorTyp
         }
     }
 
+    int filterFlags = (int) opts.fPNGFilterFlags & PNG_ALL_FILTERS;
+    if (!filterFlags || (PNG_COLOR_TYPE_PALETTE == pngColorType &&
+                         SkEncodeOptions::PNGFilterFlags::kAll == opts.fPNGFilterFlags)) {
+        // Like libpng, leave palette images unfiltered unless the caller picked filters.
+        filterFlags = PNG_FILTER_NONE;
+    }
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, filterFlags);
+    png_set_compression_level(png_ptr, opts.fPNGZLibLevel);
+
     png_set_sBIT(png_ptr, info_ptr, &sig_bit);
     png_write_info(png_ptr, info_ptr);
-    int pngBytesPerPixel = num_components(pngColorType) * (bitDepth / 8);
-    if (kRGBA_F16_SkColorType == pixmap.colorType() && kOpaque_SkAlphaType == pixmap.alphaType()) {
-        // For kOpaque, kRGBA_F16, we will keep the row as RGBA and tell libpng
-        // to skip the alpha channel.
+    const int pngBytesPerPixel = num_components(pngColorType) * (bitDepth / 8);
+    int procBytesPerPixel = pngBytesPerPixel;
+    if (PNG_COLOR_TYPE_RGB == pngColorType) {
+        // Opaque rows are transformed to RGBX, and we tell libpng to skip the filler.
         png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
-        pngBytesPerPixel = 8;
+        procBytesPerPixel = 4 * (bitDepth / 8);
     }
 
-    SkAutoSTMalloc<1024, char> rowStorage(pixmap.width() * pngBytesPerPixel);
+    transform_scanline_proc proc = choose_proc(pixmap.info(), unpremulBehavior);
+    if (opts.fExecutor) {
+        const bool success = write_idat_parallel(png_ptr, pixmap, proc, procBytesPerPixel,
+                                                 pngBytesPerPixel, filterFlags,
+                                                 opts.fPNGZLibLevel, opts.fExecutor);
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        return success;
+    }
+
+    SkAutoSTMalloc<1024, char> rowStorage(pixmap.width() * procBytesPerPixel);
     char* storage = rowStorage.get();
     const char* srcImage = (const char*)pixmap.addr();
-    transform_scanline_proc proc = choose_proc(pixmap.info(), unpremulBehavior);
     for (int y = 0; y < pixmap.height(); y++) {
         png_bytep row_ptr = (png_bytep)storage;
         proc(storage, srcImage, pixmap.width(), SkColorTypeBytesPerPixel(pixmap.colorType()),
@@ -6,11 +6,16 @@
  */
 
 #include "SkArenaAlloc.h"
+#include "SkExecutor.h"
 #include "SkMatrix.h"
 #include "SkOpEdgeBuilder.h"
 #include "SkPathPriv.h"
 #include "SkPathOps.h"
 #include "SkPathOpsCommon.h"
+#include "SkTaskGroup.h"
+#include "SkTSort.h"
+
+#include <atomic>
 
 static bool one_contour(const SkPath& path) {
     char storage[256];
@@ -122,12 +127,165 @@ void SkOpBuilder::reset() {
     fOps.reset();
 }
 
+// Bounds that merely touch still count, so that paths sharing an edge are merged into one contour.
+static bool bounds_meet(const SkRect& a, const SkRect& b) {
+    return a.fLeft <= b.fRight && b.fLeft <= a.fRight && a.fTop <= b.fBottom && b.fTop <= a.fBottom;
+}
+
+static int find_root(SkTDArray<int>& parents, int index) {
+    while (parents[index] != index) {
+        parents[index] = parents[parents[index]];
+        index = parents[index];
+    }
+    return index;
+}
+
+// Splits the non-empty paths into groups whose bounds meet, directly or through other members.
+// No two groups share any area, so the union of each can be found on its own.
+static void group_by_bounds(const SkTArray<SkPath>& paths, SkTArray<SkTArray<SkPath>>* groups) {
+    SkTDArray<int> order;
+    for (int index = 0; index < paths.count(); ++index) {
+        if (!paths[index].isEmpty()) {
+            *order.append() = index;
+        }
+    }
+    if (order.count() > 1) {
+        SkTQSort(order.begin(), order.end() - 1, [&paths](int a, int b) {
+            return paths[a].getBounds().fLeft < paths[b].getBounds().fLeft;
+        });
+    }
+
+    // Sweep left to right, keeping the paths whose bounds still reach the sweep line.
+    SkTDArray<int> parents;
+    parents.setCount(paths.count());
+    for (int index = 0; index < paths.count(); ++index) {
+        parents[index] = index;
+    }
+    SkTDArray<int> active;
+    for (int index : order) {
+        const SkRect& bounds = paths[index].getBounds();
+        for (int a = active.count() - 1; a >= 0; --a) {
+            const SkRect& other = paths[active[a]].getBounds();
+            if (other.fRight < bounds.fLeft) {
+                active.removeShuffle(a);
+            } else if (bounds_meet(bounds, other)) {
+                parents[find_root(parents, active[a])] = find_root(parents, index);
+            }
+        }
+        *active.append() = index;
+    }
+
+    SkTDArray<int> groupOf;
+    groupOf.setCount(paths.count());
+    for (int index : order) {
+        int root = find_root(parents, index);
+        if (root == index) {
+            groupOf[root] = groups->count();
+            groups->push_back();
+        }
+    }
+    for (int index : order) {
+        (*groups)[groupOf[find_root(parents, index)]].push_back(paths[index]);
+    }
+}
+
+// Every operand is a union, so they may be combined in any order: disjoint groups on their own,
+// and the paths within each pairwise, halving their number with each round of Op() calls.  Each
+// call builds its contours in an SkArenaAlloc of its own, so the calls share no state.
+bool SkOpBuilder::resolveUnions(SkPath* result, SkExecutor* executor) {
+    bool anyInverse = false;
+    for (const SkPath& path : fPathRefs) {
+        anyInverse |= path.isInverseFillType();
+    }
+    SkTArray<SkTArray<SkPath>> groups;
+    if (anyInverse) {
+        // The area outside an inverse path's bounds is part of it, so nothing is disjoint.
+        groups.push_back(fPathRefs);
+    } else {
+        group_by_bounds(fPathRefs, &groups);
+    }
+    reset();
+
+    std::atomic<bool> failed{false};
+    SkTaskGroup taskGroup(*executor);
+    // A group that starts out with a single path just needs simplifying.
+    for (SkTArray<SkPath>& group : groups) {
+        if (1 == group.count()) {
+            SkPath* path = &group[0];
+            taskGroup.add([path, &failed] {
+                if (!Simplify(*path, path)) {
+                    failed = true;
+                }
+            });
+        }
+    }
+    for (;;) {
+        bool reduced = false;
+        for (SkTArray<SkPath>& group : groups) {
+            for (int index = 0; index + 1 < group.count(); index += 2) {
+                SkPath* one = &group[index];
+                const SkPath* two = &group[index + 1];
+                taskGroup.add([one, two, &failed] {
+                    if (!Op(*one, *two, kUnion_SkPathOp, one)) {
+                        failed = true;
+                    }
+                });
+                reduced = true;
+            }
+        }
+        taskGroup.wait();
+        if (failed) {
+            return false;
+        }
+        if (!reduced) {
+            break;
+        }
+        // Keep the pairs' unions, and the odd path out, for the next round.
+        for (SkTArray<SkPath>& group : groups) {
+            int kept = 0;
+            for (int index = 0; index < group.count(); index += 2) {
+                group[kept++] = group[index];
+            }
+            group.resize_back(kept);
+        }
+    }
+
+    if (groups.empty()) {
+        result->reset();
+        return true;
+    }
+    if (1 == groups.count()) {
+        *result = groups[0][0];
+        return true;
+    }
+    SkPath sum;
+    for (const SkTArray<SkPath>& group : groups) {
+        sum.addPath(group[0]);
+    }
+    sum.setFillType(groups[0][0].getFillType());
+    *result = sum;
+    return true;
+}
+
 /* OPTIMIZATION: Union doesn't need to be all-or-nothing. A run of three or more convex
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
-bool SkOpBuilder::resolve(SkPath* result) {
+bool SkOpBuilder::resolve(SkPath* result, SkExecutor* executor) {
     SkPath original = *result;
     int count = fOps.count();
+    if (executor && count > 1) {
+        bool allUnions = true;
+        for (int index = 0; index < count; ++index) {
+            allUnions &= kUnion_SkPathOp == fOps[index];
+        }
+        if (allUnions) {
+            if (!this->resolveUnions(result, executor)) {
+                *result = original;
+                return false;
+            }
+            return true;
+        }
+    }
     bool allUnion = true;
     SkPathPriv::FirstDirection firstDir = SkPathPriv::kUnknown_FirstDirection;
     for (int index = 0; index < count; ++index) {
@@ -0,0 +1,528 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkPathAnalysis.h"
+#include "SkPathOpsCommon.h"
+#include "SkTSort.h"
+
+#include <math.h>
+
+// The approximate op flattens both operands to polygons whose vertices snap to a grid, then
+// sweeps them top to bottom, Vatti-style. The sweep stops at every vertex and at every crossing
+// of two edges, so between stops no edges cross and the result is a row of spans, each bounded
+// by one edge on the left and one on the right. Their outline, joined across stops, is the
+// result.
+//
+// All coordinates below are in grid units, which are a quarter of the tolerance; vertices are
+// whole numbers of them. Flattening strays up to half the tolerance from the curves, and
+// snapping adds less than a quarter, so the result is within the tolerance of the exact one.
+// Conics take two steps to flatten, to quads and then to lines, and share that half between
+// them; giving each step the whole half would let conics stray up to the whole tolerance.
+
+namespace {
+
+// Past this, snapped coordinates no longer fit in the double's mantissa with room to spare.
+static const double kMaxGridCoord = 1 << 30;
+
+// Crossings closer than this to the top of a band are treated as already crossed.
+static const double kMinBandHeight = 1.0 / 1024;
+
+struct Edge {
+    double fTopX, fTopY;
+    double fBotX, fBotY;
+    int    fWinding;   // +1 if the path runs down this edge, -1 if up
+    int    fOperand;   // 0 for the first path, 1 for the second
+    int    fID;
+
+    // Which side of a span of the result this is, since fSideTop, during the sweep.
+    int    fSide;
+    int    fNextSide;
+    double fSideTop;
+
+    // Exact at either end, so edges sharing a vertex agree on where it is.
+    double xAt(double y) const {
+        if (y <= fTopY) {
+            return fTopX;
+        }
+        if (y >= fBotY) {
+            return fBotX;
+        }
+        return fTopX + (fBotX - fTopX) * ((y - fTopY) / (fBotY - fTopY));
+    }
+};
+
+// A piece of the result's outline. Outlines run clockwise, with the inside on their right.
+struct Segment {
+    double fFromX, fFromY;
+    double fToX, fToY;
+    int    fID;    // the edge this lies along, or -1 for horizontal pieces
+    bool   fUsed;
+};
+
+class EdgeBuilder {
+public:
+    EdgeBuilder(double scale, SkScalar flattenTolerance, SkTDArray<Edge>* edges)
+        : fScale(scale), fFlattenTolerance(flattenTolerance), fEdges(edges) {}
+
+    // Returns false if a point is not finite or is too far out to snap to the grid.
+    bool addPath(const SkPath& path, int operand) {
+        fOperand = operand;
+        // Clip paths are often combined again and again; their flattening is kept with them.
+        // The polyline is within fFlattenTolerance of conics too, not just of each step.
+        SkPath polyline = SkPathPriv::Analysis(path)->polyline(path, fFlattenTolerance);
+        SkPath::Iter iter(polyline, true);
+        SkPoint pts[4];
+        SkPath::Verb verb;
+        while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+            switch (verb) {
+                case SkPath::kMove_Verb:
+                    if (!this->snap(pts[0])) {
+                        return false;
+                    }
+                    fLastX = fSnappedX;
+                    fLastY = fSnappedY;
+                    break;
+                case SkPath::kLine_Verb:
+                    if (!this->lineTo(pts[1])) {
+                        return false;
+                    }
+                    break;
+                default:
+                    SkASSERT(SkPath::kClose_Verb == verb);
+                    break;
+            }
+        }
+        return true;
+    }
+
+private:
+    bool snap(const SkPoint& pt) {
+        double x = pt.fX * fScale;
+        double y = pt.fY * fScale;
+        if (!(fabs(x) < kMaxGridCoord && fabs(y) < kMaxGridCoord)) {
+            return false;
+        }
+        fSnappedX = floor(x + 0.5);
+        fSnappedY = floor(y + 0.5);
+        return true;
+    }
+
+    bool lineTo(const SkPoint& pt) {
+        if (!this->snap(pt)) {
+            return false;
+        }
+        // Horizontal edges change no winding, so the sweep never needs them.
+        if (fSnappedY != fLastY) {
+            Edge* edge = fEdges->append();
+            if (fSnappedY > fLastY) {
+                *edge = { fLastX, fLastY, fSnappedX, fSnappedY, 1, fOperand, 0, 0, 0, 0 };
+            } else {
+                *edge = { fSnappedX, fSnappedY, fLastX, fLastY, -1, fOperand, 0, 0, 0, 0 };
+            }
+            edge->fID = fEdges->count() - 1;
+        }
+        fLastX = fSnappedX;
+        fLastY = fSnappedY;
+        return true;
+    }
+
+    double           fScale;
+    SkScalar         fFlattenTolerance;
+    SkTDArray<Edge>* fEdges;
+    int              fOperand = 0;
+    double           fLastX = 0, fLastY = 0;
+    double           fSnappedX = 0, fSnappedY = 0;
+};
+
+static bool op_inside(SkPathOp op, bool one, bool two) {
+    switch (op) {
+        case kDifference_SkPathOp:        return one && !two;
+        case kIntersect_SkPathOp:         return one && two;
+        case kUnion_SkPathOp:             return one || two;
+        case kXOR_SkPathOp:               return one != two;
+        case kReverseDifference_SkPathOp: return two && !one;
+    }
+    return false;
+}
+
+class Sweep {
+public:
+    Sweep(SkPathOp op, const SkPath& one, const SkPath& two, bool outside)
+        : fOp(op)
+        , fEvenOdd{ one.getFillType() == SkPath::kEvenOdd_FillType ||
+                    one.getFillType() == SkPath::kInverseEvenOdd_FillType,
+                    two.getFillType() == SkPath::kEvenOdd_FillType ||
+                    two.getFillType() == SkPath::kInverseEvenOdd_FillType }
+        , fInverse{ one.isInverseFillType(), two.isInverseFillType() }
+        , fOutside(outside) {}
+
+    // Sweeps the edges, leaving the outline of the part of the plane inside the result, or
+    // outside of it if the result is inverse, in fSegments.
+    void run(SkTDArray<Edge>* edges) {
+        if (edges->count() > 1) {
+            SkTQSort(edges->begin(), edges->end() - 1, [](const Edge& a, const Edge& b) {
+                return a.fTopY < b.fTopY;
+            });
+        }
+        SkTDArray<double> stops;
+        stops.setReserve(2 * edges->count());
+        for (const Edge& edge : *edges) {
+            *stops.append() = edge.fTopY;
+            *stops.append() = edge.fBotY;
+        }
+        if (stops.count() > 1) {
+            SkTQSort(stops.begin(), stops.end() - 1);
+        }
+
+        int nextEdge = 0;
+        for (int i = 0; i + 1 < stops.count(); ++i) {
+            const double top = stops[i];
+            const double bottom = stops[i + 1];
+            if (top == bottom) {
+                continue;
+            }
+            // Keep the rest in order, so sorting them again for this band is quick.
+            for (int index = fActive.count() - 1; index >= 0; --index) {
+                if (fActive[index]->fBotY <= top) {
+                    fActive.remove(index);
+                }
+            }
+            while (nextEdge < edges->count() && (*edges)[nextEdge].fTopY <= top) {
+                *fActive.append() = &(*edges)[nextEdge++];
+            }
+            this->sweepBetween(top, bottom);
+        }
+        // Close off the bottom of the last band.
+        fSpans.rewind();
+        this->endBand(fPrevY);
+    }
+
+    SkTDArray<Segment>* segments() { return &fSegments; }
+
+private:
+    enum Side {
+        kNone_Side,
+        kLeft_Side,
+        kRight_Side,
+    };
+
+    struct Span {
+        Edge* fLeft;
+        Edge* fRight;
+    };
+
+    struct Event {
+        double fX;
+        int    fCoverage;   // change in how much more is inside below y than above it
+    };
+
+    bool inside(const int winding[2]) const {
+        bool in[2];
+        for (int operand = 0; operand < 2; ++operand) {
+            in[operand] = (fEvenOdd[operand] ? winding[operand] & 1 : winding[operand] != 0)
+                          != fInverse[operand];
+        }
+        return op_inside(fOp, in[0], in[1]) != fOutside;
+    }
+
+    // Sorts the active edges by x at y, or if they meet there, by x at bottom. Between bands
+    // only the edges that crossed move, so an insertion sort is nearly linear.
+    void sortActive(double y, double bottom) {
+        if (fActive.count() > 1) {
+            SkTInsertionSort(fActive.begin(), fActive.end() - 1, [=](const Edge* a, const Edge* b) {
+                double ax = a->xAt(y), bx = b->xAt(y);
+                return ax < bx || (ax == bx && a->xAt(bottom) < b->xAt(bottom));
+            });
+        }
+    }
+
+    // Splits [top, bottom) into bands wherever two active edges cross.
+    void sweepBetween(double top, double bottom) {
+        while (top < bottom) {
+            // Order the edges just below top, so those crossing right at it are already swapped.
+            const double y = top + SkTMin(kMinBandHeight, (bottom - top) / 2);
+            this->sortActive(y, bottom);
+            // The first crossing below y is between two edges that are neighbors at y.
+            double bandBottom = bottom;
+            for (int i = 0; i + 1 < fActive.count(); ++i) {
+                const double d0 = fActive[i + 1]->xAt(y) - fActive[i]->xAt(y);
+                const double d1 = fActive[i + 1]->xAt(bottom) - fActive[i]->xAt(bottom);
+                if (d1 < 0) {
+                    const double cross = y + (bottom - y) * (d0 / (d0 - d1));
+                    if (cross > top && cross < bandBottom) {
+                        bandBottom = cross;
+                    }
+                }
+            }
+            this->addBand(top, bandBottom);
+            top = bandBottom;
+        }
+    }
+
+    // Finds the spans inside the result between top and bottom, where no edges cross.
+    void addBand(double top, double bottom) {
+        this->sortActive((top + bottom) / 2, bottom);
+
+        fSpans.rewind();
+        int winding[2] = { 0, 0 };
+        bool wasInside = false;
+        for (Edge* edge : fActive) {
+            winding[edge->fOperand] += edge->fWinding;
+            const bool isInside = this->inside(winding);
+            if (isInside == wasInside) {
+                continue;
+            }
+            wasInside = isInside;
+            if (!isInside) {
+                Span& span = fSpans.top();
+                span.fRight = edge;
+                if (span.fLeft->xAt(top) == edge->xAt(top) &&
+                        span.fLeft->xAt(bottom) == edge->xAt(bottom)) {
+                    // Edges that coincide, as when a path is combined with itself.
+                    fSpans.pop();
+                }
+            } else if (fSpans.count() && fSpans.top().fRight->xAt(top) == edge->xAt(top) &&
+                       fSpans.top().fRight->xAt(bottom) == edge->xAt(bottom)) {
+                // A span starting right where the last one ends just continues it.
+                fSpans.top().fRight = nullptr;
+            } else {
+                *fSpans.append() = { edge, nullptr };
+            }
+        }
+        // Every contour crosses the band as often going up as going down.
+        SkASSERT(!wasInside);
+
+        this->endBand(top);
+        fPrevY = bottom;
+    }
+
+    // Moves on from the spans of the band ending at y to those in fSpans, starting at y.
+    //
+    // Each edge on the side of a span is a side of the result's outline until it stops being
+    // one; only then is that stretch of it added to fSegments. Where the spans change, the
+    // horizontal pieces of outline between the old spans and the new are added. Most bands
+    // change a span or two, if any, so only the spans between those both share are visited.
+    void endBand(double y) {
+        const int count = SkTMin(fSpans.count(), fPrevSpans.count());
+        int prefix = 0;
+        while (prefix < count && this->sameSpan(prefix, prefix)) {
+            ++prefix;
+        }
+        int suffix = 0;
+        while (suffix < count - prefix &&
+                this->sameSpan(fSpans.count() - 1 - suffix, fPrevSpans.count() - 1 - suffix)) {
+            ++suffix;
+        }
+        const int spansEnd = fSpans.count() - suffix;
+        const int prevSpansEnd = fPrevSpans.count() - suffix;
+        if (prefix == spansEnd && prefix == prevSpansEnd) {
+            return;
+        }
+
+        for (int i = prefix; i < spansEnd; ++i) {
+            fSpans[i].fLeft->fNextSide = kLeft_Side;
+            fSpans[i].fRight->fNextSide = kRight_Side;
+        }
+        for (int i = prefix; i < prevSpansEnd; ++i) {
+            this->endSide(fPrevSpans[i].fLeft, y);
+            this->endSide(fPrevSpans[i].fRight, y);
+        }
+        for (int i = prefix; i < spansEnd; ++i) {
+            this->startSide(fSpans[i].fLeft, y);
+            this->startSide(fSpans[i].fRight, y);
+        }
+        this->addHorizontals(y, prefix, spansEnd, prevSpansEnd);
+        fPrevSpans.swap(fSpans);
+    }
+
+    bool sameSpan(int index, int prevIndex) const {
+        return fSpans[index].fLeft == fPrevSpans[prevIndex].fLeft &&
+               fSpans[index].fRight == fPrevSpans[prevIndex].fRight;
+    }
+
+    void endSide(Edge* edge, double y) {
+        if (edge->fSide == edge->fNextSide) {
+            return;
+        }
+        // Left sides run up, and right sides down.
+        if (kLeft_Side == edge->fSide) {
+            *fSegments.append() = { edge->xAt(y), y, edge->xAt(edge->fSideTop), edge->fSideTop,
+                                    edge->fID, false };
+        } else {
+            *fSegments.append() = { edge->xAt(edge->fSideTop), edge->fSideTop, edge->xAt(y), y,
+                                    edge->fID, false };
+        }
+        edge->fSide = kNone_Side;
+    }
+
+    void startSide(Edge* edge, double y) {
+        if (edge->fSide != edge->fNextSide) {
+            edge->fSide = edge->fNextSide;
+            edge->fSideTop = y;
+        }
+        edge->fNextSide = kNone_Side;
+    }
+
+    // Adds the horizontal pieces at y where the part inside the result above (fPrevSpans)
+    // differs from the part inside it below (fSpans), between the spans both share.
+    //
+    // Where two edges cross right at y, rounding may leave a span a sliver wider than zero with
+    // its ends swapped. Counting coverage with signs, and adding a piece once per unit of
+    // difference, still joins every side up with the pieces around it.
+    void addHorizontals(double y, int prefix, int spansEnd, int prevSpansEnd) {
+        SkTDArray<Event>& events = fEvents;
+        events.rewind();
+        for (int i = prefix; i < prevSpansEnd; ++i) {
+            *events.append() = { fPrevSpans[i].fLeft->xAt(y), -1 };
+            *events.append() = { fPrevSpans[i].fRight->xAt(y), 1 };
+        }
+        for (int i = prefix; i < spansEnd; ++i) {
+            *events.append() = { fSpans[i].fLeft->xAt(y), 1 };
+            *events.append() = { fSpans[i].fRight->xAt(y), -1 };
+        }
+        if (events.count() > 1) {
+            SkTQSort(events.begin(), events.end() - 1, [](const Event& a, const Event& b) {
+                return a.fX < b.fX;
+            });
+        }
+        int coverage = 0;
+        for (int i = 0; i + 1 < events.count(); ++i) {
+            coverage += events[i].fCoverage;
+            const double x0 = events[i].fX, x1 = events[i + 1].fX;
+            if (x0 == x1) {
+                continue;
+            }
+            // The top of a region runs left to right, and the bottom of one right to left.
+            for (int n = 0; n < coverage; ++n) {
+                *fSegments.append() = { x0, y, x1, y, -1, false };
+            }
+            for (int n = 0; n < -coverage; ++n) {
+                *fSegments.append() = { x1, y, x0, y, -1, false };
+            }
+        }
+    }
+
+    SkPathOp            fOp;
+    bool                fEvenOdd[2];
+    bool                fInverse[2];
+    bool                fOutside;
+    SkTDArray<Edge*>    fActive;
+    SkTDArray<Span>     fSpans;
+    SkTDArray<Span>     fPrevSpans;
+    SkTDArray<Event>    fEvents;
+    SkTDArray<Segment>  fSegments;
+    double              fPrevY = 0;
+};
+
+// Joins the segments, which meet end to end, into closed contours. Vertices between two pieces
+// of the same edge, or two horizontal pieces, are dropped.
+static void join_segments(SkTDArray<Segment>* segments, double gridSize, SkPath* result) {
+    SkTDArray<Segment*> byStart;
+    byStart.setReserve(segments->count());
+    for (Segment& segment : *segments) {
+        *byStart.append() = &segment;
+    }
+    auto startsBefore = [](const Segment* a, double x, double y) {
+        return a->fFromY < y || (a->fFromY == y && a->fFromX < x);
+    };
+    if (byStart.count() > 1) {
+        SkTQSort(byStart.begin(), byStart.end() - 1, [&](const Segment* a, const Segment* b) {
+            return startsBefore(a, b->fFromX, b->fFromY);
+        });
+    }
+
+    SkTDArray<const Segment*> contour;
+    SkTDArray<SkPoint> corners;
+    for (Segment* first : byStart) {
+        if (first->fUsed) {
+            continue;
+        }
+        contour.rewind();
+        Segment* segment = first;
+        do {
+            segment->fUsed = true;
+            *contour.append() = segment;
+            // Find an unused segment starting where this one ends.
+            const double x = segment->fToX, y = segment->fToY;
+            int lo = 0, hi = byStart.count();
+            while (lo < hi) {
+                int probe = (lo + hi) / 2;
+                if (startsBefore(byStart[probe], x, y)) {
+                    lo = probe + 1;
+                } else {
+                    hi = probe;
+                }
+            }
+            segment = nullptr;
+            for (; lo < byStart.count() && byStart[lo]->fFromX == x && byStart[lo]->fFromY == y;
+                    ++lo) {
+                if (!byStart[lo]->fUsed) {
+                    segment = byStart[lo];
+                    break;
+                }
+            }
+        } while (segment);
+
+        // Start at a corner, so every kept vertex is one.
+        const int count = contour.count();
+        int start = 0;
+        while (start < count && contour[(start + count - 1) % count]->fID == contour[start]->fID) {
+            ++start;
+        }
+        if (start == count) {
+            continue;
+        }
+        corners.rewind();
+        for (int i = 0; i < count; ++i) {
+            const Segment* current = contour[(start + i) % count];
+            if (0 == i || current->fID != contour[(start + i - 1) % count]->fID) {
+                // Slivers where edges cross may leave corners a rounding error apart.
+                SkPoint corner = SkPoint::Make(SkDoubleToScalar(current->fFromX * gridSize),
+                                               SkDoubleToScalar(current->fFromY * gridSize));
+                if (corners.isEmpty() || corners.top() != corner) {
+                    *corners.append() = corner;
+                }
+            }
+        }
+        if (corners.count() > 1 && corners.top() == corners[0]) {
+            corners.pop();
+        }
+        if (corners.count() < 3) {
+            continue;
+        }
+        result->addPoly(corners.begin(), corners.count(), true);
+    }
+}
+
+} // namespace
+
+bool ApproximateOp(const SkPath& one, const SkPath& two, SkPathOp op, SkScalar tolerance,
+                   SkPath* result) {
+    SkASSERT(tolerance > 0);
+    const double gridSize = tolerance / 4;
+    const SkScalar flattenTolerance = tolerance / 2;
+    SkTDArray<Edge> edges;
+    EdgeBuilder builder(1 / gridSize, flattenTolerance, &edges);
+    if (!builder.addPath(one, 0) || !builder.addPath(two, 1)) {
+        if (!one.isFinite() || !two.isFinite()) {
+            return false;
+        }
+        // Too large to snap to this grid: fall back to the exact op.
+        return Op(one, two, op, result);
+    }
+
+    // Where neither path has edges, the result is what op makes of their fill types. If that
+    // is inside, the result is an inverse fill, and the sweep traces what it excludes instead.
+    const bool outside = op_inside(op, one.isInverseFillType(), two.isInverseFillType());
+    Sweep sweep(op, one, two, outside);
+    sweep.run(&edges);
+
+    SkPath path;
+    join_segments(sweep.segments(), gridSize, &path);
+    path.setFillType(outside ? SkPath::kInverseWinding_FillType : SkPath::kWinding_FillType);
+    result->swap(path);
+    return true;
+}
@@ -14,6 +14,8 @@ class SkOpCoincidence;
 class SkOpContour;
 class SkPathWriter;
 
+bool ApproximateOp(const SkPath& one, const SkPath& two, SkPathOp op, SkScalar tolerance,
+                   SkPath* result);
 const SkOpAngle* AngleWinding(SkOpSpanBase* start, SkOpSpanBase* end, int* windingPtr,
                               bool* sortable);
 SkOpSegment* FindChase(SkTDArray<SkOpSpanBase*>* chase, SkOpSpanBase** startPtr,
@@ -23,7 +25,8 @@ SkOpSpan* FindUndone(SkOpContourHead* );
 bool FixWinding(SkPath* path);
 bool SortContourList(SkOpContourHead** , bool evenOdd, bool oppEvenOdd);
 bool HandleCoincidence(SkOpContourHead* , SkOpCoincidence* );
-bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+             int minSweepPairs
              SkDEBUGPARAMS(bool skipAssert)
              SkDEBUGPARAMS(const char* testName));
 SkScalar ScaleFactor(const SkPath& path);
@@ -215,14 +215,15 @@ extern void (*gVerboseFinalize)();
 
 #endif
 
-bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
-        SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        int minSweepPairs SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
     char storage[4096];
     SkArenaAlloc allocator(storage);  // FIXME: add a constant expression here, tune
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
     SkOpGlobalState globalState(contourList, &allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+    globalState.setMinSweepPairs(minSweepPairs);
     SkOpCoincidence coincidence(&globalState);
 #if DEBUG_DUMP_VERIFY
 #ifndef SK_DEBUG
@@ -322,7 +323,8 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
 bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
 #if DEBUG_DUMP_VERIFY
     if (SkPathOpsDebug::gVerifyOp) {
-        if (!OpDebug(one, two, op, result  SkDEBUGPARAMS(false) SkDEBUGPARAMS(nullptr))) {
+        if (!OpDebug(one, two, op, result, SkOpGlobalState::kMinSweepPairs
+                SkDEBUGPARAMS(false) SkDEBUGPARAMS(nullptr))) {
             SkPathOpsDebug::ReportOpFail(one, two, op);
             return false;
         }
@@ -330,5 +332,15 @@ bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
         return true;
     }
 #endif
-    return OpDebug(one, two, op, result  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    return OpDebug(one, two, op, result, SkOpGlobalState::kMinSweepPairs
+            SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+}
+
+bool Op(const SkPath& one, const SkPath& two, SkPathOp op, const SkPathOpsOptions& options,
+        SkPath* result) {
+    if (SkPathOpsOptions::kApproximate_Precision == options.fPrecision &&
+            options.fTolerance > 0 && SkScalarIsFinite(options.fTolerance)) {
+        return ApproximateOp(one, two, op, options.fTolerance, result);
+    }
+    return Op(one, two, op, result);
 }
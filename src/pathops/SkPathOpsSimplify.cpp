@@ -133,7 +133,7 @@ static bool bridgeXor(SkOpContourHead* contourList, SkPathWriter* simple) {
 }
 
 // FIXME : add this as a member of SkPath
-bool SimplifyDebug(const SkPath& path, SkPath* result
+bool SimplifyDebug(const SkPath& path, SkPath* result, int minSweepPairs
         SkDEBUGPARAMS(bool skipAssert) SkDEBUGPARAMS(const char* testName)) {
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     SkPath::FillType fillType = path.isInverseFillType() ? SkPath::kInverseEvenOdd_FillType
@@ -152,6 +152,7 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
     SkOpGlobalState globalState(contourList, &allocator
             SkDEBUGPARAMS(skipAssert) SkDEBUGPARAMS(testName));
+    globalState.setMinSweepPairs(minSweepPairs);
     SkOpCoincidence coincidence(&globalState);
 #if DEBUG_DUMP_VERIFY
 #ifndef SK_DEBUG
@@ -223,7 +224,8 @@ bool SimplifyDebug(const SkPath& path, SkPath* result
 bool Simplify(const SkPath& path, SkPath* result) {
 #if DEBUG_DUMP_VERIFY
     if (SkPathOpsDebug::gVerifyOp) {
-        if (!SimplifyDebug(path, result  SkDEBUGPARAMS(false) SkDEBUGPARAMS(nullptr))) {
+        if (!SimplifyDebug(path, result, SkOpGlobalState::kMinSweepPairs
+                SkDEBUGPARAMS(false) SkDEBUGPARAMS(nullptr))) {
             SkPathOpsDebug::ReportSimplifyFail(path);
             return false;
         }
@@ -231,5 +233,6 @@ bool Simplify(const SkPath& path, SkPath* result) {
         return true;
     }
 #endif
-    return SimplifyDebug(path, result  SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+    return SimplifyDebug(path, result, SkOpGlobalState::kMinSweepPairs
+            SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
 }
@@ -5,9 +5,10 @@
  * found in the LICENSE file.
  */
 #include "SkOpEdgeBuilder.h"
+#include "SkPathAnalysis.h"
 #include "SkPathOpsCommon.h"
 
-bool TightBounds(const SkPath& path, SkRect* result) {
+static bool compute_tight_bounds(const SkPath& path, SkRect* result) {
     SkPath::RawIter iter(path);
     SkRect moveBounds = { SK_ScalarMax, SK_ScalarMax, SK_ScalarMin, SK_ScalarMin };
     bool wellBehaved = true;
@@ -86,3 +87,7 @@ bool TightBounds(const SkPath& path, SkRect* result) {
     }
     return true;
 }
+
+bool TightBounds(const SkPath& path, SkRect* result) {
+    return SkPathPriv::Analysis(path)->tightBounds(path, result, compute_tight_bounds);
+}
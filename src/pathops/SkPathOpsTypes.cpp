@@ -232,6 +232,7 @@ SkOpGlobalState::SkOpGlobalState(SkOpContourHead* head,
     : fAllocator(allocator)
     , fCoincidence(nullptr)
     , fContourHead(head)
+    , fMinSweepPairs(kMinSweepPairs)
     , fNested(0)
     , fWindingFailed(false)
     , fPhase(SkOpPhase::kIntersecting)
@@ -43,7 +43,9 @@ public:
                     SkDEBUGPARAMS(const char* testName));
 
     enum {
-        kMaxWindingTries = 10
+        kMaxWindingTries = 10,
+        // Below this many pairs of segments, trying every one costs less than sorting them.
+        kMinSweepPairs = 1024
     };
 
     bool allocatedOpSpan() const {
@@ -113,6 +115,11 @@ public:
 #endif
 
 
+    // Pairs of contours with at least this many pairs of segments are swept.
+    int minSweepPairs() const {
+        return fMinSweepPairs;
+    }
+
     int nested() const {
         return fNested;
     }
@@ -159,6 +166,10 @@ public:
         fCoincidence = coincidence;
     }
 
+    void setMinSweepPairs(int minSweepPairs) {
+        fMinSweepPairs = minSweepPairs;
+    }
+
     void setContourHead(SkOpContourHead* contourHead) {
         fContourHead = contourHead;
     }
@@ -184,6 +195,7 @@ private:
     SkArenaAlloc* fAllocator;
     SkOpCoincidence* fCoincidence;
     SkOpContourHead* fContourHead;
+    int fMinSweepPairs;
     int fNested;
     bool fAllocatedOpSpan;
     bool fWindingFailed;
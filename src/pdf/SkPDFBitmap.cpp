@@ -10,6 +10,7 @@
 #include "SkDeflate.h"
 #include "SkImage_Base.h"
 #include "SkJpegInfo.h"
+#include "SkMD5.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
 #include "SkPDFTypes.h"
@@ -525,3 +526,40 @@ sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage> image,
     #endif
     return sk_make_sp<PDFDefaultBitmap>(std::move(image), std::move(smask));
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const uint32_t kEncoded_Format = 0xFFFFFFFF;
+
+SkPDFImageContentKey SkPDFImageContentKey::Make(const SkImage* image) {
+    SkASSERT(image);
+    SkPDFImageContentKey key;
+    key.fSize = image->dimensions();
+    SkMD5 md5;
+    // Encoded data is usually smaller than the pixels and, for lazy images,
+    // digesting it avoids a decode.
+    sk_sp<SkData> data(image->refEncoded());
+    if (data) {
+        key.fFormat = kEncoded_Format;
+        md5.write(data->data(), data->size());
+        md5.finish(key.fDigest);
+        return key;
+    }
+    SkBitmap bm;
+    image_get_ro_pixels(image, &bm);
+    key.fFormat = ((uint32_t)bm.colorType() << 8) | (uint32_t)bm.alphaType();
+    SkAutoLockPixels autoLockPixels(bm);
+    if (bm.getPixels()) {
+        // Digest row by row to skip any padding between rows.
+        size_t rowBytes = (size_t)bm.width() * bm.bytesPerPixel();
+        for (int y = 0; y < bm.height(); ++y) {
+            md5.write(bm.getAddr(0, y), rowBytes);
+        }
+        if (SkColorTable* ctable = bm.getColorTable()) {
+            md5.write(ctable->readColors(), ctable->count() * sizeof(SkPMColor));
+        }
+    }
+    // Images without pixels are drawn as zeros, so all such images of one size match.
+    md5.finish(key.fDigest);
+    return key;
+}
@@ -7,7 +7,9 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "SkMD5.h"
 #include "SkRefCnt.h"
+#include "SkSize.h"
 
 class SkImage;
 class SkPixelSerializer;
@@ -21,4 +23,22 @@ class SkPDFObject;
 sk_sp<SkPDFObject> SkPDFCreateBitmapObject(sk_sp<SkImage>,
                                            SkPixelSerializer*);
 
+/**
+ *  Identifies an image by its contents rather than its uniqueID, so the
+ *  same picture decoded into several SkImages is only embedded once.
+ *  Digests the image's encoded data if it has any, otherwise its pixels.
+ */
+struct SkPDFImageContentKey {
+    SkISize        fSize;
+    uint32_t       fFormat;  // kEncoded_Format, or the pixels' color and alpha type.
+    SkMD5::Digest  fDigest;
+
+    static SkPDFImageContentKey Make(const SkImage*);
+
+    bool operator==(const SkPDFImageContentKey& rhs) const {
+        return fSize == rhs.fSize && fFormat == rhs.fFormat && fDigest == rhs.fDigest;
+    }
+    bool operator!=(const SkPDFImageContentKey& rhs) const { return !(*this == rhs); }
+};
+
 #endif  // SkPDFBitmap_DEFINED
@@ -23,6 +23,7 @@ SkPDFCanon::~SkPDFCanon() {
     // or use std::unordered_set<>
     fGraphicStateRecords.foreach ([](WrapGS w) { w.fPtr->unref(); });
     fPDFBitmapMap.foreach(UnrefValue<SkBitmapKey, SkPDFObject>());
+    fPDFBitmapContentMap.foreach(UnrefValue<SkPDFImageContentKey, SkPDFObject>());
     fTypefaceMetrics.foreach(UnrefValue<uint32_t, SkAdvancedTypefaceMetrics>());
     fFontDescriptors.foreach(UnrefValue<uint32_t, SkPDFDict>());
     fFontMap.foreach(UnrefValue<uint64_t, SkPDFFont>());
@@ -100,6 +101,15 @@ void SkPDFCanon::addPDFBitmap(SkBitmapKey key, sk_sp<SkPDFObject> pdfBitmap) {
     fPDFBitmapMap.set(key, pdfBitmap.release());
 }
 
+sk_sp<SkPDFObject> SkPDFCanon::findPDFBitmap(const SkPDFImageContentKey& key) const {
+    SkPDFObject** ptr = fPDFBitmapContentMap.find(key);
+    return ptr ? sk_ref_sp(*ptr) : sk_sp<SkPDFObject>();
+}
+
+void SkPDFCanon::addPDFBitmap(const SkPDFImageContentKey& key, sk_sp<SkPDFObject> pdfBitmap) {
+    fPDFBitmapContentMap.set(key, pdfBitmap.release());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 sk_sp<SkPDFStream> SkPDFCanon::makeInvertFunction() {
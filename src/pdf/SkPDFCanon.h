@@ -7,6 +7,7 @@
 #ifndef SkPDFCanon_DEFINED
 #define SkPDFCanon_DEFINED
 
+#include "SkPDFBitmap.h"
 #include "SkPDFGraphicState.h"
 #include "SkPDFShader.h"
 #include "SkPixelSerializer.h"
@@ -16,6 +17,7 @@
 
 class SkAdvancedTypefaceMetrics;
 class SkPDFFont;
+class SkResourceCache;
 
 /**
  *  The SkPDFCanon canonicalizes objects across PDF pages
@@ -56,6 +58,10 @@ public:
     sk_sp<SkPDFObject> findPDFBitmap(SkBitmapKey key) const;
     void addPDFBitmap(SkBitmapKey key, sk_sp<SkPDFObject>);
 
+    // Finds a bitmap added for an image with the same contents.
+    sk_sp<SkPDFObject> findPDFBitmap(const SkPDFImageContentKey& key) const;
+    void addPDFBitmap(const SkPDFImageContentKey& key, sk_sp<SkPDFObject>);
+
     SkTHashMap<uint32_t, SkAdvancedTypefaceMetrics*> fTypefaceMetrics;
     SkTHashMap<uint32_t, SkPDFDict*> fFontDescriptors;
     SkTHashMap<uint64_t, SkPDFFont*> fFontMap;
@@ -65,6 +71,10 @@ public:
         fPixelSerializer = std::move(ps);
     }
 
+    // Where SkPDFFontCache keeps this document's font data; nullptr for the process-wide cache.
+    SkResourceCache* getFontCache() const { return fFontCache; }
+    void setFontCache(SkResourceCache* fontCache) { fFontCache = fontCache; }
+
     sk_sp<SkPDFStream> makeInvertFunction();
     sk_sp<SkPDFDict> makeNoSmaskGraphicState();
     sk_sp<SkPDFArray> makeRangeObject();
@@ -99,8 +109,10 @@ private:
 
     // TODO(halcanary): make SkTHashMap<K, sk_sp<V>> work correctly.
     SkTHashMap<SkBitmapKey, SkPDFObject*> fPDFBitmapMap;
+    SkTHashMap<SkPDFImageContentKey, SkPDFObject*> fPDFBitmapContentMap;
 
     sk_sp<SkPixelSerializer> fPixelSerializer;
+    SkResourceCache* fFontCache = nullptr;
     sk_sp<SkPDFStream> fInvertFunction;
     sk_sp<SkPDFDict> fNoSmaskGraphicState;
     sk_sp<SkPDFArray> fRangeObject;
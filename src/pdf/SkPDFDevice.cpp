@@ -2186,12 +2186,18 @@ void SkPDFDevice::internalDrawImage(const SkMatrix& origMatrix,
         if (!img) {
             return;
         }
-        pdfimage = SkPDFCreateBitmapObject(
-                std::move(img), fDocument->canon()->getPixelSerializer());
+        // A different SkImage may have the same contents.
+        SkPDFImageContentKey contentKey = SkPDFImageContentKey::Make(img.get());
+        pdfimage = fDocument->canon()->findPDFBitmap(contentKey);
         if (!pdfimage) {
-            return;
+            pdfimage = SkPDFCreateBitmapObject(
+                    img, fDocument->canon()->getPixelSerializer());
+            if (!pdfimage) {
+                return;
+            }
+            fDocument->serialize(pdfimage);  // serialize images early.
+            fDocument->canon()->addPDFBitmap(contentKey, pdfimage);
         }
-        fDocument->serialize(pdfimage);  // serialize images early.
         fDocument->canon()->addPDFBitmap(key, pdfimage);
     }
     // TODO(halcanary): addXObjectResource() should take a sk_sp<SkPDFObject>
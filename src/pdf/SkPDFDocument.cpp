@@ -48,31 +48,51 @@ void SkPDFObjectSerializer::serializeHeader(SkWStream* wStream,
 }
 #undef SKPDF_MAGIC
 
-// Serialize all objects in the fObjNumMap that have not yet been serialized;
+void SkPDFObjectSerializer::serializeObject(SkWStream* wStream, int32_t index) {
+    SkPDFObject* object = fObjNumMap.objects()[index].get();
+    SkASSERT(0 == fOffsets[index]);
+    fOffsets[index] = this->offset(wStream);
+    // "The first entry in the [XREF] table (object number 0) is
+    // always free and has a generation number of 65,535; it is
+    // the head of the linked list of free objects."
+    wStream->writeDecAsText(index + 1);  // Skip object 0.
+    wStream->writeText(" 0 obj\n");  // Generation number is always 0.
+    object->emitObject(wStream, fObjNumMap);
+    wStream->writeText("\nendobj\n");
+    object->drop();
+}
+
+// Serialize all objects in the fObjNumMap that have not yet been serialized,
+// except for deferred objects.
 void SkPDFObjectSerializer::serializeObjects(SkWStream* wStream) {
     const SkTArray<sk_sp<SkPDFObject>>& objects = fObjNumMap.objects();
     while (fNextToBeSerialized < objects.count()) {
-        SkPDFObject* object = objects[fNextToBeSerialized].get();
-        int32_t index = fNextToBeSerialized + 1;  // Skip object 0.
-        // "The first entry in the [XREF] table (object number 0) is
-        // always free and has a generation number of 65,535; it is
-        // the head of the linked list of free objects."
         SkASSERT(fOffsets.count() == fNextToBeSerialized);
-        fOffsets.push(this->offset(wStream));
-        wStream->writeDecAsText(index);
-        wStream->writeText(" 0 obj\n");  // Generation number is always 0.
-        object->emitObject(wStream, fObjNumMap);
-        wStream->writeText("\nendobj\n");
-        object->drop();
+        fOffsets.push(0);
+        if (!fDeferred.contains(objects[fNextToBeSerialized].get())) {
+            this->serializeObject(wStream, fNextToBeSerialized);
+        }
         ++fNextToBeSerialized;
     }
 }
 
+// Serialize the objects skipped over so far, then anything they added to
+// the fObjNumMap.
+void SkPDFObjectSerializer::serializeDeferredObjects(SkWStream* wStream) {
+    fDeferred.reset();
+    for (int32_t i = 0; i < fNextToBeSerialized; ++i) {
+        if (0 == fOffsets[i]) {
+            this->serializeObject(wStream, i);
+        }
+    }
+    this->serializeObjects(wStream);
+}
+
 // Xref table and footer
 void SkPDFObjectSerializer::serializeFooter(SkWStream* wStream,
                                             const sk_sp<SkPDFObject> docCatalog,
                                             sk_sp<SkPDFObject> id) {
-    this->serializeObjects(wStream);
+    this->serializeDeferredObjects(wStream);
     int32_t xRefFileOffset = this->offset(wStream);
     // Include the special zeroth object in the count.
     int32_t objCount = SkToS32(fOffsets.count() + 1);
@@ -188,6 +208,15 @@ SkPDFDocument::~SkPDFDocument() {
     this->close();
 }
 
+void SkPDFDocument::registerFont(SkPDFFont* font) {
+    fFonts.add(font);
+    if (fMetadata.fStreamPages) {
+        // Fonts collect glyphs until the document is closed, so they are
+        // written last, even though pages refer to them earlier.
+        fObjectSerializer.fDeferred.add(font);
+    }
+}
+
 void SkPDFDocument::serialize(const sk_sp<SkPDFObject>& object) {
     fObjectSerializer.addObjectRecursively(object);
     fObjectSerializer.serializeObjects(this->getStream());
@@ -229,7 +258,15 @@ void SkPDFDocument::onEndPage() {
     fCanvas.reset(nullptr);
     SkASSERT(fPageDevice);
     auto page = sk_make_sp<SkPDFDict>("Page");
-    page->insertObject("Resources", fPageDevice->makeResourceDict());
+    sk_sp<SkPDFDict> resourceDict = fPageDevice->makeResourceDict();
+    if (fMetadata.fStreamPages) {
+        // Write out everything the resource dictionary refers to now, which
+        // releases the images, shaders, and form xobjects.  The dictionary
+        // itself only holds references, so it stays with the page.
+        resourceDict->addResources(&fObjectSerializer.fObjNumMap);
+        fObjectSerializer.serializeObjects(this->getStream());
+    }
+    page->insertObject("Resources", std::move(resourceDict));
     page->insertObject("MediaBox", fPageDevice->copyMediaBox());
     auto annotations = sk_make_sp<SkPDFArray>();
     fPageDevice->appendAnnotations(annotations.get());
@@ -424,6 +461,12 @@ void SkPDFDocument::onClose(SkWStream* stream) {
     // Build font subsetting info before calling addObjectRecursively().
     SkPDFCanon* canon = &fCanon;
     fFonts.foreach([canon](SkPDFFont* p){ p->getFontSubset(canon); });
+    if (fMetadata.fStreamPages) {
+        // Deferred fonts already have object numbers, so addObjectRecursively()
+        // would not visit what getFontSubset() just added to them.
+        SkPDFObjNumMap* objNumMap = &fObjectSerializer.fObjNumMap;
+        fFonts.foreach([objNumMap](SkPDFFont* p){ p->addResources(objNumMap); });
+    }
     fObjectSerializer.addObjectRecursively(docCatalog);
     fObjectSerializer.serializeObjects(this->getStream());
     fObjectSerializer.serializeFooter(this->getStream(), docCatalog, fID);
@@ -25,18 +25,25 @@ sk_sp<SkDocument> SkPDFMakeDocument(SkWStream* stream,
 // keep similar functionality together.
 struct SkPDFObjectSerializer : SkNoncopyable {
     SkPDFObjNumMap fObjNumMap;
-    SkTDArray<int32_t> fOffsets;
+    SkTDArray<int32_t> fOffsets;  // zero for objects that have not been serialized yet.
     sk_sp<SkPDFObject> fInfoDict;
     size_t fBaseOffset;
     int32_t fNextToBeSerialized;  // index in fObjNumMap
+    // Objects that serializeObjects() skips over, because they may still
+    // change.  They are written by serializeDeferredObjects().
+    SkTHashSet<SkPDFObject*> fDeferred;
 
     SkPDFObjectSerializer();
     ~SkPDFObjectSerializer();
     void addObjectRecursively(const sk_sp<SkPDFObject>&);
     void serializeHeader(SkWStream*, const SkDocument::PDFMetadata&);
     void serializeObjects(SkWStream*);
+    void serializeDeferredObjects(SkWStream*);
     void serializeFooter(SkWStream*, const sk_sp<SkPDFObject>, sk_sp<SkPDFObject>);
     int32_t offset(SkWStream*);
+
+private:
+    void serializeObject(SkWStream*, int32_t index);
 };
 
 /** Concrete implementation of SkDocument that creates PDF files. This
@@ -67,7 +74,7 @@ public:
      */
     void serialize(const sk_sp<SkPDFObject>&);
     SkPDFCanon* canon() { return &fCanon; }
-    void registerFont(SkPDFFont* f) { fFonts.add(f); }
+    void registerFont(SkPDFFont* f);
 
 private:
     SkPDFObjectSerializer fObjectSerializer;
@@ -14,6 +14,7 @@
 #include "SkPDFMakeCIDGlyphWidthsArray.h"
 #include "SkPDFMakeToUnicodeCmap.h"
 #include "SkPDFFont.h"
+#include "SkPDFFontCache.h"
 #include "SkPDFUtils.h"
 #include "SkRefCnt.h"
 #include "SkScalar.h"
@@ -105,6 +106,18 @@ void setGlyphWidthAndBoundingBox(SkScalar width, SkIRect box,
     content->writeText(" d1\n");
 }
 
+static sk_sp<SkPDFStream> make_to_unicode_cmap(SkTypeface* typeface,
+                                               const SkTDArray<SkUnichar>& glyphToUnicode,
+                                               const SkBitSet* subset,
+                                               bool multiByteGlyphs,
+                                               SkGlyphID firstGlyphID,
+                                               SkGlyphID lastGlyphID,
+                                               SkPDFCanon* canon) {
+    return sk_make_sp<SkPDFStream>(SkPDFFontCache::FindOrMakeToUnicode(
+            SkTypeface::UniqueID(typeface), glyphToUnicode, subset, multiByteGlyphs,
+            firstGlyphID, lastGlyphID, canon->getFontCache()));
+}
+
 static sk_sp<SkPDFArray> makeFontBBox(SkIRect glyphBBox, uint16_t emSize) {
     auto bbox = sk_make_sp<SkPDFArray>();
     bbox->reserve(4);
@@ -151,12 +164,18 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(SkTypeface* typeface,
         canon->fTypefaceMetrics.set(id, nullptr);
         return nullptr;
     }
-    sk_sp<SkAdvancedTypefaceMetrics> metrics(
-            typeface->getAdvancedTypefaceMetrics(
-                    SkTypeface::kGlyphNames_PerGlyphInfo | SkTypeface::kToUnicode_PerGlyphInfo,
-                    nullptr, 0));
+    // Other documents may already have computed these.  The canon keeps its
+    // own ref, so the metrics outlive a purge from the process-wide cache.
+    sk_sp<SkAdvancedTypefaceMetrics> metrics = SkPDFFontCache::FindMetrics(
+            id, canon->getFontCache());
     if (!metrics) {
-        metrics = sk_make_sp<SkAdvancedTypefaceMetrics>();
+        metrics.reset(typeface->getAdvancedTypefaceMetrics(
+                SkTypeface::kGlyphNames_PerGlyphInfo | SkTypeface::kToUnicode_PerGlyphInfo,
+                nullptr, 0));
+        if (!metrics) {
+            metrics = sk_make_sp<SkAdvancedTypefaceMetrics>();
+        }
+        SkPDFFontCache::AddMetrics(id, metrics, canon->getFontCache());
     }
     return *canon->fTypefaceMetrics.set(id, metrics.release());
 }
@@ -302,10 +321,12 @@ static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
 }
 
 static sk_sp<SkPDFStream> get_subset_font_stream(
+        SkTypeface* typeface,
         std::unique_ptr<SkStreamAsset> fontAsset,
         const SkBitSet& glyphUsage,
         const char* fontName,
-        int ttcIndex) {
+        int ttcIndex,
+        SkResourceCache* fontCache) {
     // Generate glyph id array in format needed by sfntly.
     // TODO(halcanary): sfntly should take a more compact format.
     SkTDArray<unsigned> subset;
@@ -314,6 +335,14 @@ static sk_sp<SkPDFStream> get_subset_font_stream(
     }
     glyphUsage.exportTo(&subset);
 
+    SkFontID fontID = SkTypeface::UniqueID(typeface);
+    if (sk_sp<SkData> cached = SkPDFFontCache::FindSubsetFont(fontID, glyphUsage, fontCache)) {
+        int subsetFontSize = SkToInt(cached->size());
+        auto subsetStream = sk_make_sp<SkPDFStream>(std::move(cached));
+        subsetStream->dict()->insertInt("Length1", subsetFontSize);
+        return subsetStream;
+    }
+
     unsigned char* subsetFont{nullptr};
     sk_sp<SkData> fontData(stream_to_data(std::move(fontAsset)));
 #if defined(GOOGLE3)
@@ -341,11 +370,12 @@ static sk_sp<SkPDFStream> get_subset_font_stream(
         return nullptr;
     }
     SkASSERT(subsetFont != nullptr);
-    auto subsetStream = sk_make_sp<SkPDFStream>(
-            SkData::MakeWithProc(
-                    subsetFont, subsetFontSize,
-                    [](const void* p, void*) { delete[] (unsigned char*)p; },
-                    nullptr));
+    sk_sp<SkData> subsetData = SkData::MakeWithProc(
+            subsetFont, subsetFontSize,
+            [](const void* p, void*) { delete[] (unsigned char*)p; },
+            nullptr);
+    SkPDFFontCache::AddSubsetFont(fontID, glyphUsage, subsetData, fontCache);
+    auto subsetStream = sk_make_sp<SkPDFStream>(std::move(subsetData));
     subsetStream->dict()->insertInt("Length1", subsetFontSize);
     return subsetStream;
 }
@@ -380,8 +410,8 @@ void SkPDFType0Font::getFontSubset(SkPDFCanon* canon) {
                 if (!SkToBool(metrics.fFlags &
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     sk_sp<SkPDFStream> subsetStream = get_subset_font_stream(
-                            std::move(fontAsset), this->glyphUsage(),
-                            metrics.fFontName.c_str(), ttcIndex);
+                            face, std::move(fontAsset), this->glyphUsage(),
+                            metrics.fFontName.c_str(), ttcIndex, canon->getFontCache());
                     if (subsetStream) {
                         descriptor->insertObjRef("FontFile2", std::move(subsetStream));
                         break;
@@ -432,15 +462,18 @@ void SkPDFType0Font::getFontSubset(SkPDFCanon* canon) {
 
     int16_t defaultWidth = 0;
     {
-        int emSize;
-        SkAutoGlyphCache glyphCache = SkPDFFont::MakeVectorCache(face, &emSize);
+        uint16_t emSize;
+        sk_sp<SkData> advances = SkPDFFontCache::FindOrMakeAdvances(face, this->glyphUsage(),
+                                                                     &emSize,
+                                                                     canon->getFontCache());
         sk_sp<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
-                glyphCache.get(), &this->glyphUsage(), SkToS16(emSize), &defaultWidth);
+                (const int16_t*)advances->data(), SkToInt(advances->size() / sizeof(int16_t)),
+                &this->glyphUsage(), emSize, &defaultWidth);
         if (widths && widths->size() > 0) {
             newCIDFont->insertObject("W", std::move(widths));
         }
         newCIDFont->insertScalar(
-                "DW", scaleFromFontUnits(defaultWidth, SkToS16(emSize)));
+                "DW", scaleFromFontUnits(defaultWidth, emSize));
     }
 
     ////////////////////////////////////////////////////////////////////////////
@@ -454,11 +487,13 @@ void SkPDFType0Font::getFontSubset(SkPDFCanon* canon) {
 
     if (metrics.fGlyphToUnicode.count() > 0) {
         this->insertObjRef("ToUnicode",
-                           SkPDFMakeToUnicodeCmap(metrics.fGlyphToUnicode,
-                                                  &this->glyphUsage(),
-                                                  multiByteGlyphs(),
-                                                  firstGlyphID(),
-                                                  lastGlyphID()));
+                           make_to_unicode_cmap(face,
+                                                metrics.fGlyphToUnicode,
+                                                &this->glyphUsage(),
+                                                multiByteGlyphs(),
+                                                firstGlyphID(),
+                                                lastGlyphID(),
+                                                canon));
     }
     SkDEBUGCODE(fPopulated = true);
     return;
@@ -687,11 +722,13 @@ static void add_type3_font_info(SkPDFCanon* canon,
     font->insertName("CIDToGIDMap", "Identity");
     if (metrics && metrics->fGlyphToUnicode.count() > 0) {
         font->insertObjRef("ToUnicode",
-                           SkPDFMakeToUnicodeCmap(metrics->fGlyphToUnicode,
-                                                  &subset,
-                                                  false,
-                                                  firstGlyphID,
-                                                  lastGlyphID));
+                           make_to_unicode_cmap(typeface,
+                                                metrics->fGlyphToUnicode,
+                                                &subset,
+                                                false,
+                                                firstGlyphID,
+                                                lastGlyphID,
+                                                canon));
     }
     auto descriptor = sk_make_sp<SkPDFDict>("FontDescriptor");
     int32_t fontDescriptorFlags = kPdfSymbolic;
@@ -0,0 +1,329 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAutoMalloc.h"
+#include "SkBitSet.h"
+#include "SkGlyphCache.h"
+#include "SkMutex.h"
+#include "SkPDFFont.h"
+#include "SkPDFFontCache.h"
+#include "SkPDFMakeToUnicodeCmap.h"
+#include "SkResourceCache.h"
+
+#ifndef SK_DEFAULT_PDF_FONT_CACHE_LIMIT
+    #define SK_DEFAULT_PDF_FONT_CACHE_LIMIT     (4 * 1024 * 1024)
+#endif
+
+namespace {
+static unsigned gMetricsKeyNamespaceLabel;
+static unsigned gAdvancesKeyNamespaceLabel;
+static unsigned gSubsetKeyNamespaceLabel;
+
+struct FontKey : public SkResourceCache::Key {
+    FontKey(void* nameSpace, SkFontID fontID) : fFontID(fontID) {
+        this->init(nameSpace, 0, sizeof(fFontID));
+    }
+
+    SkFontID fFontID;
+};
+
+struct MetricsRec : public SkResourceCache::Rec {
+    MetricsRec(SkFontID fontID, sk_sp<SkAdvancedTypefaceMetrics> metrics)
+        : fKey(&gMetricsKeyNamespaceLabel, fontID)
+        , fMetrics(std::move(metrics)) {}
+
+    FontKey                          fKey;
+    sk_sp<SkAdvancedTypefaceMetrics> fMetrics;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        size_t bytes = sizeof(*this) + sizeof(SkAdvancedTypefaceMetrics)
+                     + fMetrics->fFontName.size()
+                     + fMetrics->fGlyphToUnicode.count() * sizeof(SkUnichar);
+        for (const SkString& name : fMetrics->fGlyphNames) {
+            bytes += sizeof(SkString) + name.size();
+        }
+        return bytes;
+    }
+    const char* getCategory() const override { return "pdf-font-metrics"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const MetricsRec& rec = static_cast<const MetricsRec&>(baseRec);
+        *static_cast<sk_sp<SkAdvancedTypefaceMetrics>*>(contextData) = rec.fMetrics;
+        return true;
+    }
+};
+
+// Advances are only loaded for glyphs that have been drawn; the rest hold this.
+static const int16_t kUnknownAdvance = SK_MinS16;
+
+struct AdvancesValue {
+    sk_sp<SkData> fAdvances;
+    uint16_t      fEmSize;
+};
+
+struct AdvancesRec : public SkResourceCache::Rec {
+    AdvancesRec(SkFontID fontID, AdvancesValue value)
+        : fKey(&gAdvancesKeyNamespaceLabel, fontID)
+        , fValue(std::move(value)) {}
+
+    FontKey       fKey;
+    AdvancesValue fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fAdvances->size(); }
+    const char* getCategory() const override { return "pdf-font-advances"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const AdvancesRec& rec = static_cast<const AdvancesRec&>(baseRec);
+        *static_cast<AdvancesValue*>(contextData) = rec.fValue;
+        return true;
+    }
+
+    // Fills in the advances of contextData, an SkData not yet shared, that rec knows and it
+    // does not. Returns false, so rec is purged to make way for the merged advances.
+    static bool MergeVisitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const AdvancesRec& rec = static_cast<const AdvancesRec&>(baseRec);
+        SkData* merged = static_cast<SkData*>(contextData);
+        if (rec.fValue.fAdvances->size() == merged->size()) {
+            const int16_t* known = (const int16_t*)rec.fValue.fAdvances->data();
+            int16_t* advances = (int16_t*)merged->writable_data();
+            for (size_t gID = 0; gID < merged->size() / sizeof(int16_t); ++gID) {
+                if (kUnknownAdvance == advances[gID]) {
+                    advances[gID] = known[gID];
+                }
+            }
+        }
+        return false;
+    }
+};
+
+enum SubsetKind {
+    kToUnicode_SubsetKind,
+    kFontProgram_SubsetKind,
+};
+
+// Keys on the exact contents of a glyph usage bitset, so it is variable length:
+// the bitset's words are stored immediately after the fixed fields.
+struct SubsetKey : public SkResourceCache::Key {
+    static size_t SizeFor(const SkBitSet* subset) {
+        return sizeof(SubsetKey) + (subset ? subset->dwordCount() * sizeof(uint32_t) : 0);
+    }
+
+    // storage must be at least SizeFor(subset) bytes.
+    static const SubsetKey& Make(void* storage, SkFontID fontID, SubsetKind kind,
+                                 const SkBitSet* subset, bool multiByteGlyphs,
+                                 SkGlyphID firstGlyphID, SkGlyphID lastGlyphID) {
+        SubsetKey* key = new (storage) SubsetKey;
+        key->fFontID = fontID;
+        key->fKind = (uint32_t)kind | (multiByteGlyphs ? 0x100 : 0) | (subset ? 0x200 : 0);
+        key->fGlyphRange = ((uint32_t)lastGlyphID << 16) | firstGlyphID;
+        key->fWordCount = subset ? SkToU32(subset->dwordCount()) : 0;
+        if (key->fWordCount > 0) {
+            memcpy(reinterpret_cast<uint32_t*>(key + 1), subset->data(),
+                   key->fWordCount * sizeof(uint32_t));
+        }
+        key->init(&gSubsetKeyNamespaceLabel, 0,
+                  SizeFor(subset) - sizeof(SkResourceCache::Key));
+        return *key;
+    }
+
+    SkFontID fFontID;
+    uint32_t fKind;
+    uint32_t fGlyphRange;
+    uint32_t fWordCount;
+    /* uint32_t fWords[fWordCount] */
+};
+static_assert(sizeof(SubsetKey) == sizeof(SkResourceCache::Key) + 4 * sizeof(uint32_t),
+              "SubsetKey must be tightly packed");
+
+struct SubsetRec : public SkResourceCache::Rec {
+    SubsetRec(const SubsetKey& key, sk_sp<SkData> data)
+        : fKeyStorage(key.size())
+        , fData(std::move(data)) {
+        memcpy(fKeyStorage.get(), &key, key.size());
+    }
+
+    SkAutoTMalloc<uint8_t> fKeyStorage;
+    sk_sp<SkData>          fData;
+
+    const Key& getKey() const override {
+        return *reinterpret_cast<const SubsetKey*>(fKeyStorage.get());
+    }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + this->getKey().size() + fData->size();
+    }
+    const char* getCategory() const override { return "pdf-font-subset"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const SubsetRec& rec = static_cast<const SubsetRec&>(baseRec);
+        *static_cast<sk_sp<SkData>*>(contextData) = rec.fData;
+        return true;
+    }
+};
+}  // namespace
+
+SK_DECLARE_STATIC_MUTEX(gPDFFontCacheMutex);
+static SkResourceCache* gPDFFontCache = nullptr;
+
+/** Must hold gPDFFontCacheMutex when calling. */
+static SkResourceCache* get_cache(SkResourceCache* localCache = nullptr) {
+    gPDFFontCacheMutex.assertHeld();
+    if (localCache) {
+        return localCache;
+    }
+    if (nullptr == gPDFFontCache) {
+        gPDFFontCache = new SkResourceCache(SK_DEFAULT_PDF_FONT_CACHE_LIMIT);
+    }
+    return gPDFFontCache;
+}
+
+// Lookups and insertions hold the lock only briefly; the values themselves are
+// computed unlocked, so two threads may race to build the same entry.  The
+// cache keeps whichever is added first.
+static bool find(const SkResourceCache::Key& key, SkResourceCache::FindVisitor visitor,
+                 void* context, SkResourceCache* localCache) {
+    SkAutoMutexAcquire am(gPDFFontCacheMutex);
+    return get_cache(localCache)->find(key, visitor, context);
+}
+
+static void add(SkResourceCache::Rec* rec, SkResourceCache* localCache) {
+    SkAutoMutexAcquire am(gPDFFontCacheMutex);
+    get_cache(localCache)->add(rec);
+}
+
+// Replaces the entry for rec's key, if any, with rec, after letting visitor see the old one.
+static void replace(SkResourceCache::Rec* rec, SkResourceCache::FindVisitor visitor,
+                    void* context, SkResourceCache* localCache) {
+    SkAutoMutexAcquire am(gPDFFontCacheMutex);
+    SkResourceCache* cache = get_cache(localCache);
+    (void)cache->find(rec->getKey(), visitor, context);
+    cache->add(rec);
+}
+
+// Whether advances has glyph 0 and every glyph in glyphs.
+static bool has_advances(const SkData& advances, const SkBitSet& glyphs) {
+    const int16_t* known = (const int16_t*)advances.data();
+    int glyphCount = SkToInt(advances.size() / sizeof(int16_t));
+    for (int gID = 0; gID < glyphCount; ++gID) {
+        if ((0 == gID || glyphs.has(gID)) && kUnknownAdvance == known[gID]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkAdvancedTypefaceMetrics> SkPDFFontCache::FindMetrics(SkFontID fontID,
+                                                             SkResourceCache* localCache) {
+    sk_sp<SkAdvancedTypefaceMetrics> metrics;
+    return find(FontKey(&gMetricsKeyNamespaceLabel, fontID), MetricsRec::Visitor, &metrics,
+                localCache) ? metrics : nullptr;
+}
+
+void SkPDFFontCache::AddMetrics(SkFontID fontID, sk_sp<SkAdvancedTypefaceMetrics> metrics,
+                                SkResourceCache* localCache) {
+    SkASSERT(metrics);
+    add(new MetricsRec(fontID, std::move(metrics)), localCache);
+}
+
+sk_sp<SkData> SkPDFFontCache::FindOrMakeAdvances(SkTypeface* typeface, const SkBitSet& glyphs,
+                                                 uint16_t* emSize, SkResourceCache* localCache) {
+    SkASSERT(typeface);
+    SkASSERT(emSize);
+    SkFontID id = typeface->uniqueID();
+    AdvancesValue value;
+    if (find(FontKey(&gAdvancesKeyNamespaceLabel, id), AdvancesRec::Visitor, &value,
+             localCache) &&
+        has_advances(*value.fAdvances, glyphs)) {
+        *emSize = value.fEmSize;
+        return value.fAdvances;
+    }
+
+    // Load just the glyphs that are missing, and keep the ones already known.
+    int unitsPerEm;
+    SkAutoGlyphCache glyphCache = SkPDFFont::MakeVectorCache(typeface, &unitsPerEm);
+    int glyphCount = SkToInt(glyphCache->getGlyphCount());
+    sk_sp<SkData> merged = SkData::MakeUninitialized(glyphCount * sizeof(int16_t));
+    const int16_t* known = value.fAdvances && value.fAdvances->size() == merged->size()
+                         ? (const int16_t*)value.fAdvances->data() : nullptr;
+    int16_t* advances = (int16_t*)merged->writable_data();
+    for (int gID = 0; gID < glyphCount; ++gID) {
+        if (known && kUnknownAdvance != known[gID]) {
+            advances[gID] = known[gID];
+        } else if (0 == gID || glyphs.has(gID)) {
+            advances[gID] = (int16_t)glyphCache->getGlyphIDAdvance(gID).fAdvanceX;
+        } else {
+            advances[gID] = kUnknownAdvance;
+        }
+    }
+    value.fAdvances = merged;
+    value.fEmSize = SkToU16(unitsPerEm);
+    *emSize = value.fEmSize;
+    // Another document may have added glyphs meanwhile; keep those too.
+    replace(new AdvancesRec(id, value), AdvancesRec::MergeVisitor, merged.get(), localCache);
+    return merged;
+}
+
+sk_sp<SkData> SkPDFFontCache::FindOrMakeToUnicode(SkFontID fontID,
+                                                  const SkTDArray<SkUnichar>& glyphToUnicode,
+                                                  const SkBitSet* subset,
+                                                  bool multiByteGlyphs,
+                                                  SkGlyphID firstGlyphID,
+                                                  SkGlyphID lastGlyphID,
+                                                  SkResourceCache* localCache) {
+    SkAutoSMalloc<1024> storage(SubsetKey::SizeFor(subset));
+    const SubsetKey& key = SubsetKey::Make(storage.get(), fontID, kToUnicode_SubsetKind,
+                                           subset, multiByteGlyphs, firstGlyphID, lastGlyphID);
+    sk_sp<SkData> cmap;
+    if (find(key, SubsetRec::Visitor, &cmap, localCache)) {
+        return cmap;
+    }
+    cmap = SkPDFMakeToUnicodeCmapData(glyphToUnicode, subset, multiByteGlyphs,
+                                      firstGlyphID, lastGlyphID);
+    add(new SubsetRec(key, cmap), localCache);
+    return cmap;
+}
+
+sk_sp<SkData> SkPDFFontCache::FindSubsetFont(SkFontID fontID, const SkBitSet& subset,
+                                             SkResourceCache* localCache) {
+    SkAutoSMalloc<1024> storage(SubsetKey::SizeFor(&subset));
+    const SubsetKey& key = SubsetKey::Make(storage.get(), fontID, kFontProgram_SubsetKind,
+                                           &subset, true, 0, 0);
+    sk_sp<SkData> data;
+    return find(key, SubsetRec::Visitor, &data, localCache) ? data : nullptr;
+}
+
+void SkPDFFontCache::AddSubsetFont(SkFontID fontID, const SkBitSet& subset,
+                                   sk_sp<SkData> data, SkResourceCache* localCache) {
+    SkASSERT(data);
+    SkAutoSMalloc<1024> storage(SubsetKey::SizeFor(&subset));
+    const SubsetKey& key = SubsetKey::Make(storage.get(), fontID, kFontProgram_SubsetKind,
+                                           &subset, true, 0, 0);
+    add(new SubsetRec(key, std::move(data)), localCache);
+}
+
+size_t SkPDFFontCache::GetTotalBytesUsed() {
+    SkAutoMutexAcquire am(gPDFFontCacheMutex);
+    return get_cache()->getTotalBytesUsed();
+}
+
+size_t SkPDFFontCache::GetTotalByteLimit() {
+    SkAutoMutexAcquire am(gPDFFontCacheMutex);
+    return get_cache()->getTotalByteLimit();
+}
+
+size_t SkPDFFontCache::SetTotalByteLimit(size_t newLimit) {
+    SkAutoMutexAcquire am(gPDFFontCacheMutex);
+    return get_cache()->setTotalByteLimit(newLimit);
+}
+
+void SkPDFFontCache::PurgeAll() {
+    SkAutoMutexAcquire am(gPDFFontCacheMutex);
+    get_cache()->purgeAll();
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPDFFontCache_DEFINED
+#define SkPDFFontCache_DEFINED
+
+#include "SkAdvancedTypefaceMetrics.h"
+#include "SkData.h"
+#include "SkTDArray.h"
+#include "SkTypeface.h"
+
+class SkBitSet;
+class SkResourceCache;
+
+/**
+ *  Process-wide cache of the data the PDF backend derives from a typeface:
+ *  advanced metrics, glyph advances, ToUnicode CMaps and subsetted font
+ *  programs.  Unlike SkPDFCanon, which lives and dies with one document, this
+ *  cache is shared by every SkPDFDocument, so documents that draw with the
+ *  same typefaces only pay for that work once.
+ *
+ *  All methods are thread-safe.  Entries are keyed on SkTypeface::uniqueID()
+ *  and purged least-recently-used first once the byte limit is exceeded.
+ *  Passing a localCache uses it instead of the process-wide cache, e.g. in tests.
+ */
+class SkPDFFontCache {
+public:
+    /**
+     *  Find or add the metrics SkPDFFont::GetMetrics() computed for a typeface.
+     */
+    static sk_sp<SkAdvancedTypefaceMetrics> FindMetrics(SkFontID,
+                                                        SkResourceCache* localCache = nullptr);
+    static void AddMetrics(SkFontID, sk_sp<SkAdvancedTypefaceMetrics>,
+                           SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Return the horizontal advances of the typeface's glyphs as an array of
+     *  int16_t, one per glyph, in font units at a text size of *emSize.  Only
+     *  glyph 0 and the glyphs in glyphs are sure to be filled in: others are
+     *  loaded once some document uses them, and are SK_MinS16 until then.
+     */
+    static sk_sp<SkData> FindOrMakeAdvances(SkTypeface*, const SkBitSet& glyphs,
+                                            uint16_t* emSize,
+                                            SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Return the contents of a ToUnicode CMap stream, as produced by
+     *  SkPDFMakeToUnicodeCmapData() with the same arguments.
+     */
+    static sk_sp<SkData> FindOrMakeToUnicode(SkFontID,
+                                             const SkTDArray<SkUnichar>& glyphToUnicode,
+                                             const SkBitSet* subset,
+                                             bool multiByteGlyphs,
+                                             SkGlyphID firstGlyphID,
+                                             SkGlyphID lastGlyphID,
+                                             SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Find or add the font program subsetted to exactly the glyphs in subset.
+     */
+    static sk_sp<SkData> FindSubsetFont(SkFontID, const SkBitSet& subset,
+                                        SkResourceCache* localCache = nullptr);
+    static void AddSubsetFont(SkFontID, const SkBitSet& subset, sk_sp<SkData>,
+                              SkResourceCache* localCache = nullptr);
+
+    static size_t GetTotalBytesUsed();
+    static size_t GetTotalByteLimit();
+    static size_t SetTotalByteLimit(size_t newLimit);
+    static void PurgeAll();
+};
+
+#endif  // SkPDFFontCache_DEFINED
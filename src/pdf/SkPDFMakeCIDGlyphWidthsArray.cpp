@@ -7,8 +7,6 @@
 
 #include "SkBitSet.h"
 #include "SkPDFMakeCIDGlyphWidthsArray.h"
-#include "SkPaint.h"
-#include "SkGlyphCache.h"
 
 // TODO(halcanary): Write unit tests for SkPDFMakeCIDGlyphWidthsArray().
 
@@ -139,7 +137,8 @@ static void compose_advance_data(const AdvanceMetric& range,
 /** Retrieve advance data for glyphs. Used by the PDF backend. */
 // TODO(halcanary): this function is complex enough to need its logic
 // tested with unit tests.
-sk_sp<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(SkGlyphCache* cache,
+sk_sp<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(const int16_t* advances,
+                                               int glyphCount,
                                                const SkBitSet* subset,
                                                uint16_t emSize,
                                                int16_t* defaultAdvance) {
@@ -159,7 +158,7 @@ sk_sp<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(SkGlyphCache* cache,
     //  e. Removing 2 repeating advances is a win
 
     auto result = sk_make_sp<SkPDFArray>();
-    int num_glyphs = SkToInt(cache->getGlyphCount());
+    int num_glyphs = glyphCount;
 
     bool prevRange = false;
 
@@ -181,7 +180,7 @@ sk_sp<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(SkGlyphCache* cache,
         int16_t advance = kInvalidAdvance;
         if (gId < lastIndex) {
             if (!subset || 0 == gId || subset->has(gId)) {
-                advance = (int16_t)cache->getGlyphIDAdvance(gId).fAdvanceX;
+                advance = advances[gId];
             } else {
                 advance = kDontCareAdvance;
             }
@@ -10,12 +10,15 @@
 #include "SkPDFTypes.h"
 
 class SkBitSet;
-class SkGlyphCache;
 
 /* PDF 32000-1:2008, page 270: "The array's elements have a variable
    format that can specify individual widths for consecutive CIDs or
-   one width for a range of CIDs". */
-sk_sp<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(SkGlyphCache* cache,
+   one width for a range of CIDs".
+   advances holds the advance of each of the glyphCount glyphs in font units
+   (see SkPDFFontCache::FindOrMakeAdvances).  If subset is given, only the
+   advances of glyph 0 and the glyphs in subset are read. */
+sk_sp<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(const int16_t* advances,
+                                               int glyphCount,
                                                const SkBitSet* subset,
                                                uint16_t emSize,
                                                int16_t* defaultWidth);
@@ -209,7 +209,7 @@ void SkPDFAppendCmapSections(const SkTDArray<SkUnichar>& glyphToUnicode,
     append_bfrange_section(bfrangeEntries, multiByteGlyphs, cmap);
 }
 
-sk_sp<SkPDFStream> SkPDFMakeToUnicodeCmap(
+sk_sp<SkData> SkPDFMakeToUnicodeCmapData(
         const SkTDArray<SkUnichar>& glyphToUnicode,
         const SkBitSet* subset,
         bool multiByteGlyphs,
@@ -220,6 +220,15 @@ sk_sp<SkPDFStream> SkPDFMakeToUnicodeCmap(
     SkPDFAppendCmapSections(glyphToUnicode, subset, &cmap, multiByteGlyphs,
                             firstGlyphID, lastGlyphID);
     append_cmap_footer(&cmap);
-    return sk_make_sp<SkPDFStream>(
-            std::unique_ptr<SkStreamAsset>(cmap.detachAsStream()));
+    return cmap.detachAsData();
+}
+
+sk_sp<SkPDFStream> SkPDFMakeToUnicodeCmap(
+        const SkTDArray<SkUnichar>& glyphToUnicode,
+        const SkBitSet* subset,
+        bool multiByteGlyphs,
+        SkGlyphID firstGlyphID,
+        SkGlyphID lastGlyphID) {
+    return sk_make_sp<SkPDFStream>(SkPDFMakeToUnicodeCmapData(
+            glyphToUnicode, subset, multiByteGlyphs, firstGlyphID, lastGlyphID));
 }
@@ -18,6 +18,14 @@ sk_sp<SkPDFStream> SkPDFMakeToUnicodeCmap(
         SkGlyphID firstGlyphID,
         SkGlyphID lastGlyphID);
 
+// The contents of the stream returned by SkPDFMakeToUnicodeCmap().
+sk_sp<SkData> SkPDFMakeToUnicodeCmapData(
+        const SkTDArray<SkUnichar>& glyphToUnicode,
+        const SkBitSet* subset,
+        bool multiByteGlyphs,
+        SkGlyphID firstGlyphID,
+        SkGlyphID lastGlyphID);
+
 // Exposed for unit testing.
 void SkPDFAppendCmapSections(const SkTDArray<SkUnichar>& glyphToUnicode,
                              const SkBitSet* subset,
@@ -825,7 +825,7 @@ static sk_sp<SkData> default_image_serializer(SkImage* image) {
 static bool show_deduper_traffic = false;
 
 int SkPipeDeduper::findOrDefineImage(SkImage* image) {
-    int index = fImages.find(image->uniqueID());
+    int index = fImages.findAndTouch(image->uniqueID(), fFrame);
     SkASSERT(index >= 0);
     if (index) {
         if (show_deduper_traffic) {
@@ -837,7 +837,8 @@ int SkPipeDeduper::findOrDefineImage(SkImage* image) {
     sk_sp<SkData> data = fIMSerializer ? fIMSerializer->serialize(image)
                                        : default_image_serializer(image);
     if (data) {
-        index = fImages.add(image->uniqueID());
+        index = fImages.add(image->uniqueID(), data->size(), fFrame);
+        fResourceBytes += data->size();
         SkASSERT(index > 0);
         SkASSERT(fits_in(index, 24));
         fStream->write32(pack_verb(SkPipeVerb::kDefineImage, index));
@@ -896,7 +897,7 @@ int SkPipeDeduper::findOrDefineTypeface(SkTypeface* typeface) {
         return 0;   // default
     }
 
-    int index = fTypefaces.find(typeface->uniqueID());
+    int index = fTypefaces.findAndTouch(typeface->uniqueID(), fFrame);
     SkASSERT(index >= 0);
     if (index) {
         if (show_deduper_traffic) {
@@ -907,7 +908,8 @@ int SkPipeDeduper::findOrDefineTypeface(SkTypeface* typeface) {
 
     sk_sp<SkData> data = fTFSerializer ? fTFSerializer->serialize(typeface) : encode(typeface);
     if (data) {
-        index = fTypefaces.add(typeface->uniqueID());
+        index = fTypefaces.add(typeface->uniqueID(), data->size(), fFrame);
+        fResourceBytes += data->size();
         SkASSERT(index > 0);
         SkASSERT(fits_in(index, 24));
         fStream->write32(pack_verb(SkPipeVerb::kDefineTypeface, index));
@@ -955,11 +957,48 @@ int SkPipeDeduper::findOrDefineFactory(SkFlattenable* flattenable) {
     return index;
 }
 
+void SkPipeDeduper::purgeToBudget() {
+    while (fResourceBudget && fResourceBytes > fResourceBudget) {
+        int imageLastUsed, typefaceLastUsed;
+        int imageIndex = fImages.findStale(fFrame, &imageLastUsed);
+        int typefaceIndex = fTypefaces.findStale(fFrame, &typefaceLastUsed);
+        if (!imageIndex && !typefaceIndex) {
+            return;     // everything left was drawn this frame
+        }
+
+        // The reader frees its copy when it sees a define verb with the undef bit set.
+        if (imageIndex && (!typefaceIndex || imageLastUsed <= typefaceLastUsed)) {
+            fResourceBytes -= fImages.remove(imageIndex);
+            fStream->write32(pack_verb(SkPipeVerb::kDefineImage,
+                                       imageIndex | kUndef_ObjectDefinitionMask));
+            if (show_deduper_traffic) {
+                SkDebugf("  undefImage(%d)\n", imageIndex - 1);
+            }
+        } else {
+            fResourceBytes -= fTypefaces.remove(typefaceIndex);
+            fStream->write32(pack_verb(SkPipeVerb::kDefineTypeface,
+                                       typefaceIndex | kUndef_ObjectDefinitionMask));
+            if (show_deduper_traffic) {
+                SkDebugf("  undefTypeface(%d)\n", typefaceIndex - 1);
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "SkPipe.h"
 
 class SkPipeSerializer::Impl {
 public:
+    void endWrite(bool purge) {
+        fCanvas->restoreToCount(1);
+        if (purge) {
+            fDeduper.purgeToBudget();
+        }
+        fCanvas.reset(nullptr);
+        fDeduper.setCanvas(nullptr);
+    }
+
     SkPipeDeduper   fDeduper;
     std::unique_ptr<SkPipeCanvas> fCanvas;
 };
@@ -984,6 +1023,14 @@ void SkPipeSerializer::resetCache() {
     fImpl->fDeduper.resetCaches();
 }
 
+void SkPipeSerializer::setResourceBudget(size_t bytes) {
+    fImpl->fDeduper.setResourceBudget(bytes);
+}
+
+size_t SkPipeSerializer::getResourceBytes() const {
+    return fImpl->fDeduper.resourceBytes();
+}
+
 sk_sp<SkData> SkPipeSerializer::writeImage(SkImage* image) {
     SkDynamicMemoryWStream stream;
     this->writeImage(image, &stream);
@@ -999,10 +1046,11 @@ sk_sp<SkData> SkPipeSerializer::writePicture(SkPicture* picture) {
 void SkPipeSerializer::writePicture(SkPicture* picture, SkWStream* stream) {
     int index = fImpl->fDeduper.findPicture(picture);
     if (0 == index) {
-        // Try to define the picture
+        // Try to define the picture.  readPicture() expects nothing but the definition, so
+        // don't use endWrite(), which may append undefs.
         this->beginWrite(picture->cullRect(), stream);
         index = fImpl->fDeduper.findOrDefinePicture(picture);
-        this->endWrite();
+        fImpl->endWrite(false);
     }
     stream->write32(pack_verb(SkPipeVerb::kWritePicture, index));
 }
@@ -1022,11 +1070,10 @@ SkCanvas* SkPipeSerializer::beginWrite(const SkRect& cull, SkWStream* stream) {
     fImpl->fCanvas.reset(new SkPipeCanvas(cull, &fImpl->fDeduper, stream));
     fImpl->fDeduper.setStream(stream);
     fImpl->fDeduper.setCanvas(fImpl->fCanvas.get());
+    fImpl->fDeduper.beginFrame();
     return fImpl->fCanvas.get();
 }
 
 void SkPipeSerializer::endWrite() {
-    fImpl->fCanvas->restoreToCount(1);
-    fImpl->fCanvas.reset(nullptr);
-    fImpl->fDeduper.setCanvas(nullptr);
+    fImpl->endWrite(true);
 }
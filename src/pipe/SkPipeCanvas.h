@@ -33,18 +33,63 @@ public:
         return 0;
     }
 
+    // returns the found index or 0, noting that it was used in frame
+    int findAndTouch(const T& key, int frame) {
+        Rec* stop = fArray.end();
+        for (Rec* curr = fArray.begin(); curr < stop; ++curr) {
+            if (key == curr->fKey) {
+                curr->fLastUsed = frame;
+                return curr->fIndex;
+            }
+        }
+        return 0;
+    }
+
     // returns the new index
-    int add(const T& key) {
+    int add(const T& key, size_t bytes = 0, int frame = 0) {
         Rec* rec = fArray.append();
         rec->fKey = key;
         rec->fIndex = fNextIndex++;
+        rec->fBytes = bytes;
+        rec->fLastUsed = frame;
         return rec->fIndex;
     }
 
+    // Returns the index of the least recently used entry not used since frame (storing when it
+    // was last used in lastUsed), or 0 if every entry has been used since then.
+    int findStale(int frame, int* lastUsed) const {
+        int index = 0;
+        *lastUsed = frame;
+        const Rec* stop = fArray.end();
+        for (const Rec* curr = fArray.begin(); curr < stop; ++curr) {
+            if (curr->fLastUsed < *lastUsed) {
+                *lastUsed = curr->fLastUsed;
+                index = curr->fIndex;
+            }
+        }
+        return index;
+    }
+
+    // Forgets the entry for index, returning the bytes it was added with.  Indices are never
+    // reused, so a key that is added again gets a new one.
+    size_t remove(int index) {
+        for (int i = 0; i < fArray.count(); ++i) {
+            if (fArray[i].fIndex == index) {
+                size_t bytes = fArray[i].fBytes;
+                fArray.removeShuffle(i);
+                return bytes;
+            }
+        }
+        SkASSERT(false);
+        return 0;
+    }
+
 private:
     struct Rec {
-        T   fKey;
-        int fIndex;
+        T       fKey;
+        int     fIndex;
+        int     fLastUsed;
+        size_t  fBytes;
     };
 
     SkTDArray<Rec>  fArray;
@@ -58,8 +103,17 @@ public:
         fPictures.reset();
         fTypefaces.reset();
         fFactories.reset();
+        fResourceBytes = 0;
     }
 
+    // Images and typefaces stay defined across streams.  Each beginWrite() starts a new frame,
+    // and once a frame ends with more than the budget's worth of them defined, purgeToBudget()
+    // tells the reader to forget the least recently used ones that frame did not draw with.
+    void setResourceBudget(size_t bytes) { fResourceBudget = bytes; }
+    size_t resourceBytes() const { return fResourceBytes; }
+    void beginFrame() { fFrame += 1; }
+    void purgeToBudget();
+
     void setCanvas(SkPipeCanvas* canvas) { fPipeCanvas = canvas; }
     void setStream(SkWStream* stream) { fStream = stream; }
     void setTypefaceSerializer(SkTypefaceSerializer* tfs) { fTFSerializer = tfs; }
@@ -86,6 +140,10 @@ private:
     SkTIndexSet<uint32_t>   fPictures;
     SkTIndexSet<uint32_t>   fTypefaces;
     SkTIndexSet<SkFlattenable::Factory> fFactories;
+
+    size_t  fResourceBudget = 0;    // 0 means unlimited
+    size_t  fResourceBytes = 0;     // encoded size of the images and typefaces still defined
+    int     fFrame = 0;
 };
 
 
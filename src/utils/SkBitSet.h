@@ -65,6 +65,10 @@ public:
         }
     }
 
+    /** The 32-bit words backing the set, for hashing or comparing whole sets. */
+    const uint32_t* data() const { return fBitData.get(); }
+    size_t dwordCount() const { return fDwordCount; }
+
 private:
     std::unique_ptr<uint32_t, SkFunctionWrapper<void, void, sk_free>> fBitData;
     size_t fDwordCount;  // Dword (32-bit) count of the bitset.
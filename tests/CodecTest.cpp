@@ -14,7 +14,9 @@
 #include "SkCodecImageGenerator.h"
 #include "SkColorSpace_XYZ.h"
 #include "SkColorSpacePriv.h"
+#include "SkColorTable.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkFrontBufferedStream.h"
 #include "SkImageEncoder.h"
 #include "SkImageEncoderPriv.h"
@@ -1187,6 +1189,152 @@ DEF_TEST(Codec_PngRoundTrip, r) {
     }
 }
 
+// Encodes bm with default options and with opts, and checks that both decode to the same pixels.
+static void check_png_options(skiatest::Reporter* r, const SkBitmap& bm,
+                              const SkEncodeOptions& opts) {
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, bm.peekPixels(&pixmap));
+
+    SkDynamicMemoryWStream serialBuf;
+    REPORTER_ASSERT(r, SkEncodeImageAsPNG(&serialBuf, pixmap, SkEncodeOptions()));
+    SkDynamicMemoryWStream parallelBuf;
+    REPORTER_ASSERT(r, SkEncodeImageAsPNG(&parallelBuf, pixmap, opts));
+
+    // The encoded bytes differ, but both must decode to the same pixels.
+    SkBitmap serial, parallel;
+    std::unique_ptr<SkCodec> serialCodec(SkCodec::NewFromData(serialBuf.detachAsData()));
+    std::unique_ptr<SkCodec> parallelCodec(SkCodec::NewFromData(parallelBuf.detachAsData()));
+    REPORTER_ASSERT(r, serialCodec && parallelCodec);
+    if (!serialCodec || !parallelCodec) {
+        return;
+    }
+
+    serial.allocPixels(serialCodec->getInfo());
+    parallel.allocPixels(parallelCodec->getInfo());
+    REPORTER_ASSERT(r, serial.info() == parallel.info());
+    REPORTER_ASSERT(r, SkCodec::kSuccess == serialCodec->getPixels(serial.info(),
+            serial.getPixels(), serial.rowBytes()));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == parallelCodec->getPixels(parallel.info(),
+            parallel.getPixels(), parallel.rowBytes()));
+
+    SkMD5::Digest d1, d2;
+    md5(serial, &d1);
+    md5(parallel, &d2);
+    REPORTER_ASSERT(r, d1 == d2);
+}
+
+static void check_png_options(skiatest::Reporter* r, const SkEncodeOptions& opts) {
+    // Large enough that a parallel encode splits the rows into several bands.
+    SkBitmap bm;
+    REPORTER_ASSERT(r, GetResourceAsBitmap("mandrill_512_q075.jpg", &bm));
+    check_png_options(r, bm, opts);
+
+    SkBitmap opaque;
+    REPORTER_ASSERT(r, bm.copyTo(&opaque, kRGB_565_SkColorType));
+    check_png_options(r, opaque, opts);
+
+    REPORTER_ASSERT(r, GetResourceAsBitmap("yellow_rose.png", &bm));
+    check_png_options(r, bm, opts);
+
+    REPORTER_ASSERT(r, GetResourceAsBitmap("grayscale.jpg", &bm));
+    check_png_options(r, bm, opts);
+}
+
+DEF_TEST(Codec_PngParallelEncode, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+    SkEncodeOptions opts;
+    opts.fExecutor = executor.get();
+    check_png_options(r, opts);
+
+    opts.fPNGFilterFlags = SkEncodeOptions::PNGFilterFlags::kSub;
+    opts.fPNGZLibLevel = 1;
+    check_png_options(r, opts);
+}
+
+DEF_TEST(Codec_PngEncodeOptions, r) {
+    SkEncodeOptions opts;
+    opts.fPNGFilterFlags = SkEncodeOptions::PNGFilterFlags::kSub;
+    opts.fPNGZLibLevel = 1;
+    check_png_options(r, opts);
+
+    opts.fPNGFilterFlags = SkEncodeOptions::PNGFilterFlags::kNone;
+    opts.fPNGZLibLevel = 0;
+    check_png_options(r, opts);
+
+    opts.fPNGZLibLevel = 10;
+    SkBitmap bm;
+    bm.allocN32Pixels(1, 1);
+    bm.eraseColor(SK_ColorBLACK);
+    SkPixmap pixmap;
+    bm.peekPixels(&pixmap);
+    SkDynamicMemoryWStream buf;
+    REPORTER_ASSERT(r, !SkEncodeImageAsPNG(&buf, pixmap, opts));
+}
+
+// Palette images are left unfiltered by default, as libpng leaves them, serial or parallel.
+DEF_TEST(Codec_PngEncodeIndex8Unfiltered, r) {
+    const SkPMColor colors[] = {
+        SkPreMultiplyColor(SK_ColorBLACK), SkPreMultiplyColor(SK_ColorRED),
+        SkPreMultiplyColor(SK_ColorGREEN), SkPreMultiplyColor(SK_ColorBLUE),
+        SkPreMultiplyColor(SK_ColorWHITE),
+    };
+    sk_sp<SkColorTable> ctable(new SkColorTable(colors, SK_ARRAY_COUNT(colors)));
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(64, 64, kIndex_8_SkColorType, kOpaque_SkAlphaType),
+                   nullptr, ctable.get());
+    for (int y = 0; y < 64; ++y) {
+        for (int x = 0; x < 64; ++x) {
+            *bm.getAddr8(x, y) = (x + y) % SK_ARRAY_COUNT(colors);
+        }
+    }
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, bm.peekPixels(&pixmap));
+
+    SkDynamicMemoryWStream defaultBuf, noneBuf;
+    SkEncodeOptions opts;
+    REPORTER_ASSERT(r, SkEncodeImageAsPNG(&defaultBuf, pixmap, opts));
+    opts.fPNGFilterFlags = SkEncodeOptions::PNGFilterFlags::kNone;
+    REPORTER_ASSERT(r, SkEncodeImageAsPNG(&noneBuf, pixmap, opts));
+    sk_sp<SkData> defaultData = defaultBuf.detachAsData();
+    sk_sp<SkData> noneData = noneBuf.detachAsData();
+    REPORTER_ASSERT(r, defaultData->equals(noneData.get()));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(2);
+    opts = SkEncodeOptions();
+    opts.fExecutor = executor.get();
+    check_png_options(r, bm, opts);
+}
+
+// 565 is encoded with its channels expanded by bit replication, as SkPacked16ToR32() does.
+DEF_TEST(Codec_PngEncode565, r) {
+    SkBitmap bm;
+    bm.allocPixels(SkImageInfo::Make(64, 1, kRGB_565_SkColorType, kOpaque_SkAlphaType));
+    uint16_t* row = bm.getAddr16(0, 0);
+    for (int x = 0; x < 64; ++x) {
+        row[x] = SkPackRGB16(x & 31, (x * 7) & 63, 31 - (x & 31));
+    }
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, bm.peekPixels(&pixmap));
+    SkDynamicMemoryWStream buf;
+    REPORTER_ASSERT(r, SkEncodeImageAsPNG(&buf, pixmap, SkEncodeOptions()));
+
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(buf.detachAsData()));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    SkBitmap decoded;
+    decoded.allocPixels(SkImageInfo::Make(64, 1, kRGBA_8888_SkColorType, kOpaque_SkAlphaType));
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(decoded.info(),
+            decoded.getPixels(), decoded.rowBytes()));
+    const uint8_t* rgba = (const uint8_t*)decoded.getPixels();
+    for (int x = 0; x < 64; ++x) {
+        REPORTER_ASSERT(r, rgba[4 * x + 0] == SkPacked16ToR32(row[x]));
+        REPORTER_ASSERT(r, rgba[4 * x + 1] == SkPacked16ToG32(row[x]));
+        REPORTER_ASSERT(r, rgba[4 * x + 2] == SkPacked16ToB32(row[x]));
+    }
+}
+
 static void test_conversion_possible(skiatest::Reporter* r, const char* path,
                                      bool supportsScanlineDecoder,
                                      bool supportsIncrementalDecoder) {
@@ -8,10 +8,14 @@
 #include "Test.h"
 
 #include "SkBitmap.h"
+#include "SkBlurImageFilter.h"
+#include "SkGraphics.h"
 #include "SkImage.h"
 #include "SkImageFilter.h"
 #include "SkImageFilterCache.h"
+#include "SkImageFilterContentCache.h"
 #include "SkMatrix.h"
+#include "SkMorphologyImageFilter.h"
 #include "SkSpecialImage.h"
 
 static const int kSmallerSize = 10;
@@ -177,6 +181,62 @@ DEF_TEST(ImageFilterCache_ImageBackedRaster, reporter) {
     test_image_backed(reporter, srcImage);
 }
 
+// Filters a freshly made copy of the same content each time, like a re-recorded frame would.
+static sk_sp<SkSpecialImage> filter_by_content(const SkImageFilter* filter, SkColor center,
+                                               SkIPoint* offset) {
+    SkBitmap srcBM = create_bm();
+    srcBM.eraseArea(SkIRect::MakeXYWH(kPad, kPad, kSmallerSize, kSmallerSize), center);
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kFullSize,
+                                                                                kFullSize),
+                                                                srcBM));
+
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kFullSize, kFullSize), nullptr,
+                               noColorSpace);
+    return SkImageFilterContentCache::FilterImage(filter, srcImg.get(), ctx, offset);
+}
+
+DEF_TEST(ImageFilterCache_ContentKeyed, reporter) {
+    const bool wasEnabled = SkGraphics::GetImageFilterContentCacheEnabled();
+    SkGraphics::SetImageFilterContentCacheEnabled(true);
+
+    uint64_t hitsBefore, hitsAfter;
+    SkGraphics::GetImageFilterContentCacheStats(&hitsBefore, nullptr);
+
+    // Dilating and eroding by the same radii flatten to the same bytes but for their factories.
+    sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(2, 2, nullptr));
+    sk_sp<SkImageFilter> dilate(SkDilateImageFilter::Make(2, 2, nullptr));
+    sk_sp<SkImageFilter> erode(SkErodeImageFilter::Make(2, 2, nullptr));
+
+    SkIPoint offset1, offset2, offset3, offset4, offset5;
+    sk_sp<SkSpecialImage> result1(filter_by_content(blur.get(), SK_ColorRED, &offset1));
+    sk_sp<SkSpecialImage> result2(filter_by_content(
+            SkBlurImageFilter::Make(2, 2, nullptr).get(), SK_ColorRED, &offset2));
+    sk_sp<SkSpecialImage> result3(filter_by_content(blur.get(), SK_ColorGREEN, &offset3));
+    SkGraphics::GetImageFilterContentCacheStats(&hitsAfter, nullptr);
+    sk_sp<SkSpecialImage> result4(filter_by_content(dilate.get(), SK_ColorRED, &offset4));
+    sk_sp<SkSpecialImage> result5(filter_by_content(erode.get(), SK_ColorRED, &offset5));
+
+    REPORTER_ASSERT(reporter, result4 && result5);
+    if (result4 && result5) {
+        // Different filters over the same pixels must each filter them.
+        REPORTER_ASSERT(reporter, result4->uniqueID() != result5->uniqueID());
+    }
+
+    REPORTER_ASSERT(reporter, result1 && result2 && result3);
+    if (result1 && result2 && result3) {
+        // Same content, new objects: the second filtering is the first one's result.
+        REPORTER_ASSERT(reporter, result1->uniqueID() == result2->uniqueID());
+        REPORTER_ASSERT(reporter, offset1 == offset2);
+        REPORTER_ASSERT(reporter, hitsAfter > hitsBefore);
+
+        // Different pixels under the same filter must be filtered again.
+        REPORTER_ASSERT(reporter, result1->uniqueID() != result3->uniqueID());
+    }
+
+    SkGraphics::SetImageFilterContentCacheEnabled(wasEnabled);
+}
+
 #if SK_SUPPORT_GPU
 #include "GrContext.h"
 #include "GrResourceProvider.h"
@@ -13,6 +13,7 @@
 #include "SkComposeImageFilter.h"
 #include "SkDisplacementMapEffect.h"
 #include "SkDropShadowImageFilter.h"
+#include "SkExecutor.h"
 #include "SkFlattenableSerialization.h"
 #include "SkGradientShader.h"
 #include "SkImage.h"
@@ -28,6 +29,7 @@
 #include "SkPictureImageFilter.h"
 #include "SkPictureRecorder.h"
 #include "SkPoint3.h"
+#include "SkRandom.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
 #include "SkSpecialImage.h"
@@ -1148,6 +1150,99 @@ DEF_TEST(ImageFilterMatrixConvolutionBigKernel, reporter) {
     test_big_kernel(reporter, nullptr);
 }
 
+// Separable kernels run as a row pass and a column pass; check them against the 2D sum.
+DEF_TEST(ImageFilterMatrixConvolutionSeparable, reporter) {
+    const int kSize = 24;
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(kSize, kSize);
+    SkRandom rand;
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            *srcBM.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(SkIRect::MakeWH(kSize, kSize),
+                                                                srcBM));
+
+    const SkScalar binomial[5] = { 1, 4, 6, 4, 1 };
+    SkScalar kernel[25];
+    for (int i = 0; i < 25; ++i) {
+        kernel[i] = binomial[i / 5] * binomial[i % 5];
+    }
+    const SkScalar gain = 1.0f / 256, bias = 0;
+    const SkIPoint kernelOffset = SkIPoint::Make(1, 3);
+
+    const SkMatrixConvolutionImageFilter::TileMode modes[] = {
+        SkMatrixConvolutionImageFilter::kClamp_TileMode,
+        SkMatrixConvolutionImageFilter::kRepeat_TileMode,
+        SkMatrixConvolutionImageFilter::kClampToBlack_TileMode,
+    };
+    for (auto mode : modes) {
+        sk_sp<SkImageFilter> filter(SkMatrixConvolutionImageFilter::Make(
+                SkISize::Make(5, 5), kernel, gain, bias, kernelOffset, mode, true, nullptr));
+
+        SkIPoint offset;
+        SkImageFilter::OutputProperties noColorSpace(nullptr);
+        SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                   noColorSpace);
+        sk_sp<SkSpecialImage> resultImg(filter->filterImage(srcImg.get(), ctx, &offset));
+        SkBitmap resultBM;
+        if (!resultImg || !resultImg->getROPixels(&resultBM)) {
+            ERRORF(reporter, "tile mode %d: expected a result", mode);
+            continue;
+        }
+        SkAutoLockPixels alp(resultBM);
+
+        // The result runs past the source by the kernel's reach.  The filter pads its input with
+        // transparent black to match, and the tile modes apply at the edges of that padding.
+        const SkIRect& subset = resultImg->subset();
+        const SkIRect padded = SkIRect::MakeXYWH(offset.fX, offset.fY,
+                                                 subset.width(), subset.height());
+        auto srcAt = [&](int x, int y) -> SkPMColor {
+            return x < 0 || x >= kSize || y < 0 || y >= kSize ? 0 : *srcBM.getAddr32(x, y);
+        };
+        auto fetch = [&](int x, int y) -> SkPMColor {
+            switch (mode) {
+                case SkMatrixConvolutionImageFilter::kClamp_TileMode:
+                    return srcAt(SkTPin(x, padded.left(), padded.right() - 1),
+                                 SkTPin(y, padded.top(), padded.bottom() - 1));
+                case SkMatrixConvolutionImageFilter::kRepeat_TileMode:
+                    return srcAt(padded.left() + (x - padded.left() + padded.width()) %
+                                                 padded.width(),
+                                 padded.top() + (y - padded.top() + padded.height()) %
+                                                padded.height());
+                case SkMatrixConvolutionImageFilter::kClampToBlack_TileMode:
+                    break;
+            }
+            return padded.contains(x, y) ? srcAt(x, y) : 0;
+        };
+
+        int mismatches = 0;
+        for (int y = padded.top(); y < padded.bottom(); ++y) {
+            for (int x = padded.left(); x < padded.right(); ++x) {
+                float sum[4] = { 0, 0, 0, 0 };
+                for (int cy = 0; cy < 5; ++cy) {
+                    for (int cx = 0; cx < 5; ++cx) {
+                        SkPMColor s = fetch(x + cx - kernelOffset.fX, y + cy - kernelOffset.fY);
+                        for (int c = 0; c < 4; ++c) {
+                            sum[c] += ((s >> (8 * c)) & 0xFF) * kernel[cy * 5 + cx];
+                        }
+                    }
+                }
+                SkPMColor actual = *resultBM.getAddr32(subset.x() + x - offset.fX,
+                                                       subset.y() + y - offset.fY);
+                for (int c = 0; c < 4; ++c) {
+                    int expected = SkTPin(SkScalarFloorToInt(sum[c] * gain + bias), 0, 255);
+                    if (SkTAbs(expected - (int)((actual >> (8 * c)) & 0xFF)) > 1) {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+        REPORTER_ASSERT(reporter, 0 == mismatches);
+    }
+}
+
 #if SK_SUPPORT_GPU
 DEF_GPUTEST_FOR_RENDERING_CONTEXTS(ImageFilterMatrixConvolutionBigKernel_Gpu,
                                    reporter, ctxInfo) {
@@ -1882,3 +1977,265 @@ DEF_TEST(ImageFilterComplexCTM, reporter) {
         REPORTER_ASSERT(reporter, canHandle == rec.fExpectCanHandle);
     }
 }
+
+/*
+ *  Test that handing the filters an executor, so that they evaluate their inputs and bands of
+ *  rows concurrently, produces exactly the same pixels as evaluating them serially.
+ */
+DEF_TEST(ImageFilterExecutorMatchesSerial, reporter) {
+    const int kSize = 256;
+    sk_sp<SkSpecialSurface> surf(create_empty_special_surface(nullptr, kSize));
+    SkPaint paint;
+    SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kSize), SkIntToScalar(kSize) } };
+    SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    surf->getCanvas()->drawCircle(kSize / 2, kSize / 2, kSize / 3, paint);
+    sk_sp<SkSpecialImage> src(surf->makeImageSnapshot());
+
+    const SkScalar kernel[9] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+    sk_sp<SkImageFilter> blur(SkBlurImageFilter::Make(3, 3, nullptr));
+    sk_sp<SkImageFilter> lit(SkLightingImageFilter::MakePointLitDiffuse(
+            SkPoint3::Make(kSize / 2, kSize / 2, 50), SK_ColorWHITE, 1, 2, blur));
+    sk_sp<SkImageFilter> sharpen(SkMatrixConvolutionImageFilter::Make(
+            SkISize::Make(3, 3), kernel, 1, 0, SkIPoint::Make(1, 1),
+            SkMatrixConvolutionImageFilter::kClamp_TileMode, true, blur));
+    sk_sp<SkImageFilter> filters[] = { lit, sharpen, blur };
+    sk_sp<SkImageFilter> merge(SkMergeImageFilter::MakeN(filters, SK_ARRAY_COUNT(filters),
+                                                         nullptr));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    SkImageFilter::Context serialCtx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                     noColorSpace);
+    SkImageFilter::Context threadedCtx(SkMatrix::I(), SkIRect::MakeWH(kSize, kSize), nullptr,
+                                       noColorSpace, executor.get());
+
+    SkIPoint serialOffset, threadedOffset;
+    sk_sp<SkSpecialImage> serial(merge->filterImage(src.get(), serialCtx, &serialOffset));
+    sk_sp<SkSpecialImage> threaded(merge->filterImage(src.get(), threadedCtx, &threadedOffset));
+    REPORTER_ASSERT(reporter, serial && threaded);
+    if (!serial || !threaded) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, serialOffset == threadedOffset);
+
+    SkBitmap serialBM, threadedBM;
+    REPORTER_ASSERT(reporter, serial->getROPixels(&serialBM));
+    REPORTER_ASSERT(reporter, threaded->getROPixels(&threadedBM));
+    REPORTER_ASSERT(reporter, serialBM.width() == threadedBM.width() &&
+                              serialBM.height() == threadedBM.height());
+    for (int y = 0; y < serialBM.height(); ++y) {
+        if (memcmp(serialBM.getAddr32(0, y), threadedBM.getAddr32(0, y),
+                   serialBM.width() * sizeof(SkPMColor))) {
+            ERRORF(reporter, "Row %d differs when filtering with an executor.", y);
+            break;
+        }
+    }
+}
+
+// Draws a filter's result at its offset, so results with different extents can be compared.
+static SkBitmap draw_at_offset(const SkSpecialImage* image, const SkIPoint& offset,
+                               int width, int height) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(width, height);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    if (image) {
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        paint.setBlendMode(SkBlendMode::kSrc);
+        image->draw(&canvas, SkIntToScalar(offset.x()), SkIntToScalar(offset.y()), &paint);
+    }
+    return bitmap;
+}
+
+/*
+ *  Test that filtering one tile at a time pieces together exactly the image that filtering all at
+ *  once produces, seams included, and that DAGs that can't be tiled are filtered all at once.
+ */
+DEF_TEST(ImageFilterInTilesMatchesWhole, reporter) {
+    const int kWidth = 300, kHeight = 200;
+    sk_sp<SkSpecialSurface> surf(create_empty_special_surface(nullptr, kWidth));
+    SkPaint paint;
+    SkPoint pts[] = { { 0, 0 }, { SkIntToScalar(kWidth), SkIntToScalar(kHeight) } };
+    SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    surf->getCanvas()->drawCircle(kWidth / 2, kHeight / 2, kHeight / 3, paint);
+    surf->getCanvas()->drawRect(SkRect::MakeXYWH(20, 20, 50, 150), paint);
+    sk_sp<SkSpecialImage> src(surf->makeImageSnapshot());
+
+    const SkScalar kernel[9] = { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+    sk_sp<SkImageFilter> filter(SkColorFilterImageFilter::Make(
+            SkColorMatrixFilter::MakeLightingFilter(0xFFC0A080, 0x00102030), nullptr));
+    filter = SkOffsetImageFilter::Make(3, -2, std::move(filter));
+    filter = SkDilateImageFilter::Make(2, 1, std::move(filter));
+    filter = SkMatrixConvolutionImageFilter::Make(
+            SkISize::Make(3, 3), kernel, 1, 0, SkIPoint::Make(1, 1),
+            SkMatrixConvolutionImageFilter::kClamp_TileMode, true, std::move(filter));
+    sk_sp<SkImageFilter> lit(SkLightingImageFilter::MakeSpotLitSpecular(
+            SkPoint3::Make(10, 10, 100), SkPoint3::Make(kWidth / 2, kHeight / 2, 0), 1, 30,
+            SK_ColorWHITE, 2, 1, 8, filter));
+    sk_sp<SkImageFilter> merged(SkMergeImageFilter::Make(lit, filter, SkBlendMode::kSrcOver));
+    REPORTER_ASSERT(reporter, merged->canFilterInTiles());
+
+    // Both without a clip and with one cutting through the lit area.
+    const SkIRect clips[] = {
+        SkIRect::MakeWH(kWidth, kHeight),
+        SkIRect::MakeLTRB(30, 25, 270, 180),
+    };
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    for (const SkIRect& clip : clips) {
+        SkImageFilter::Context ctx(SkMatrix::I(), clip, nullptr, noColorSpace);
+        SkIPoint wholeOffset = SkIPoint::Make(0, 0), tiledOffset = SkIPoint::Make(0, 0);
+        sk_sp<SkSpecialImage> whole(merged->filterImage(src.get(), ctx, &wholeOffset));
+        sk_sp<SkSpecialImage> tiled(merged->filterImageInTiles(src.get(), ctx, 64, &tiledOffset));
+        REPORTER_ASSERT(reporter, whole && tiled);
+
+        SkBitmap wholeBM = draw_at_offset(whole.get(), wholeOffset, kWidth, kHeight);
+        SkBitmap tiledBM = draw_at_offset(tiled.get(), tiledOffset, kWidth, kHeight);
+        for (int y = 0; y < kHeight; ++y) {
+            if (memcmp(wholeBM.getAddr32(0, y), tiledBM.getAddr32(0, y),
+                       kWidth * sizeof(SkPMColor))) {
+                ERRORF(reporter, "Row %d differs when filtering in tiles.", y);
+                break;
+            }
+        }
+    }
+
+    // Blurs aren't local enough, nor are partial crop rects or repeating convolutions.
+    SkImageFilter::CropRect leftOnly(SkRect::MakeXYWH(10, 0, 0, 0),
+                                     SkImageFilter::CropRect::kHasLeft_CropEdge);
+    SkImageFilter::CropRect all(SkRect::MakeXYWH(10, 10, 100, 100));
+    sk_sp<SkImageFilter> blurred(SkMergeImageFilter::Make(
+            lit, SkBlurImageFilter::Make(2, 2, nullptr), SkBlendMode::kSrcOver));
+    sk_sp<SkImageFilter> repeating(SkMatrixConvolutionImageFilter::Make(
+            SkISize::Make(3, 3), kernel, 1, 0, SkIPoint::Make(1, 1),
+            SkMatrixConvolutionImageFilter::kRepeat_TileMode, true, nullptr));
+    REPORTER_ASSERT(reporter, !blurred->canFilterInTiles());
+    REPORTER_ASSERT(reporter, !repeating->canFilterInTiles());
+    REPORTER_ASSERT(reporter, !SkOffsetImageFilter::Make(1, 1, nullptr, &leftOnly)
+                                      ->canFilterInTiles());
+    REPORTER_ASSERT(reporter, SkOffsetImageFilter::Make(1, 1, nullptr, &all)->canFilterInTiles());
+}
+
+// Outside of filterImageInTiles(), the lighting filters light the sides of the clip as edges of
+// the surface, just as if the input had been cropped to the clip.
+DEF_TEST(ImageFilterLightingClipIsEdge, reporter) {
+    const int kWidth = 40, kHeight = 30;
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(kWidth, kHeight);
+    SkRandom rand;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            *srcBM.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    const SkIRect clip = SkIRect::MakeLTRB(7, 5, 31, 22);
+    SkBitmap croppedBM;
+    SkAssertResult(srcBM.extractSubset(&croppedBM, clip));
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(
+            SkIRect::MakeWH(kWidth, kHeight), srcBM));
+    sk_sp<SkSpecialImage> croppedImg(SkSpecialImage::MakeFromRaster(
+            SkIRect::MakeWH(clip.width(), clip.height()), croppedBM));
+
+    // A distant light lights the same wherever the cropped input ends up.
+    sk_sp<SkImageFilter> filter(SkLightingImageFilter::MakeDistantLitDiffuse(
+            SkPoint3::Make(1, 2, 3), SK_ColorWHITE, 2, 1, nullptr));
+
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    SkImageFilter::Context clipped(SkMatrix::I(), clip, nullptr, noColorSpace);
+    SkImageFilter::Context whole(SkMatrix::I(), SkIRect::MakeWH(clip.width(), clip.height()),
+                                 nullptr, noColorSpace);
+    SkIPoint clippedOffset = SkIPoint::Make(0, 0), croppedOffset = SkIPoint::Make(0, 0);
+    sk_sp<SkSpecialImage> clippedResult(filter->filterImage(srcImg.get(), clipped,
+                                                            &clippedOffset));
+    sk_sp<SkSpecialImage> croppedResult(filter->filterImage(croppedImg.get(), whole,
+                                                            &croppedOffset));
+    REPORTER_ASSERT(reporter, clippedResult && croppedResult);
+    REPORTER_ASSERT(reporter, clippedOffset == SkIPoint::Make(clip.x(), clip.y()));
+    REPORTER_ASSERT(reporter, croppedOffset == SkIPoint::Make(0, 0));
+
+    croppedOffset += SkIPoint::Make(clip.x(), clip.y());
+    SkBitmap clippedBM = draw_at_offset(clippedResult.get(), clippedOffset, kWidth, kHeight);
+    SkBitmap expectedBM = draw_at_offset(croppedResult.get(), croppedOffset, kWidth, kHeight);
+    for (int y = 0; y < kHeight; ++y) {
+        if (memcmp(clippedBM.getAddr32(0, y), expectedBM.getAddr32(0, y),
+                   kWidth * sizeof(SkPMColor))) {
+            ERRORF(reporter, "Row %d differs between the clipped and the cropped input.", y);
+            break;
+        }
+    }
+}
+
+class LightingImageFilterTester {
+public:
+    static void SetLightsOnePixelAtATime(SkImageFilter* filter, bool onePixelAtATime) {
+        static_cast<SkLightingImageFilter*>(filter)->setLightsOnePixelAtATime(onePixelAtATime);
+    }
+};
+
+// Interior pixels are lit four at a time; they must come out just as they do one at a time.
+DEF_TEST(ImageFilterLightingScalarMatchesVector, reporter) {
+    // Odd widths leave a partial group of four at the end of each row.
+    const int kWidth = 37, kHeight = 21;
+    SkBitmap srcBM;
+    srcBM.allocN32Pixels(kWidth, kHeight);
+    SkRandom rand;
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            *srcBM.getAddr32(x, y) = SkPreMultiplyColor(rand.nextU());
+        }
+    }
+    sk_sp<SkSpecialImage> srcImg(SkSpecialImage::MakeFromRaster(
+            SkIRect::MakeWH(kWidth, kHeight), srcBM));
+
+    // Noise at a large surface scale tilts normals nearly flat in every direction, so some face
+    // away from the half vector: N.H < 0, which a non-integer shininess raises to NaN.
+    const SkScalar kSurfaceScale = 4;
+    const SkScalar kShininess = 2.5f;
+    const SkPoint3 distant = SkPoint3::Make(1, 0.5f, 0.2f);
+    const SkPoint3 location = SkPoint3::Make(10, 5, 30);
+    const SkPoint3 target = SkPoint3::Make(kWidth / 2, kHeight / 2, 0);
+    sk_sp<SkImageFilter> filters[] = {
+        SkLightingImageFilter::MakeDistantLitDiffuse(distant, SK_ColorWHITE, kSurfaceScale, 1.2f,
+                                                     nullptr),
+        SkLightingImageFilter::MakePointLitDiffuse(location, 0xFFC08040, kSurfaceScale, 1.2f,
+                                                   nullptr),
+        SkLightingImageFilter::MakeSpotLitDiffuse(location, target, 1.5f, 60, SK_ColorWHITE,
+                                                  kSurfaceScale, 1.2f, nullptr),
+        SkLightingImageFilter::MakeDistantLitSpecular(distant, SK_ColorWHITE, kSurfaceScale, 1.5f,
+                                                      kShininess, nullptr),
+        SkLightingImageFilter::MakePointLitSpecular(location, 0xFFC08040, kSurfaceScale, 1.5f,
+                                                    kShininess, nullptr),
+        SkLightingImageFilter::MakeSpotLitSpecular(location, target, 1.5f, 60, SK_ColorWHITE,
+                                                   kSurfaceScale, 1.5f, kShininess, nullptr),
+    };
+
+    SkImageFilter::OutputProperties noColorSpace(nullptr);
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeWH(kWidth, kHeight), nullptr,
+                               noColorSpace);
+    for (int i = 0; i < (int)SK_ARRAY_COUNT(filters); ++i) {
+        SkIPoint vectorOffset, scalarOffset;
+        sk_sp<SkSpecialImage> vector(filters[i]->filterImage(srcImg.get(), ctx, &vectorOffset));
+        LightingImageFilterTester::SetLightsOnePixelAtATime(filters[i].get(), true);
+        sk_sp<SkSpecialImage> scalar(filters[i]->filterImage(srcImg.get(), ctx, &scalarOffset));
+
+        SkBitmap vectorBM, scalarBM;
+        if (!vector || !scalar || !vector->getROPixels(&vectorBM) ||
+            !scalar->getROPixels(&scalarBM) || vectorOffset != scalarOffset ||
+            vectorBM.width() != kWidth || scalarBM.width() != kWidth ||
+            vectorBM.height() != kHeight || scalarBM.height() != kHeight) {
+            ERRORF(reporter, "filter %d: expected two %dx%d results", i, kWidth, kHeight);
+            continue;
+        }
+        SkAutoLockPixels vectorLock(vectorBM), scalarLock(scalarBM);
+        for (int y = 0; y < kHeight; ++y) {
+            if (memcmp(vectorBM.getAddr32(0, y), scalarBM.getAddr32(0, y),
+                       kWidth * sizeof(SkPMColor))) {
+                ERRORF(reporter, "filter %d: row %d differs when lit one pixel at a time", i, y);
+                break;
+            }
+        }
+    }
+}
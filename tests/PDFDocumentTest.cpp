@@ -9,6 +9,7 @@
 #include "Resources.h"
 #include "SkCanvas.h"
 #include "SkDocument.h"
+#include "SkImageEncoder.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkStream.h"
@@ -222,3 +223,241 @@ DEF_TEST(SkPDF_pdfa_document, r) {
         }
     }
 }
+
+// Checks that every entry in the xref table points at the object it claims to.
+static bool xref_is_valid(const SkData* data) {
+    const char* pdf = (const char*)data->data();
+    size_t size = data->size();
+    const char kStartXref[] = "startxref\n";
+    size_t startXref = 0;
+    for (size_t i = 0; i + strlen(kStartXref) <= size; ++i) {
+        if (0 == memcmp(pdf + i, kStartXref, strlen(kStartXref))) {
+            startXref = i + strlen(kStartXref);
+        }
+    }
+    if (0 == startXref) {
+        return false;
+    }
+    SkString tail(pdf + startXref, size - startXref);
+    size_t xref = (size_t)atol(tail.c_str());
+    if (xref + 5 >= size || 0 != memcmp(pdf + xref, "xref\n", 5)) {
+        return false;
+    }
+    SkString table(pdf + xref, size - xref);
+    int count = 0;
+    if (1 != sscanf(table.c_str(), "xref\n0 %d\n", &count)) {
+        return false;
+    }
+    const char* entry = strstr(table.c_str(), "65535 f \n");
+    if (!entry) {
+        return false;
+    }
+    entry += strlen("65535 f \n");
+    // Each entry after the free one is 20 bytes long.
+    if (count < 1 || (size_t)(count - 1) * 20 > table.size() - (entry - table.c_str())) {
+        return false;
+    }
+    for (int i = 1; i < count; ++i, entry += 20) {
+        size_t offset = (size_t)atol(entry);
+        SkString expected;
+        expected.printf("%d 0 obj\n", i);
+        if (offset + expected.size() > size ||
+            0 != memcmp(pdf + offset, expected.c_str(), expected.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(SkPDF_streaming_document, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_streaming_document, r);
+    SkBitmap bm;
+    if (!GetResourceAsBitmap("mandrill_64.png", &bm)) {
+        return;
+    }
+
+    for (bool streamPages : {false, true}) {
+        SkDocument::PDFMetadata metadata;
+        metadata.fStreamPages = streamPages;
+        SkDynamicMemoryWStream stream;
+        sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream, SK_ScalarDefaultRasterDPI,
+                                                    metadata, nullptr, false);
+        size_t firstPageBytes = 0;
+        for (int page = 0; page < 3; ++page) {
+            SkCanvas* canvas = doc->beginPage(100, 100);
+            canvas->drawBitmap(bm, 0, 0);
+            canvas->drawText("HELLO", 5, 10, 80, SkPaint());
+            doc->endPage();
+            if (0 == page) {
+                firstPageBytes = stream.bytesWritten();
+            }
+        }
+        doc->close();
+
+        // Streaming writes the image as soon as the first page ends.
+        const size_t imageBytes = 64 * 64;
+        REPORTER_ASSERT(r, streamPages == (firstPageBytes > imageBytes));
+
+        sk_sp<SkData> data = stream.detachAsData();
+        REPORTER_ASSERT(r, xref_is_valid(data.get()));
+        REPORTER_ASSERT(r, contains(data->bytes(), data->size(), "/FontDescriptor"));
+    }
+}
+
+static int count_images(const SkData* data) {
+    const char kImage[] = "/Subtype /Image";
+    const size_t len = strlen(kImage);
+    int count = 0;
+    for (size_t i = 0; i + len <= data->size(); ++i) {
+        if (0 == memcmp(data->bytes() + i, kImage, len)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Images with the same contents are embedded once, even when they are
+// different SkImages.
+DEF_TEST(SkPDF_image_dedupe, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_image_dedupe, r);
+    SkBitmap bm;
+    bm.allocN32Pixels(32, 32);
+    bm.eraseColor(SK_ColorBLUE);
+    *bm.getAddr32(7, 7) = SkPreMultiplyColor(SK_ColorRED);
+    SkDynamicMemoryWStream jpegStream;
+    sk_sp<SkData> jpeg;
+    if (SkEncodeImage(&jpegStream, bm, SkEncodedImageFormat::kJPEG, 90)) {
+        jpeg = jpegStream.detachAsData();
+    }
+
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream);
+    SkCanvas* canvas = doc->beginPage(200, 200);
+    canvas->drawImage(SkImage::MakeFromBitmap(bm), 0, 0);
+    canvas->drawImage(SkImage::MakeRasterCopy(SkPixmap(bm.info(), bm.getPixels(),
+                                                       bm.rowBytes())), 40, 0);
+    if (jpeg) {
+        canvas->drawImage(SkImage::MakeFromEncoded(jpeg), 0, 40);
+        canvas->drawImage(SkImage::MakeFromEncoded(jpeg), 40, 40);
+    }
+    doc->endPage();
+    canvas = doc->beginPage(200, 200);
+    *bm.getAddr32(8, 8) = SkPreMultiplyColor(SK_ColorRED);
+    canvas->drawImage(SkImage::MakeRasterCopy(SkPixmap(bm.info(), bm.getPixels(),
+                                                       bm.rowBytes())), 0, 0);
+    doc->endPage();
+    doc->close();
+    sk_sp<SkData> data = stream.detachAsData();
+    REPORTER_ASSERT(r, count_images(data.get()) == (jpeg ? 3 : 2));
+}
+
+#ifdef SK_SUPPORT_PDF
+
+#include "SkBitSet.h"
+#include "SkPDFBitmap.h"
+#include "SkPDFDocument.h"
+#include "SkPDFFontCache.h"
+#include "SkResourceCache.h"
+
+// Keeps its font data in fontCache, not the process-wide cache other tests are using.
+static sk_sp<SkData> make_text_document(SkResourceCache* fontCache) {
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkPDFDocument> doc = sk_make_sp<SkPDFDocument>(&stream, nullptr,
+                                                         SK_ScalarDefaultRasterDPI,
+                                                         SkDocument::PDFMetadata(), nullptr,
+                                                         false);
+    doc->canon()->setFontCache(fontCache);
+    SkCanvas* canvas = doc->beginPage(200, 100);
+    SkPaint paint;
+    paint.setTypeface(SkTypeface::MakeDefault());
+    canvas->drawText("Hello, World!", 13, 10, 50, paint);
+    doc->close();
+    return stream.detachAsData();
+}
+
+DEF_TEST(SkPDF_image_content_key, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    bm.eraseColor(SK_ColorGREEN);
+    auto copy = [&bm] {
+        return SkImage::MakeRasterCopy(SkPixmap(bm.info(), bm.getPixels(), bm.rowBytes()));
+    };
+    sk_sp<SkImage> a = copy(), b = copy();
+    *bm.getAddr32(15, 15) = SkPreMultiplyColor(SK_ColorRED);
+    sk_sp<SkImage> c = copy();
+    REPORTER_ASSERT(r, SkPDFImageContentKey::Make(a.get()) == SkPDFImageContentKey::Make(b.get()));
+    REPORTER_ASSERT(r, SkPDFImageContentKey::Make(a.get()) != SkPDFImageContentKey::Make(c.get()));
+
+    sk_sp<SkData> png(a->encode(SkEncodedImageFormat::kPNG, 100));
+    if (png) {
+        sk_sp<SkImage> encoded = SkImage::MakeFromEncoded(png),
+                       encodedAgain = SkImage::MakeFromEncoded(SkData::MakeWithCopy(
+                                                  png->data(), png->size()));
+        if (encoded && encodedAgain) {
+            REPORTER_ASSERT(r, SkPDFImageContentKey::Make(encoded.get()) ==
+                               SkPDFImageContentKey::Make(encodedAgain.get()));
+            REPORTER_ASSERT(r, SkPDFImageContentKey::Make(encoded.get()) !=
+                               SkPDFImageContentKey::Make(a.get()));
+        }
+    }
+
+    // Once written, an image is no longer kept by the document.
+    SkNullWStream stream;
+    sk_sp<SkDocument> doc = SkDocument::MakePDF(&stream);
+    doc->beginPage(100, 100)->drawImage(a, 0, 0);
+    doc->endPage();
+    REPORTER_ASSERT(r, a->unique());
+    doc->close();
+}
+
+DEF_TEST(SkPDF_font_cache, r) {
+    REPORTER_ASSERT(r, SkPDFFontCache::GetTotalByteLimit() > 0);
+    SkResourceCache fontCache(1024 * 1024);
+
+    sk_sp<SkData> first = make_text_document(&fontCache);
+    REPORTER_ASSERT(r, fontCache.getTotalBytesUsed() > 0);
+
+    // A second document reuses the cached data and must not differ.
+    sk_sp<SkData> second = make_text_document(&fontCache);
+    REPORTER_ASSERT(r, first->equals(second.get()));
+
+    // Nor must a document made with everything purged as soon as it is added.
+    SkResourceCache tinyCache(1);
+    sk_sp<SkData> third = make_text_document(&tinyCache);
+    REPORTER_ASSERT(r, tinyCache.getTotalBytesUsed() <= 1);
+    REPORTER_ASSERT(r, first->equals(third.get()));
+}
+
+DEF_TEST(SkPDF_font_cache_advances, r) {
+    SkResourceCache fontCache(1024 * 1024);
+    sk_sp<SkTypeface> typeface = SkTypeface::MakeDefault();
+    int glyphCount = typeface->countGlyphs();
+    if (glyphCount < 4) {
+        return;
+    }
+
+    // Only the glyphs asked for (and glyph 0) are loaded.
+    SkBitSet some(glyphCount);
+    some.set(1);
+    uint16_t emSize;
+    sk_sp<SkData> advances = SkPDFFontCache::FindOrMakeAdvances(typeface.get(), some, &emSize,
+                                                                 &fontCache);
+    REPORTER_ASSERT(r, advances->size() == glyphCount * sizeof(int16_t));
+    const int16_t* known = (const int16_t*)advances->data();
+    REPORTER_ASSERT(r, known[0] != SK_MinS16 && known[1] != SK_MinS16);
+    REPORTER_ASSERT(r, known[2] == SK_MinS16 && known[3] == SK_MinS16);
+
+    // Asking again for them finds them; asking for more keeps what was already loaded.
+    REPORTER_ASSERT(r, advances == SkPDFFontCache::FindOrMakeAdvances(typeface.get(), some,
+                                                                       &emSize, &fontCache));
+    SkBitSet more(glyphCount);
+    more.set(3);
+    sk_sp<SkData> merged = SkPDFFontCache::FindOrMakeAdvances(typeface.get(), more, &emSize,
+                                                               &fontCache);
+    const int16_t* mergedKnown = (const int16_t*)merged->data();
+    REPORTER_ASSERT(r, mergedKnown[1] == known[1] && mergedKnown[2] == SK_MinS16);
+    REPORTER_ASSERT(r, mergedKnown[3] != SK_MinS16);
+    REPORTER_ASSERT(r, merged == SkPDFFontCache::FindOrMakeAdvances(typeface.get(), some,
+                                                                     &emSize, &fontCache));
+}
+#endif
@@ -0,0 +1,289 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkPathAnalysis.h"
+#include "SkPathOps.h"
+#include "SkPathPriv.h"
+#include "SkRandom.h"
+#include "SkRRect.h"
+#include "Test.h"
+
+// Samples points around both paths, and fails wherever the approximate result disagrees with
+// the exact one about a point that is farther than tolerance from the exact result's edge.
+static void check_deviation(skiatest::Reporter* reporter, const SkPath& one, const SkPath& two,
+                            SkPathOp op, SkScalar tolerance, const char* name) {
+    SkPath exact, approx;
+    if (!Op(one, two, op, &exact)) {
+        return;
+    }
+    SkPathOpsOptions options;
+    options.fPrecision = SkPathOpsOptions::kApproximate_Precision;
+    options.fTolerance = tolerance;
+    if (!Op(one, two, op, options, &approx)) {
+        ERRORF(reporter, "%s op %d: approximate op failed", name, op);
+        return;
+    }
+    REPORTER_ASSERT(reporter, exact.isInverseFillType() == approx.isInverseFillType());
+
+    SkRect bounds = one.getBounds();
+    bounds.join(two.getBounds());
+    bounds.outset(2, 2);
+    SkRandom rand;
+    int far = 0;
+    for (int i = 0; i < 4000; ++i) {
+        SkPoint pt = SkPoint::Make(rand.nextRangeScalar(bounds.fLeft, bounds.fRight),
+                                   rand.nextRangeScalar(bounds.fTop, bounds.fBottom));
+        bool inExact = exact.contains(pt.fX, pt.fY);
+        if (inExact == approx.contains(pt.fX, pt.fY)) {
+            continue;
+        }
+        bool nearEdge = false;
+        for (int step = 0; step < 32 && !nearEdge; ++step) {
+            SkVector offset = SkVector::Make(SkScalarCos(step * SK_ScalarPI / 16),
+                                             SkScalarSin(step * SK_ScalarPI / 16));
+            for (SkScalar radius : { tolerance, tolerance / 2, tolerance / 4 }) {
+                SkPoint near = pt + offset * radius;
+                nearEdge |= exact.contains(near.fX, near.fY) != inExact;
+            }
+        }
+        far += !nearEdge;
+    }
+    if (far) {
+        ERRORF(reporter, "%s op %d: %d points stray past the tolerance", name, op, far);
+    }
+}
+
+DEF_TEST(PathOpsApproximate, reporter) {
+    SkPath circle, circle2, rect, rrect, star, cubic;
+    circle.addCircle(50, 50, 40);
+    circle2.addCircle(80, 60, 35);
+    rect.addRect(20, 20, 120, 70);
+    rrect.addRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(30, 10, 100, 110), 15, 25));
+    star.moveTo(60, 0);
+    for (int i = 1; i < 5; ++i) {
+        SkScalar angle = i * 4 * SK_ScalarPI / 5;
+        star.lineTo(60 + 55 * SkScalarSin(angle), 55 - 55 * SkScalarCos(angle));
+    }
+    star.close();
+    cubic.moveTo(10, 10);
+    cubic.cubicTo(200, 0, -50, 100, 120, 120);
+    cubic.close();
+    SkPath evenOddStar(star);
+    evenOddStar.setFillType(SkPath::kEvenOdd_FillType);
+    SkPath inverseCircle(circle2);
+    inverseCircle.setFillType(SkPath::kInverseWinding_FillType);
+
+    const struct {
+        const SkPath* fOne;
+        const SkPath* fTwo;
+        const char*   fName;
+    } kPairs[] = {
+        { &circle, &circle2,       "circles" },
+        { &rect,   &rrect,         "rect rrect" },
+        { &star,   &circle,        "star circle" },
+        { &evenOddStar, &rrect,    "even-odd star rrect" },
+        { &circle, &inverseCircle, "circle inverse circle" },
+        { &cubic,  &star,          "cubic star" },
+        { &rect,   &rect,          "rect rect" },
+    };
+    for (const auto& pair : kPairs) {
+        for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+            check_deviation(reporter, *pair.fOne, *pair.fTwo, (SkPathOp) op, 0.25f, pair.fName);
+        }
+    }
+
+    // Random, self-intersecting polygons, some with quads.
+    SkRandom rand;
+    for (int i = 0; i < 100; ++i) {
+        SkPath paths[2];
+        for (SkPath& path : paths) {
+            path.moveTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+            for (int points = rand.nextRangeU(2, 12); points > 0; --points) {
+                if (rand.nextBool()) {
+                    path.quadTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100),
+                                rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+                } else {
+                    path.lineTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+                }
+            }
+            path.close();
+            if (rand.nextBool()) {
+                path.setFillType(SkPath::kEvenOdd_FillType);
+            }
+        }
+        check_deviation(reporter, paths[0], paths[1], (SkPathOp) rand.nextULessThan(5), 0.25f,
+                        "random");
+    }
+}
+
+// rRect1x from PathOpsOpTest: rounded corners as conics, even-odd, touching at the corners.
+static void make_rrect1x(SkPath* one, SkPath* two) {
+    one->setFillType(SkPath::kEvenOdd_FillType);
+    one->moveTo(20.65f, 5.65f);
+    one->conicTo(20.65f, 1.13612f, 25.1404f, 0.65f, 0.888488f);
+    one->lineTo(25.65f, 0.65f);
+    one->lineTo(26.1596f, 0.67604f);
+    one->conicTo(30.65f, 1.13612f, 30.65f, 5.65f, 0.888488f);
+    one->lineTo(30.65f, 25.65f);
+    one->conicTo(30.65f, 20.65f, 25.65f, 20.65f, 0.707107f);
+    one->lineTo(20.65f, 20.65f);
+    one->lineTo(20.65f, 5.65f);
+    one->close();
+    one->moveTo(20.65f, 20.65f);
+    one->lineTo(5.65f, 20.65f);
+    one->conicTo(0.65f, 20.65f, 0.65f, 25.65f, 0.707107f);
+    one->lineTo(0.65f, 45.65f);
+    one->conicTo(0.65f, 50.65f, 5.65f, 50.65f, 0.707107f);
+    one->lineTo(25.65f, 50.65f);
+    one->conicTo(30.65f, 50.65f, 30.65f, 45.65f, 0.707107f);
+    one->lineTo(30.65f, 25.65f);
+    one->conicTo(30.65f, 30.65f, 25.65f, 30.65f, 0.707107f);
+    one->conicTo(20.65f, 30.65f, 20.65f, 25.65f, 0.707107f);
+    one->lineTo(20.65f, 20.65f);
+    one->close();
+
+    two->moveTo(20.65f, 45.65f);
+    two->lineTo(20.65f, 25.65f);
+    two->conicTo(20.65f, 20.65f, 25.65f, 20.65f, 0.707107f);
+    two->lineTo(45.65f, 20.65f);
+    two->conicTo(50.65f, 20.65f, 50.65f, 25.65f, 0.707107f);
+    two->lineTo(50.65f, 45.65f);
+    two->conicTo(50.65f, 50.65f, 45.65f, 50.65f, 0.707107f);
+    two->lineTo(25.65f, 50.65f);
+    two->conicTo(20.65f, 50.65f, 20.65f, 45.65f, 0.707107f);
+    two->close();
+}
+
+// issue414409 from PathOpsBattles: two arcs of a ring, built from cubics, that share an end.
+static void make_issue414409(SkPath* one, SkPath* two) {
+    one->moveTo(9.53595e-07f, -60);
+    one->lineTo(5.08228e-15f, -83);
+    one->cubicTo(32.8673f, -83, 62.6386f, -63.6055f, 75.9208f, -33.5416f);
+    one->cubicTo(89.2029f, -3.47759f, 83.4937f, 31.5921f, 61.3615f, 55.8907f);
+    one->lineTo(46.9383f, 68.4529f);
+    one->lineTo(33.9313f, 49.484f);
+    one->cubicTo(37.7451f, 46.8689f, 41.2438f, 43.8216f, 44.3577f, 40.4029f);
+    one->lineTo(44.3577f, 40.4029f);
+    one->cubicTo(60.3569f, 22.8376f, 64.4841f, -2.51392f, 54.8825f, -24.2469f);
+    one->cubicTo(45.2809f, -45.9799f, 23.7595f, -60, 9.53595e-07f, -60);
+    one->close();
+
+    two->moveTo(46.9383f, 68.4529f);
+    two->cubicTo(17.5117f, 88.6307f, -21.518f, 87.7442f, -49.9981f, 66.251f);
+    two->cubicTo(-78.4781f, 44.7578f, -90.035f, 7.46781f, -78.7014f, -26.3644f);
+    two->cubicTo(-67.3679f, -60.1967f, -35.6801f, -83, -1.48383e-06f, -83);
+    two->lineTo(4.22689e-14f, -60);
+    two->cubicTo(-25.7929f, -60, -48.6997f, -43.5157f, -56.8926f, -19.0586f);
+    two->cubicTo(-65.0855f, 5.39842f, -56.7312f, 32.355f, -36.1432f, 47.8923f);
+    two->cubicTo(-15.5552f, 63.4296f, 12.6591f, 64.0704f, 33.9313f, 49.484f);
+    two->lineTo(46.9383f, 68.4529f);
+    two->close();
+}
+
+// The same pairs PathOpsApproximateBench times, so the speed it reports is for results that
+// stay within the tolerance.
+DEF_TEST(PathOpsApproximateCorpus, reporter) {
+    SkPath rrectOne, rrectTwo, battleOne, battleTwo;
+    make_rrect1x(&rrectOne, &rrectTwo);
+    make_issue414409(&battleOne, &battleTwo);
+    for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+        for (SkScalar tolerance : { 0.25f, 0.05f }) {
+            check_deviation(reporter, rrectOne, rrectTwo, (SkPathOp) op, tolerance, "rRect1x");
+            check_deviation(reporter, battleOne, battleTwo, (SkPathOp) op, tolerance,
+                            "issue414409");
+        }
+    }
+}
+
+static SkScalar distance_to_polyline(const SkPoint& pt, const SkPath& polyline) {
+    SkScalar best = SK_ScalarMax;
+    SkPath::Iter iter(polyline, false);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        if (SkPath::kLine_Verb == verb) {
+            best = SkTMin(best, pt.distanceToLineSegmentBetween(pts[0], pts[1]));
+        }
+    }
+    return best;
+}
+
+// Conics go to quads and quads go to lines, each within half the tolerance, so that the two
+// steps together stay within it. Flattening both at the whole tolerance strays up to 1.9 times
+// it on the nearly circular arcs below.
+DEF_TEST(PathOpsApproximateConicTolerance, reporter) {
+    const struct {
+        SkPoint  fControl;
+        SkScalar fWeight;
+        SkScalar fTolerance;
+    } kConics[] = {
+        { {  100,      300      }, 0.1f,      0.25f },
+        { {  100,      300      }, 0.707107f, 0.25f },
+        { {  100,      300      }, 10.0f,     0.25f },
+        { {  -3.8147f, 173.92f  }, 1.00594f,  0.743743f },
+        { { -12.6221f, 212.244f }, 1.01629f,  1.23129f },
+        { { -108.441f, 370.331f }, 1.00051f,  0.0590392f },
+    };
+    for (const auto& c : kConics) {
+        const SkPoint pts[3] = { { 0, 0 }, c.fControl, { 200, 0 } };
+        SkPath path;
+        path.moveTo(pts[0]);
+        path.conicTo(pts[1], pts[2], c.fWeight);
+        SkPath polyline = SkPathPriv::Analysis(path)->polyline(path, c.fTolerance);
+        SkConic conic(pts, c.fWeight);
+        SkScalar worst = 0;
+        for (int i = 0; i <= 512; ++i) {
+            worst = SkTMax(worst, distance_to_polyline(conic.evalAt(i / 512.0f), polyline));
+        }
+        if (worst > c.fTolerance * 1.001f) {
+            ERRORF(reporter, "weight %g tolerance %g: strays %g",
+                   c.fWeight, c.fTolerance, worst);
+        }
+
+        // The op flattens at half its tolerance, and snaps the rest of the way to its grid.
+        path.close();
+        SkPathOpsOptions options;
+        options.fPrecision = SkPathOpsOptions::kApproximate_Precision;
+        options.fTolerance = c.fTolerance * 2;
+        SkPath approx;
+        REPORTER_ASSERT(reporter, Op(path, SkPath(), kUnion_SkPathOp, options, &approx));
+        worst = 0;
+        for (int i = 0; i <= 512; ++i) {
+            worst = SkTMax(worst, distance_to_polyline(conic.evalAt(i / 512.0f), approx));
+        }
+        if (worst > options.fTolerance * 1.001f) {
+            ERRORF(reporter, "weight %g op tolerance %g: strays %g",
+                   c.fWeight, options.fTolerance, worst);
+        }
+    }
+}
+
+DEF_TEST(PathOpsApproximateFallback, reporter) {
+    SkPath one, two, exact, result;
+    one.addRect(0, 0, 1e9f, 1e9f);
+    two.addRect(5e8f, 5e8f, 2e9f, 2e9f);
+    SkPathOpsOptions options;
+    options.fPrecision = SkPathOpsOptions::kApproximate_Precision;
+
+    // Too large to snap to a grid of a quarter of the tolerance: this is the exact op.
+    REPORTER_ASSERT(reporter, Op(one, two, kIntersect_SkPathOp, &exact));
+    REPORTER_ASSERT(reporter, Op(one, two, kIntersect_SkPathOp, options, &result));
+    REPORTER_ASSERT(reporter, exact == result);
+
+    options.fTolerance = 0;
+    REPORTER_ASSERT(reporter, Op(one, two, kUnion_SkPathOp, &exact));
+    REPORTER_ASSERT(reporter, Op(one, two, kUnion_SkPathOp, options, &result));
+    REPORTER_ASSERT(reporter, exact == result);
+
+    SkPath nonFinite;
+    nonFinite.moveTo(0, 0);
+    nonFinite.lineTo(SK_ScalarNaN, 10);
+    nonFinite.lineTo(10, 10);
+    options.fTolerance = 0.25f;
+    REPORTER_ASSERT(reporter, !Op(nonFinite, two, kUnion_SkPathOp, options, &result));
+}
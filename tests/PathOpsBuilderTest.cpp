@@ -8,6 +8,8 @@
 #include "PathOpsExtendedTest.h"
 #include "PathOpsTestCommon.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 DEF_TEST(PathOpsBuilder, reporter) {
@@ -79,6 +81,57 @@ DEF_TEST(PathOpsBuilder, reporter) {
     REPORTER_ASSERT(reporter, pixelDiff == 0);
 }
 
+// Resolving all-union builders on an executor splits them into disjoint groups and unions each
+// as a tree; the area covered must come out the same as folding the paths in order.
+DEF_TEST(PathOpsBuilderExecutor, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+    SkRandom rand;
+    SkTArray<SkPath> paths;
+    for (int i = 0; i < 40; ++i) {
+        // L shapes, on a grid coarse enough that some stand alone and some overlap or touch.
+        int x = rand.nextRangeU(0, 20) * 4, y = rand.nextRangeU(0, 20) * 4;
+        int w = rand.nextRangeU(2, 8), h = rand.nextRangeU(2, 8);
+        SkPath& path = paths.push_back();
+        path.moveTo(x, y);
+        path.lineTo(x + w, y);
+        path.lineTo(x + w, y + h / 2);
+        path.lineTo(x + w / 2, y + h / 2);
+        path.lineTo(x + w / 2, y + h);
+        path.lineTo(x, y + h);
+        path.close();
+    }
+    // Two paths that only share an edge must still be merged.
+    paths.push_back().addRect(100, 100, 104, 104);
+    paths.push_back().addRect(104, 100, 108, 104);
+
+    SkOpBuilder serial, threaded;
+    for (const SkPath& path : paths) {
+        serial.add(path, kUnion_SkPathOp);
+        threaded.add(path, kUnion_SkPathOp);
+    }
+    SkPath expected, result;
+    REPORTER_ASSERT(reporter, serial.resolve(&expected));
+    REPORTER_ASSERT(reporter, threaded.resolve(&result, executor.get()));
+    int pixelDiff = comparePaths(reporter, __FUNCTION__, expected, result);
+    REPORTER_ASSERT(reporter, pixelDiff == 0);
+
+    // The touching rects come out as one contour.
+    SkPath touching;
+    SkOpBuilder pair;
+    pair.add(paths[paths.count() - 2], kUnion_SkPathOp);
+    pair.add(paths[paths.count() - 1], kUnion_SkPathOp);
+    REPORTER_ASSERT(reporter, pair.resolve(&touching, executor.get()));
+    REPORTER_ASSERT(reporter, touching.isRect(nullptr));
+
+    // Nothing but empty paths leaves no groups at all.
+    SkPath empty;
+    SkOpBuilder empties;
+    empties.add(SkPath(), kUnion_SkPathOp);
+    empties.add(SkPath(), kUnion_SkPathOp);
+    REPORTER_ASSERT(reporter, empties.resolve(&empty, executor.get()));
+    REPORTER_ASSERT(reporter, empty.isEmpty());
+}
+
 DEF_TEST(BuilderIssue3838, reporter) {
     SkPath path;
     path.moveTo(200, 170);
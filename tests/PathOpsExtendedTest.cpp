@@ -21,11 +21,12 @@
 #include <sys/sysctl.h>
 #endif
 
-bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+             int minSweepPairs
              SkDEBUGPARAMS(bool skipAssert)
              SkDEBUGPARAMS(const char* testName));
 
-bool SimplifyDebug(const SkPath& one, SkPath* result
+bool SimplifyDebug(const SkPath& one, SkPath* result, int minSweepPairs
                    SkDEBUGPARAMS(bool skipAssert)
                    SkDEBUGPARAMS(const char* testName));
 
@@ -462,7 +463,8 @@ static bool inner_simplify(skiatest::Reporter* reporter, const SkPath& path, con
     showPathData(path);
 #endif
     SkPath out;
-    if (!SimplifyDebug(path, &out  SkDEBUGPARAMS(SkipAssert::kYes == skipAssert)
+    if (!SimplifyDebug(path, &out, SkOpGlobalState::kMinSweepPairs
+            SkDEBUGPARAMS(SkipAssert::kYes == skipAssert)
             SkDEBUGPARAMS(testName))) {
         if (ExpectSuccess::kYes == expectSuccess) {
             SkDebugf("%s did not expect %s failure\n", __FUNCTION__, filename);
@@ -522,7 +524,8 @@ static bool innerPathOp(skiatest::Reporter* reporter, const SkPath& a, const SkP
     showName(a, b, shapeOp);
 #endif
     SkPath out;
-    if (!OpDebug(a, b, shapeOp, &out  SkDEBUGPARAMS(SkipAssert::kYes == skipAssert)
+    if (!OpDebug(a, b, shapeOp, &out, SkOpGlobalState::kMinSweepPairs
+            SkDEBUGPARAMS(SkipAssert::kYes == skipAssert)
             SkDEBUGPARAMS(testName))) {
         if (ExpectSuccess::kYes == expectSuccess) {
             SkDebugf("%s %s did not expect failure\n", __FUNCTION__, testName);
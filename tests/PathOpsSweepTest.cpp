@@ -0,0 +1,129 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkPathOpsTypes.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+             int minSweepPairs
+             SkDEBUGPARAMS(bool skipAssert)
+             SkDEBUGPARAMS(const char* testName));
+
+bool SimplifyDebug(const SkPath& one, SkPath* result, int minSweepPairs
+                   SkDEBUGPARAMS(bool skipAssert)
+                   SkDEBUGPARAMS(const char* testName));
+
+// Pairs of contours with many segments are swept to find the segments whose bounds meet,
+// instead of trying every pair. Both must find the same pairs in the same order, so the
+// results must be identical, not just close.
+
+static bool run_op(const SkPath& one, const SkPath* two, SkPathOp op, int minSweepPairs,
+                   SkPath* result) {
+    return two ? OpDebug(one, *two, op, result, minSweepPairs
+                         SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr))
+               : SimplifyDebug(one, result, minSweepPairs
+                               SkDEBUGPARAMS(true) SkDEBUGPARAMS(nullptr));
+}
+
+static void check_sweep(skiatest::Reporter* reporter, const SkPath& one, const SkPath* two,
+                        SkPathOp op, const char* name) {
+    SkPath tried, swept;
+    bool triedOK = run_op(one, two, op, SK_MaxS32, &tried);
+    bool sweptOK = run_op(one, two, op, 0, &swept);
+    if (triedOK != sweptOK || tried != swept) {
+        ERRORF(reporter, "%s op %d: sweeping changed the result", name, two ? op : -1);
+    }
+}
+
+// A ring of points at noisy distances from the center, like a coastline.
+static void add_ring(SkPath* path, SkScalar cx, SkScalar cy, int points, SkRandom* rand) {
+    for (int i = 0; i < points; ++i) {
+        SkScalar angle = 2 * SK_ScalarPI * i / points;
+        SkScalar radius = 100 + rand->nextRangeScalar(-15, 15);
+        SkPoint pt = SkPoint::Make(cx + radius * SkScalarCos(angle),
+                                   cy + radius * SkScalarSin(angle));
+        if (i) {
+            path->lineTo(pt);
+        } else {
+            path->moveTo(pt);
+        }
+    }
+    path->close();
+}
+
+// Steps up and to the right, so that a copy moved sideways shares part of every horizontal edge.
+static void add_stairs(SkPath* path, SkScalar dx, int steps) {
+    path->moveTo(dx, 0);
+    for (int i = 0; i < steps; ++i) {
+        path->lineTo(dx + i * 10 + 10, i * 10.0f);
+        path->lineTo(dx + i * 10 + 10, i * 10.0f + 10);
+    }
+    path->lineTo(dx, steps * 10.0f);
+    path->close();
+}
+
+DEF_TEST(PathOpsSweep, reporter) {
+    // One contour of 37 lines that crosses itself everywhere, so the sweep pairs a contour with
+    // itself and finds hundreds of crossings.
+    SkPath star;
+    for (int i = 0; i < 37; ++i) {
+        SkScalar angle = 2 * SK_ScalarPI * i * 16 / 37;
+        SkPoint pt = SkPoint::Make(100 * SkScalarSin(angle), -100 * SkScalarCos(angle));
+        if (i) {
+            star.lineTo(pt);
+        } else {
+            star.moveTo(pt);
+        }
+    }
+    star.close();
+    check_sweep(reporter, star, nullptr, kUnion_SkPathOp, "star");
+    star.setFillType(SkPath::kEvenOdd_FillType);
+    check_sweep(reporter, star, nullptr, kUnion_SkPathOp, "even-odd star");
+
+    SkRandom rand;
+    SkPath coast, coast2;
+    add_ring(&coast, 0, 0, 64, &rand);
+    add_ring(&coast2, 60, 30, 48, &rand);
+    check_sweep(reporter, coast, nullptr, kUnion_SkPathOp, "coast");
+
+    // Coincident edges: every horizontal edge of one staircase overlaps one of the other's.
+    SkPath stairs, stairs2;
+    add_stairs(&stairs, 0, 20);
+    add_stairs(&stairs2, 5, 20);
+
+    // A contour of 48 quads, to sweep curves as well as lines.
+    SkPath wave;
+    wave.moveTo(-120, 0);
+    for (int i = 0; i < 48; ++i) {
+        SkScalar angle = 2 * SK_ScalarPI * (i + 1) / 48;
+        SkScalar mid = 2 * SK_ScalarPI * (i + 0.5f) / 48;
+        SkScalar bulge = i & 1 ? 140.0f : 100.0f;
+        wave.quadTo(bulge * -SkScalarCos(mid), bulge * SkScalarSin(mid),
+                    120 * -SkScalarCos(angle), 120 * SkScalarSin(angle));
+    }
+    wave.close();
+    check_sweep(reporter, wave, nullptr, kUnion_SkPathOp, "wave");
+
+    const struct {
+        const SkPath* fOne;
+        const SkPath* fTwo;
+        const char*   fName;
+    } kPairs[] = {
+        { &coast,  &coast2,  "coasts" },
+        { &stairs, &stairs2, "stairs" },
+        { &stairs, &stairs,  "same stairs" },
+        { &star,   &coast,   "star coast" },
+        { &wave,   &coast2,  "wave coast" },
+    };
+    for (const auto& pair : kPairs) {
+        for (int op = kDifference_SkPathOp; op <= kReverseDifference_SkPathOp; ++op) {
+            check_sweep(reporter, *pair.fOne, pair.fTwo, (SkPathOp) op, pair.fName);
+        }
+    }
+}
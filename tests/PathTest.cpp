@@ -4751,3 +4751,94 @@ DEF_TEST(path_tight_bounds, reporter) {
         }
     }
 }
+
+#include "SkPathAnalysis.h"
+DEF_TEST(path_analysis, reporter) {
+    SkPath convex;
+    convex.moveTo(0, 0);
+    convex.lineTo(100, 0);
+    convex.quadTo(150, 50, 100, 100);
+    convex.lineTo(0, 100);
+    convex.close();
+
+    // Copies share the analysis, and what one works out the others know.
+    SkPath copy(convex);
+    REPORTER_ASSERT(reporter, SkPathPriv::Analysis(copy) == SkPathPriv::Analysis(convex));
+    REPORTER_ASSERT(reporter, SkPath::kUnknown_Convexity == copy.getConvexityOrUnknown());
+    SkPathPriv::FirstDirection dir;
+    REPORTER_ASSERT(reporter,
+                    SkPath::kUnknown_Convexity == SkPathPriv::SharedConvexity(copy, &dir));
+    REPORTER_ASSERT(reporter, convex.isConvex());
+    REPORTER_ASSERT(reporter, SkPath::kUnknown_Convexity == copy.getConvexityOrUnknown());
+    REPORTER_ASSERT(reporter,
+                    SkPath::kConvex_Convexity == SkPathPriv::SharedConvexity(copy, &dir));
+    REPORTER_ASSERT(reporter, SkPathPriv::kCW_FirstDirection == dir);
+    REPORTER_ASSERT(reporter, copy.isConvex());
+
+    // Editing a copy gives it its own points, and its own analysis.
+    copy.lineTo(50, 50);
+    REPORTER_ASSERT(reporter, SkPathPriv::Analysis(copy) != SkPathPriv::Analysis(convex));
+    REPORTER_ASSERT(reporter,
+                    SkPath::kUnknown_Convexity == SkPathPriv::SharedConvexity(copy, &dir));
+    REPORTER_ASSERT(reporter, !copy.isConvex());
+    REPORTER_ASSERT(reporter, convex.isConvex());
+
+    // An edited path works its convexity out anew, and shares concave answers as well.
+    SkPath edited(convex);
+    edited.setLastPt(50, 50);
+    edited.lineTo(0, 100);
+    REPORTER_ASSERT(reporter,
+                    SkPath::kUnknown_Convexity == SkPathPriv::SharedConvexity(edited, &dir));
+    REPORTER_ASSERT(reporter, !edited.isConvex());
+    REPORTER_ASSERT(reporter,
+                    SkPath::kConcave_Convexity == SkPathPriv::SharedConvexity(edited, &dir));
+
+    // Editing a path in place forgets what was worked out about its old points.
+    SkPath curve;
+    curve.moveTo(0, 0);
+    curve.cubicTo(0, 100, 100, -100, 100, 0);
+    curve.close();
+    SkRect bounds;
+    REPORTER_ASSERT(reporter, TightBounds(curve, &bounds));
+    REPORTER_ASSERT(reporter, bounds.height() < 100);
+    REPORTER_ASSERT(reporter, TightBounds(curve, &bounds));
+    SkMatrix scale;
+    scale.setScale(2, 2);
+    curve.transform(scale);
+    SkRect scaled;
+    REPORTER_ASSERT(reporter, TightBounds(curve, &scaled));
+    REPORTER_ASSERT(reporter, nearly_equal(scaled, SkRect::MakeLTRB(bounds.fLeft * 2,
+            bounds.fTop * 2, bounds.fRight * 2, bounds.fBottom * 2)));
+    curve.reset();
+    curve.addRect(0, 0, 10, 10);
+    REPORTER_ASSERT(reporter, TightBounds(curve, &bounds));
+    REPORTER_ASSERT(reporter, SkRect::MakeWH(10, 10) == bounds);
+
+    // Polylines are lines only, stay within the tolerance, and are flattened once per tolerance.
+    SkPath circle;
+    circle.addCircle(50, 50, 40);
+    SkPathAnalysis* analysis = SkPathPriv::Analysis(circle);
+    SkPath polyline = analysis->polyline(circle, 0.25f);
+    REPORTER_ASSERT(reporter, SkPath::kLine_SegmentMask == polyline.getSegmentMasks());
+    for (int i = 0; i < polyline.countPoints(); ++i) {
+        SkScalar distance = SkPoint::Distance(polyline.getPoint(i), SkPoint::Make(50, 50));
+        REPORTER_ASSERT(reporter, SkScalarAbs(distance - 40) <= 0.25f);
+    }
+    REPORTER_ASSERT(reporter, analysis->polyline(circle, 0.25f).getGenerationID() ==
+                              polyline.getGenerationID());
+    SkPath finer = analysis->polyline(circle, 0.0625f);
+    REPORTER_ASSERT(reporter, finer.countPoints() > polyline.countPoints());
+    for (SkScalar tolerance : { 1.f, 2.f, 4.f, 8.f }) {
+        analysis->polyline(circle, tolerance);
+    }
+    REPORTER_ASSERT(reporter, analysis->polyline(circle, 0.25f).getGenerationID() !=
+                              polyline.getGenerationID());
+    REPORTER_ASSERT(reporter, analysis->polyline(circle, 0).isEmpty());
+
+    SkPath evenOdd(circle);
+    evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+    REPORTER_ASSERT(reporter, SkPath::kEvenOdd_FillType ==
+                              SkPathPriv::Analysis(evenOdd)->polyline(evenOdd, 1).getFillType());
+    REPORTER_ASSERT(reporter, SkPath::kWinding_FillType ==
+                              analysis->polyline(circle, 1).getFillType());
+}
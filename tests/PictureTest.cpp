@@ -11,8 +11,10 @@
 #include "SkCanvas.h"
 #include "SkColorMatrixFilter.h"
 #include "SkColorPriv.h"
+#include "SkCornerPathEffect.h"
 #include "SkDashPathEffect.h"
 #include "SkData.h"
+#include "SkExecutor.h"
 #include "SkImageGenerator.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
@@ -1086,6 +1088,213 @@ DEF_TEST(Picture_preserveCullRect, r) {
     REPORTER_ASSERT(r, deserializedPicture->cullRect().bottom() == 4);
 }
 
+static bool draws_same(const SkPicture* a, const SkPicture* b, const SkIRect& clip) {
+    SkBitmap bitmaps[2];
+    const SkPicture* pictures[] = { a, b };
+    for (int i = 0; i < 2; ++i) {
+        bitmaps[i].allocN32Pixels(100, 100);
+        bitmaps[i].eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.clipRect(SkRect::Make(clip));
+        canvas.drawPicture(pictures[i]);
+    }
+    return 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(), bitmaps[0].getSize());
+}
+
+DEF_TEST(Picture_lazyFromData, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(8, 8);
+    bm.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bm);
+
+    SkPictureRecorder recorder;
+    SkCanvas* c = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 200; ++i) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        SkScalar x = rand.nextRangeScalar(0, 90),
+                 y = rand.nextRangeScalar(0, 90);
+        c->drawRect(SkRect::MakeXYWH(x, y, 10, 10), paint);
+    }
+    c->drawImage(image, 50, 50);
+    sk_sp<SkData> data = recorder.finishRecordingAsPicture()->serialize();
+
+    sk_sp<SkPicture> eager = SkPicture::MakeFromData(data.get());
+    sk_sp<SkPicture> lazy = SkPicture::MakeLazyFromData(data);
+    REPORTER_ASSERT(r, eager && lazy);
+    if (!eager || !lazy) {
+        return;
+    }
+
+    // The header alone tells us the bounds.
+    REPORTER_ASSERT(r, lazy->cullRect() == SkRect::MakeWH(100, 100));
+
+    // Tiles and the whole picture draw the same as the eagerly parsed picture.
+    REPORTER_ASSERT(r, draws_same(eager.get(), lazy.get(), SkIRect::MakeWH(100, 100)));
+    REPORTER_ASSERT(r, draws_same(eager.get(), lazy.get(), SkIRect::MakeXYWH(40, 40, 25, 25)));
+    REPORTER_ASSERT(r, draws_same(eager.get(), lazy.get(), SkIRect::MakeXYWH(0, 75, 25, 25)));
+    REPORTER_ASSERT(r, lazy->approximateOpCount() == eager->approximateOpCount());
+
+    // Once parsed, the ops are indexed for tile-restricted playback.
+    REPORTER_ASSERT(r, lazy->asSkBigPicture() && lazy->asSkBigPicture()->bbh());
+
+    // Reserializing a lazy picture round trips.
+    sk_sp<SkPicture> again = SkPicture::MakeFromData(lazy->serialize().get());
+    REPORTER_ASSERT(r, again && draws_same(eager.get(), again.get(), SkIRect::MakeWH(100, 100)));
+
+    // A bad header is rejected up front; bad contents draw nothing.
+    REPORTER_ASSERT(r, !SkPicture::MakeLazyFromData(SkData::MakeWithCString("not an skp")));
+    REPORTER_ASSERT(r, !SkPicture::MakeLazyFromData(nullptr));
+    sk_sp<SkPicture> broken = SkPicture::MakeLazyFromData(
+            SkData::MakeSubset(data.get(), 0, data->size() / 2));
+    REPORTER_ASSERT(r, broken);
+    if (broken) {
+        SkCanvas canvas(bm);
+        broken->playback(&canvas);
+        REPORTER_ASSERT(r, 0 == broken->approximateOpCount());
+    }
+}
+
+DEF_TEST(Picture_concurrentSerialization, r) {
+    SkPictureRecorder recorder;
+    SkCanvas* c = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 50; ++i) {
+        SkPath path;
+        path.moveTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+        for (int j = 0; j <= i % 7; ++j) {
+            path.quadTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100),
+                        rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+        }
+        paint.setColor(rand.nextU() | 0xFF000000);
+        c->drawPath(path, paint);
+    }
+    for (int i = 0; i < 8; ++i) {
+        SkBitmap bm;
+        bm.allocN32Pixels(4 + i, 4);
+        bm.eraseColor(rand.nextU() | 0xFF000000);
+        c->drawImage(SkImage::MakeFromBitmap(bm), 10.0f * i, 10.0f * i);
+    }
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeThreadPool(4);
+    SkDynamicMemoryWStream serial, parallel;
+    picture->serialize(&serial);
+    picture->serialize(&parallel, nullptr, executor.get());
+    sk_sp<SkData> serialData = serial.detachAsData(),
+                  parallelData = parallel.detachAsData();
+    REPORTER_ASSERT(r, serialData->equals(parallelData.get()));
+
+    sk_sp<SkPicture> eager = SkPicture::MakeFromData(serialData.get());
+    sk_sp<SkPicture> concurrent = SkPicture::MakeFromData(serialData.get(), nullptr,
+                                                          executor.get());
+    REPORTER_ASSERT(r, eager && concurrent);
+    if (eager && concurrent) {
+        REPORTER_ASSERT(r, draws_same(eager.get(), concurrent.get(), SkIRect::MakeWH(100, 100)));
+    }
+}
+
+static sk_sp<SkData> record_stars(bool shareObjects, SkPath::FillType fillType) {
+    // Each call builds a new path and paint, with new generation and unique IDs.
+    auto makePath = []() {
+        SkPath path;
+        path.moveTo(50, 5);
+        for (int i = 1; i < 5; ++i) {
+            SkScalar angle = i * 4 * SK_ScalarPI / 5;
+            path.lineTo(50 + 45 * SkScalarSin(angle), 50 - 45 * SkScalarCos(angle));
+        }
+        path.close();
+        return path;
+    };
+    auto makePaint = []() {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0xFF336699);
+        paint.setPathEffect(SkCornerPathEffect::Make(3));
+        return paint;
+    };
+
+    SkPictureRecorder recorder;
+    SkCanvas* c = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    const SkPath sharedPath = makePath();
+    const SkPaint sharedPaint = makePaint();
+    for (int i = 0; i < 100; ++i) {
+        SkPath path = shareObjects ? sharedPath : makePath();
+        path.setFillType(i & 1 ? fillType : SkPath::kWinding_FillType);
+        c->drawPath(path, shareObjects ? sharedPaint : makePaint());
+    }
+    return recorder.finishRecordingAsPicture()->serialize();
+}
+
+DEF_TEST(Picture_dedupesPathsAndPaints, r) {
+    // Separately built but equal paths and paints are written once, just like shared ones.
+    sk_sp<SkData> shared = record_stars(true,  SkPath::kWinding_FillType),
+                  copies = record_stars(false, SkPath::kWinding_FillType);
+    REPORTER_ASSERT(r, shared->size() == copies->size());
+
+    // Paths that differ only by fill type stay distinct.
+    sk_sp<SkData> evenOdd = record_stars(false, SkPath::kEvenOdd_FillType);
+    REPORTER_ASSERT(r, evenOdd->size() > copies->size());
+
+    sk_sp<SkPicture> a = SkPicture::MakeFromData(shared.get()),
+                     b = SkPicture::MakeFromData(copies.get()),
+                     c = SkPicture::MakeFromData(evenOdd.get());
+    REPORTER_ASSERT(r, a && b && c);
+    if (a && b && c) {
+        REPORTER_ASSERT(r, draws_same(a.get(), b.get(), SkIRect::MakeWH(100, 100)));
+        REPORTER_ASSERT(r, !draws_same(a.get(), c.get(), SkIRect::MakeWH(100, 100)));
+    }
+}
+
+// The header puts the op data at an odd offset, and where the file sits in memory moves
+// everything else, so load the same SKP from every 4-byte alignment.
+DEF_TEST(Picture_lazyFromDataAlignment, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    bm.eraseColor(SK_ColorRED);
+    sk_sp<SkData> png(SkImage::MakeFromBitmap(bm)->encode(SkEncodedImageFormat::kPNG, 100));
+    sk_sp<SkImage> encoded = SkImage::MakeFromEncoded(png);
+    REPORTER_ASSERT(r, encoded);
+    if (!encoded) {
+        return;
+    }
+
+    SkPictureRecorder nestedRecorder;
+    nestedRecorder.beginRecording(SkRect::MakeWH(50, 50))->drawCircle(25, 25, 20, SkPaint());
+    sk_sp<SkPicture> nested = nestedRecorder.finishRecordingAsPicture();
+
+    SkPictureRecorder recorder;
+    SkCanvas* c = recorder.beginRecording(SkRect::MakeWH(100, 100));
+    SkPaint paint;
+    paint.setColor(SK_ColorGREEN);
+    SkPath path;
+    path.moveTo(5, 5);
+    path.cubicTo(90, 0, 0, 90, 95, 95);
+    c->drawPath(path, paint);
+    c->drawImage(encoded, 60, 10);
+    c->drawPicture(nested);
+    c->drawRect(SkRect::MakeXYWH(70, 70, 20, 20), paint);
+    sk_sp<SkData> data = recorder.finishRecordingAsPicture()->serialize();
+
+    sk_sp<SkPicture> eager = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, eager);
+    for (size_t offset = 0; offset < 4 && eager; ++offset) {
+        SkAutoTMalloc<uint8_t> storage(data->size() + 4);
+        memcpy(storage.get() + offset, data->data(), data->size());
+        sk_sp<SkData> backing = SkData::MakeWithCopy(storage.get(), data->size() + 4);
+        sk_sp<SkPicture> lazy = SkPicture::MakeLazyFromData(
+                SkData::MakeSubset(backing.get(), offset, data->size()));
+        REPORTER_ASSERT(r, lazy);
+        if (lazy) {
+            REPORTER_ASSERT(r, draws_same(eager.get(), lazy.get(), SkIRect::MakeWH(100, 100)));
+            REPORTER_ASSERT(r, lazy->approximateOpCount() == eager->approximateOpCount());
+        }
+    }
+}
+
 #if SK_SUPPORT_GPU
 
 DEF_TEST(PictureGpuAnalyzer, r) {
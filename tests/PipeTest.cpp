@@ -185,3 +185,73 @@ DEF_TEST(Pipe_picture_draw_second, reporter) {
     size_t offset2 = stream.bytesWritten();
     REPORTER_ASSERT(reporter, offset2 <= 16);
 }
+
+static sk_sp<SkImage> make_solid_image(SkColor color) {
+    auto surface = SkSurface::MakeRasterN32Premul(16, 16);
+    surface->getCanvas()->clear(color);
+    return surface->makeImageSnapshot();
+}
+
+// Writes one frame drawing image, plays it back with deserializer, and returns its size.
+static size_t write_frame(SkPipeSerializer* serializer, SkPipeDeserializer* deserializer,
+                          SkImage* image, SkColor* drawn) {
+    SkDynamicMemoryWStream stream;
+    SkCanvas* wc = serializer->beginWrite(SkRect::MakeWH(16, 16), &stream);
+    wc->drawImage(image, 0, 0, nullptr);
+    serializer->endWrite();
+    size_t size = stream.bytesWritten();
+
+    auto surface = SkSurface::MakeRasterN32Premul(16, 16);
+    surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+    sk_sp<SkData> data = stream.detachAsData();
+    deserializer->playback(data->data(), data->size(), surface->getCanvas());
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+    surface->readPixels(bm.info(), bm.getPixels(), bm.rowBytes(), 0, 0);
+    *drawn = bm.getColor(8, 8);
+    return size;
+}
+
+DEF_TEST(Pipe_resource_budget, reporter) {
+    sk_sp<SkImage> red = make_solid_image(SK_ColorRED);
+    sk_sp<SkImage> blue = make_solid_image(SK_ColorBLUE);
+
+    SkPipeSerializer serializer;
+    SkPipeDeserializer deserializer;
+    SkColor drawn;
+
+    // Without a budget, every image stays defined across streams.
+    size_t first = write_frame(&serializer, &deserializer, red.get(), &drawn);
+    REPORTER_ASSERT(reporter, drawn == SK_ColorRED);
+    size_t redBytes = serializer.getResourceBytes();
+    REPORTER_ASSERT(reporter, redBytes > 0);
+    write_frame(&serializer, &deserializer, blue.get(), &drawn);
+    REPORTER_ASSERT(reporter, drawn == SK_ColorBLUE);
+    size_t bothBytes = serializer.getResourceBytes();
+    REPORTER_ASSERT(reporter, bothBytes > redBytes);
+    size_t again = write_frame(&serializer, &deserializer, red.get(), &drawn);
+    REPORTER_ASSERT(reporter, drawn == SK_ColorRED);
+    REPORTER_ASSERT(reporter, again < first);
+    REPORTER_ASSERT(reporter, serializer.getResourceBytes() == bothBytes);
+
+    // With a tiny budget, only the images drawn by the last frame stay defined.
+    serializer.setResourceBudget(1);
+    size_t evicting = write_frame(&serializer, &deserializer, red.get(), &drawn);
+    REPORTER_ASSERT(reporter, drawn == SK_ColorRED);
+    REPORTER_ASSERT(reporter, evicting == again + sizeof(uint32_t));  // plus one undef verb
+    REPORTER_ASSERT(reporter, serializer.getResourceBytes() == redBytes);
+
+    // Red is still defined...
+    REPORTER_ASSERT(reporter, write_frame(&serializer, &deserializer, red.get(), &drawn) == again);
+    REPORTER_ASSERT(reporter, drawn == SK_ColorRED);
+
+    // ... but blue was forgotten, so it must be sent again, and then red is forgotten.
+    size_t resent = write_frame(&serializer, &deserializer, blue.get(), &drawn);
+    REPORTER_ASSERT(reporter, drawn == SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, resent > again);
+    REPORTER_ASSERT(reporter, serializer.getResourceBytes() == bothBytes - redBytes);
+
+    size_t redAgain = write_frame(&serializer, &deserializer, red.get(), &drawn);
+    REPORTER_ASSERT(reporter, drawn == SK_ColorRED);
+    REPORTER_ASSERT(reporter, redAgain > again);
+}
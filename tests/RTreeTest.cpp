@@ -89,3 +89,32 @@ DEF_TEST(RTree, reporter) {
                                   expectedDepthMax >= rtree.getDepth());
     }
 }
+
+// Larger trees, with empty rects mixed in, must still report every hit in op order.
+DEF_TEST(RTree_Large, reporter) {
+    SkRandom rand;
+    for (int count : {1, 11, 12, 5000}) {
+        SkAutoTMalloc<SkRect> rects(count);
+        int nonEmpty = 0;
+        for (int i = 0; i < count; ++i) {
+            rects[i] = (i % 7 == 3) ? SkRect::MakeEmpty() : random_rect(rand);
+            nonEmpty += rects[i].isEmpty() ? 0 : 1;
+        }
+        SkRTree rtree;
+        rtree.insert(rects.get(), count);
+        REPORTER_ASSERT(reporter, nonEmpty == rtree.getCount());
+        REPORTER_ASSERT(reporter, rtree.getDepth() >= 1);
+
+        for (size_t i = 0; i < NUM_QUERIES; ++i) {
+            SkRect query = random_rect(rand);
+            SkTDArray<int> hits, expected;
+            rtree.search(query, &hits);
+            for (int j = 0; j < count; ++j) {
+                if (SkRect::Intersects(query, rects[j])) {
+                    expected.push(j);
+                }
+            }
+            REPORTER_ASSERT(reporter, hits == expected);
+        }
+    }
+}
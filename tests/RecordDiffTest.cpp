@@ -0,0 +1,122 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkCanvas.h"
+#include "SkPictureRecorder.h"
+#include "SkRecord.h"
+#include "SkRecordDiff.h"
+#include "SkRecorder.h"
+#include "SkSurface.h"
+
+static const int W = 200, H = 200;
+
+// A grid of 10x10 rects, with the rect at changed drawn blue instead of red,
+// and an extra oval recorded before the rect at inserted.
+static void draw_grid(SkCanvas* canvas, int changed = -1, int inserted = -1) {
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+    for (int i = 0; i < 100; i++) {
+        SkRect rect = SkRect::MakeXYWH((i % 10) * 20 + 5.0f, (i / 10) * 20 + 5.0f, 10, 10);
+        if (i == inserted) {
+            canvas->drawOval(rect, blue);
+        }
+        canvas->save();
+        canvas->translate(0.5f, 0);
+        canvas->drawRect(rect, i == changed ? blue : red);
+        canvas->restore();
+    }
+}
+
+static SkRegion damage(int changedBefore, int insertedBefore,
+                       int changedAfter,  int insertedAfter,
+                       const SkMatrix& ctm = SkMatrix::I()) {
+    SkRecord before, after;
+    SkRecorder beforeRecorder(&before, W, H),
+               afterRecorder(&after, W, H);
+    draw_grid(&beforeRecorder, changedBefore, insertedBefore);
+    draw_grid(&afterRecorder,  changedAfter,  insertedAfter);
+
+    SkRegion region;
+    SkRecordComputeDamage(before, SkRect::MakeWH(W, H), after, SkRect::MakeWH(W, H), ctm, &region);
+    return region;
+}
+
+DEF_TEST(RecordDiff_Identical, r) {
+    REPORTER_ASSERT(r, damage(-1, -1, -1, -1).isEmpty());
+    REPORTER_ASSERT(r, damage(42, 17, 42, 17).isEmpty());
+}
+
+DEF_TEST(RecordDiff_ChangedOps, r) {
+    // Rect 12 is at (45.5,25)-(55.5,35); damage is outset a pixel and rounded out.
+    SkRegion region = damage(-1, -1, 12, -1);
+    REPORTER_ASSERT(r, region.isRect());
+    REPORTER_ASSERT(r, region.getBounds() == SkIRect::MakeLTRB(44, 24, 57, 36));
+
+    // Under a scale, so is the damage.
+    region = damage(-1, -1, 12, -1, SkMatrix::MakeScale(2, 2));
+    REPORTER_ASSERT(r, region.getBounds() == SkIRect::MakeLTRB(90, 49, 112, 71));
+
+    // Two separate changes damage two separate areas, and nothing in between.
+    region = damage(0, -1, 99, -1);
+    REPORTER_ASSERT(r, region.isComplex());
+    REPORTER_ASSERT(r, region.contains(SkIRect::MakeLTRB(5, 5, 15, 15)));
+    REPORTER_ASSERT(r, region.contains(SkIRect::MakeLTRB(185, 185, 195, 195)));
+    REPORTER_ASSERT(r, !region.intersects(SkIRect::MakeLTRB(20, 20, 180, 180)));
+}
+
+DEF_TEST(RecordDiff_InsertedOps, r) {
+    // Just the oval is new; the ops after it all match the suffix.
+    SkRegion region = damage(-1, -1, -1, 50);
+    REPORTER_ASSERT(r, region.getBounds() == SkIRect::MakeLTRB(4, 104, 16, 116));
+
+    // The same, removed.
+    region = damage(-1, 50, -1, -1);
+    REPORTER_ASSERT(r, region.getBounds() == SkIRect::MakeLTRB(4, 104, 16, 116));
+}
+
+// Redrawing just the damage over the old picture must produce the new picture.
+DEF_TEST(RecordDiff_PartialRedraw, r) {
+    auto record = [](int changed, int inserted) {
+        SkPictureRecorder recorder;
+        draw_grid(recorder.beginRecording(W, H), changed, inserted);
+        return recorder.finishRecordingAsPicture();
+    };
+    sk_sp<SkPicture> before = record(3, -1),
+                     after  = record(77, 30);
+
+    const SkMatrix ctm = SkMatrix::MakeScale(1.5f, 1.25f);
+    SkRegion region;
+    SkPictureComputeDamage(before.get(), after.get(), ctm, &region);
+    REPORTER_ASSERT(r, !region.isEmpty());
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 250);
+    auto full    = SkSurface::MakeRaster(info),
+         partial = SkSurface::MakeRaster(info);
+    full->getCanvas()->clear(SK_ColorWHITE);
+    full->getCanvas()->concat(ctm);
+    full->getCanvas()->drawPicture(after);
+
+    SkCanvas* canvas = partial->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    canvas->concat(ctm);
+    canvas->drawPicture(before);
+    canvas->resetMatrix();
+    canvas->clipRegion(region);
+    canvas->clear(SK_ColorWHITE);
+    canvas->concat(ctm);
+    canvas->drawPicture(after);
+
+    SkBitmap a, b;
+    a.allocPixels(info);
+    b.allocPixels(info);
+    full   ->readPixels(a.info(), a.getPixels(), a.rowBytes(), 0, 0);
+    partial->readPixels(b.info(), b.getPixels(), b.rowBytes(), 0, 0);
+    REPORTER_ASSERT(r, 0 == memcmp(a.getPixels(), b.getPixels(), a.getSafeSize()));
+}
@@ -8,6 +8,7 @@
 #include "Test.h"
 #include "RecordTestUtils.h"
 
+#include "SkBBHFactory.h"
 #include "SkBlurImageFilter.h"
 #include "SkColorFilter.h"
 #include "SkRecord.h"
@@ -415,3 +416,86 @@ DEF_TEST(savelayer_srcmode_alpha, r) {
     do_savelayer_srcmode(r, 0x80FF0000);
 }
 
+
+DEF_TEST(RecordOpts_CoalesceDrawRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+
+    recorder.drawRect(SkRect::MakeXYWH( 0, 0, 10, 10), red);    // 0
+    recorder.drawRect(SkRect::MakeXYWH(20, 0, 10, 10), red);    // 1
+    recorder.clipRect(SkRect::MakeWH(200, 200));                // 2, NoOps are allowed in a run
+    recorder.drawRect(SkRect::MakeXYWH(40, 0, 10, 10), red);    // 3
+    recorder.drawRect(SkRect::MakeXYWH( 0, 0, 10, 10), blue);   // 4, paint differs
+    recorder.save();                                            // 5
+    recorder.drawRect(SkRect::MakeXYWH(10, 0, 10, 10), red);    // 6, alone
+    recorder.restore();                                         // 7
+    recorder.drawRect(SkRect::MakeLTRB(90, 90, 60, 60), blue);  // 8, unsorted
+    recorder.drawRect(SkRect::MakeXYWH(50, 70, 0, 0), blue);    // 9, empty
+    record.replace<SkRecords::NoOp>(2);
+
+    SkRecordCoalesceDrawRects(&record);
+
+    const SkRecords::DrawRects* rects = assert_type<SkRecords::DrawRects>(r, record, 0);
+    if (rects) {
+        REPORTER_ASSERT(r, 3 == rects->count);
+        REPORTER_ASSERT(r, SK_ColorRED == rects->paint.getColor());
+        REPORTER_ASSERT(r, SkRect::MakeLTRB(0, 0, 50, 10) == rects->bounds);
+        REPORTER_ASSERT(r, SkRect::MakeXYWH(40, 0, 10, 10) == rects->rects[2]);
+    }
+    for (int i : {1, 2, 3}) {
+        assert_type<SkRecords::NoOp>(r, record, i);
+    }
+    assert_type<SkRecords::DrawRect>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 6);
+
+    rects = assert_type<SkRecords::DrawRects>(r, record, 8);
+    if (rects) {
+        REPORTER_ASSERT(r, 2 == rects->count);
+        REPORTER_ASSERT(r, SkRect::MakeLTRB(50, 60, 90, 90) == rects->bounds);
+        REPORTER_ASSERT(r, SkRect::MakeLTRB(90, 90, 60, 60) == rects->rects[0]);
+    }
+    assert_type<SkRecords::NoOp>(r, record, 9);
+}
+
+// Pictures (which are always coalesced) must draw exactly what the rects drew directly,
+// including when the picture's bounding box hierarchy and the clip skip parts of it.
+DEF_TEST(RecordOpts_CoalesceDrawRectsDrawsSame, r) {
+    auto draw = [](SkCanvas* canvas) {
+        SkPaint fill, stroke;
+        fill.setColor(0x80FF0000);
+        stroke.setStyle(SkPaint::kStroke_Style);
+        stroke.setStrokeWidth(3);
+        for (int i = 0; i < 20; i++) {
+            canvas->drawRect(SkRect::MakeXYWH(i * 5.0f, i * 3.0f, 20, 20), fill);
+        }
+        for (int i = 0; i < 200; i++) {
+            canvas->drawRect(SkRect::MakeXYWH((i % 20) * 5.0f, (i / 20) * 10.0f, 0, 0), stroke);
+        }
+    };
+
+    SkRTreeFactory factory;
+    SkPictureRecorder recorder;
+    draw(recorder.beginRecording(100, 100, &factory));
+    sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    for (const SkRect& clip : { SkRect::MakeWH(100, 100), SkRect::MakeLTRB(50, 50, 100, 100) }) {
+        auto expected = SkSurface::MakeRaster(info),
+             actual   = SkSurface::MakeRaster(info);
+        expected->getCanvas()->clipRect(clip);
+        actual  ->getCanvas()->clipRect(clip);
+        draw(expected->getCanvas());
+        actual->getCanvas()->drawPicture(picture);
+
+        SkBitmap a, b;
+        a.allocPixels(info);
+        b.allocPixels(info);
+        expected->readPixels(a.info(), a.getPixels(), a.rowBytes(), 0, 0);
+        actual  ->readPixels(b.info(), b.getPixels(), b.rowBytes(), 0, 0);
+        REPORTER_ASSERT(r, 0 == memcmp(a.getPixels(), b.getPixels(), a.getSafeSize()));
+    }
+}
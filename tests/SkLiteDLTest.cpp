@@ -6,8 +6,10 @@
  */
 
 #include "Test.h"
+#include "SkCanvas.h"
 #include "SkLiteDL.h"
 #include "SkLiteRecorder.h"
+#include "SkRRect.h"
 
 DEF_TEST(SkLiteDL_basics, r) {
     SkLiteDL p;
@@ -51,3 +53,55 @@ DEF_TEST(SkLiteRecorder, r) {
         c->drawRect(SkRect{0,0,9,9}, SkPaint{});
     c->restore();
 }
+
+// A simple UI-like frame: a background, a list of rows, and a highlighted row.
+static void draw_frame(SkCanvas* c, int rows, int highlighted) {
+    SkPaint bg, row, hi, text;
+    bg.setColor(SK_ColorWHITE);
+    row.setColor(0xFFEEEEEE);
+    hi.setColor(0xFF3366FF);
+    text.setTextSize(8);
+
+    c->drawRect(SkRect::MakeWH(64, 64), bg);
+    for (int i = 0; i < rows; i++) {
+        c->save();
+            c->translate(0, i * 8.0f);
+            c->clipRect(SkRect::MakeWH(64, 7), kIntersect_SkClipOp, false);
+            c->drawRRect(SkRRect::MakeRectXY(SkRect::MakeWH(64, 7), 2, 2),
+                         i == highlighted ? hi : row);
+            c->drawText("row", 3, 2, 6, text);
+        c->restore();
+    }
+}
+
+DEF_TEST(SkLiteDL_rewind, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+    SkBitmap expected, actual;
+    expected.allocPixels(info);
+    actual.allocPixels(info);
+
+    SkLiteRecorder rec;
+    SkLiteDL reused;
+
+    // The same frame, a changed op, more ops, fewer ops, and different ops entirely.
+    struct { int rows, highlighted; } frames[] = {
+        {6, 2}, {6, 2}, {6, 3}, {8, 3}, {4, 3}, {0, -1}, {5, 0},
+    };
+    for (auto frame : frames) {
+        reused.rewind();
+        rec.reset(&reused, {0,0,64,64});
+        draw_frame(&rec, frame.rows, frame.highlighted);
+
+        SkLiteDL fresh;
+        rec.reset(&fresh, {0,0,64,64});
+        draw_frame(&rec, frame.rows, frame.highlighted);
+
+        expected.eraseColor(SK_ColorTRANSPARENT);
+        actual  .eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas expectedCanvas(expected), actualCanvas(actual);
+        fresh .draw(&expectedCanvas);
+        reused.draw(&actualCanvas);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.getSafeSize()));
+    }
+}
@@ -7,9 +7,12 @@
 
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkStrokeRec.h"
+#include "SkTArray.h"
 #include "Test.h"
 
 static bool equal(const SkRect& a, const SkRect& b) {
@@ -165,3 +168,164 @@ DEF_TEST(Stroke, reporter) {
     test_strokerect(reporter);
     test_strokerec_equality(reporter);
 }
+
+class StrokeTester {
+public:
+    static void SetUsePolylineStroker(SkStroke* stroke, bool use) {
+        stroke->setUsePolylineStroker(use);
+    }
+};
+
+// The polyline stroker should make exactly what the general one does.
+static void check_polyline_stroke(skiatest::Reporter* reporter, const SkStroke& stroke,
+                                  const SkPath& path) {
+    SkPath general, polyline;
+    SkStroke generalStroke(stroke);
+    StrokeTester::SetUsePolylineStroker(&generalStroke, false);
+    generalStroke.strokePath(path, &general);
+    stroke.strokePath(path, &polyline);
+
+    REPORTER_ASSERT(reporter, general.getFillType() == polyline.getFillType());
+    if (general.countVerbs() != polyline.countVerbs() ||
+        general.countPoints() != polyline.countPoints()) {
+        ERRORF(reporter, "cap %d join %d: %d verbs %d points, polyline %d verbs %d points",
+               stroke.getCap(), stroke.getJoin(), general.countVerbs(), general.countPoints(),
+               polyline.countVerbs(), polyline.countPoints());
+        return;
+    }
+    SkTDArray<uint8_t> generalVerbs, polylineVerbs;
+    generalVerbs.setCount(general.countVerbs());
+    polylineVerbs.setCount(polyline.countVerbs());
+    general.getVerbs(generalVerbs.begin(), generalVerbs.count());
+    polyline.getVerbs(polylineVerbs.begin(), polylineVerbs.count());
+    REPORTER_ASSERT(reporter, generalVerbs == polylineVerbs);
+    for (int i = 0; i < general.countPoints(); ++i) {
+        if (general.getPoint(i) != polyline.getPoint(i)) {
+            ERRORF(reporter, "cap %d join %d: point %d is (%g, %g), polyline (%g, %g)",
+                   stroke.getCap(), stroke.getJoin(), i,
+                   general.getPoint(i).fX, general.getPoint(i).fY,
+                   polyline.getPoint(i).fX, polyline.getPoint(i).fY);
+            return;
+        }
+    }
+}
+
+DEF_TEST(StrokePolyline, reporter) {
+    SkRandom rand;
+    SkTArray<SkPath> paths;
+    for (int i = 0; i < 40; ++i) {
+        SkPath path;
+        for (int contours = rand.nextRangeU(1, 3); contours > 0; --contours) {
+            path.moveTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+            for (int points = rand.nextRangeU(1, 30); points > 0; --points) {
+                path.lineTo(rand.nextRangeScalar(0, 100), rand.nextRangeScalar(0, 100));
+            }
+            if (rand.nextBool()) {
+                path.close();
+            }
+        }
+        if (i % 8 == 0) {
+            path.moveTo(0, 0);  // left for the iterator to skip
+        } else if (i % 8 == 1) {
+            path.setFillType(SkPath::kInverseEvenOdd_FillType);
+        }
+        paths.push_back(path);
+    }
+    // A convex polygon, stroked and filled without its center, closed on its first point.
+    paths.push_back().moveTo(50, 0);
+    for (int i = 1; i <= 12; ++i) {
+        paths.back().lineTo(50 + 50 * SkScalarSin(i * SK_ScalarPI / 6),
+                            50 - 50 * SkScalarCos(i * SK_ScalarPI / 6));
+    }
+    paths.back().close();
+    // Lines of no length, and lone points, are left to the general stroker.
+    paths.push_back().moveTo(10, 10);
+    paths.back().lineTo(20, 20);
+    paths.back().lineTo(20, 20);
+    paths.back().lineTo(30, 10);
+    paths.push_back().moveTo(10, 10);
+    paths.back().close();
+
+    for (const SkPath& path : paths) {
+        for (int cap = 0; cap < SkPaint::kCapCount; ++cap) {
+            for (int join = 0; join < SkPaint::kJoinCount; ++join) {
+                SkStroke stroke;
+                stroke.setCap((SkPaint::Cap) cap);
+                stroke.setJoin((SkPaint::Join) join);
+                stroke.setWidth(rand.nextRangeScalar(0.5f, 20));
+                stroke.setMiterLimit(rand.nextRangeScalar(0.5f, 8));
+                stroke.setResScale(rand.nextRangeScalar(0.25f, 4));
+                stroke.setDoFill(rand.nextBool());
+                check_polyline_stroke(reporter, stroke, path);
+            }
+        }
+    }
+}
+
+DEF_TEST(StrokeCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+    SkRandom rand;
+    SkPath path;
+    path.moveTo(0, 50);
+    for (int i = 1; i < 100; ++i) {
+        path.lineTo(SkIntToScalar(i), rand.nextRangeScalar(0, 100));
+    }
+    REPORTER_ASSERT(reporter, SkStrokeCache::ShouldCache(path));
+
+    SkStrokeRec rec(SkStrokeRec::kFill_InitStyle);
+    rec.setStrokeStyle(4);
+    rec.setStrokeParams(SkPaint::kRound_Cap, SkPaint::kRound_Join, 4);
+    SkPath stroke, found;
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &found, &cache));
+    REPORTER_ASSERT(reporter, rec.applyToPath(&stroke, path));
+    // Strokes built once are not kept, so that a path redrawn with new points every frame
+    // leaves the cache to others.
+    SkStrokeCache::Add(path, rec, stroke, &cache);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &found, &cache));
+    REPORTER_ASSERT(reporter, 0 == cache.getTotalBytesUsed());
+    SkStrokeCache::Add(path, rec, stroke, &cache);
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(path, rec, &found, &cache));
+    REPORTER_ASSERT(reporter, found == stroke);
+
+    // Moving the outline found to device space, as SkDraw does, leaves the cached one be.
+    SkPath fresh;
+    REPORTER_ASSERT(reporter, rec.applyToPath(&fresh, path));
+    found.transform(SkMatrix::MakeTrans(5, 5));
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(path, rec, &found, &cache));
+    REPORTER_ASSERT(reporter, found == fresh);
+
+    // Copies share points, and with them the outline; so do joins that ignore the miter limit.
+    SkPath copy(path);
+    SkStrokeRec otherMiter(rec);
+    otherMiter.setStrokeParams(SkPaint::kRound_Cap, SkPaint::kRound_Join, 10);
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(copy, otherMiter, &found, &cache));
+
+    SkStrokeRec wider(rec);
+    wider.setStrokeStyle(5);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, wider, &found, &cache));
+    SkStrokeRec finer(rec);
+    finer.setResScale(2);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, finer, &found, &cache));
+    copy.toggleInverseFillType();
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(copy, rec, &found, &cache));
+    path.lineTo(100, 0);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &found, &cache));
+
+    path.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::ShouldCache(path));
+    SkPath shortPath;
+    shortPath.moveTo(0, 0);
+    shortPath.lineTo(10, 10);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::ShouldCache(shortPath));
+
+    // Strokes found in the global cache match those made afresh.
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    SkPath first, second, third, uncached;
+    REPORTER_ASSERT(reporter, paint.getFillPath(copy, &first));
+    REPORTER_ASSERT(reporter, paint.getFillPath(copy, &second));
+    REPORTER_ASSERT(reporter, paint.getFillPath(copy, &third));
+    SkStroke(paint).strokePath(copy, &uncached);
+    REPORTER_ASSERT(reporter, first == uncached && second == uncached && third == uncached);
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PipeRaster.h"
+#include "SkCanvas.h"
+#include "SkStream.h"
+#include "SkTemplates.h"
+
+#include <atomic>
+#include <errno.h>
+#include <new>
+#include <semaphore.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static const int kMaxSlots = 8;
+
+// Lives at the front of the shared mapping, followed by the ring and then the pixel slots.
+// sem_post() and sem_wait() order the plain fields between the processes.
+struct PipeRasterShared {
+    struct Frame {
+        uint64_t fOffset;   // where the frame's commands start, counting from the ring's birth
+        uint64_t fLength;
+    };
+
+    sem_t                 fFrameReady;    // posted once per frame by the client, and to quit
+    sem_t                 fFrameDone;     // posted once per frame by the worker
+    sem_t                 fRingFreed;     // posted whenever the worker advances fRingTail
+    std::atomic<uint64_t> fRingTail;      // everything before this the worker is done with
+    bool                  fQuit;
+
+    uint64_t              fRingBytes;
+    size_t                fRingOffset;
+    size_t                fPixelsOffset;
+    size_t                fSlotBytes;
+    int                   fWidth, fHeight, fSlots;
+    Frame                 fFrames[kMaxSlots];
+
+    uint8_t* ring() { return (uint8_t*)this + fRingOffset; }
+    void* pixels(int slot) { return (uint8_t*)this + fPixelsOffset + slot * fSlotBytes; }
+    size_t rowBytes() const { return fWidth * sizeof(SkPMColor); }
+    SkImageInfo info() const { return SkImageInfo::MakeN32Premul(fWidth, fHeight); }
+};
+
+// Retries when a signal interrupts the wait.
+static void wait(sem_t* sem) {
+    while (sem_wait(sem) != 0 && EINTR == errno) {}
+}
+
+// Writes a frame's commands straight into the ring, blocking while the worker is still
+// playing back the frames that would be overwritten.
+class RingWStream : public SkWStream {
+public:
+    RingWStream(PipeRasterShared* shared) : fShared(shared) {}
+
+    void beginFrame() { fFrameStart = fHead; }
+    uint64_t frameStart() const { return fFrameStart; }
+    uint64_t head() const { return fHead; }
+
+    bool write(const void* buffer, size_t size) override {
+        const uint64_t capacity = fShared->fRingBytes;
+        if (fHead + size - fFrameStart > capacity) {
+            // Nothing could ever free up enough room, as the worker only takes whole frames.
+            SK_ABORT("PipeRaster: frame is larger than the ring; raise its size.");
+        }
+
+        const uint8_t* src = (const uint8_t*)buffer;
+        while (size > 0) {
+            uint64_t free = capacity -
+                            (fHead - fShared->fRingTail.load(std::memory_order_acquire));
+            if (0 == free) {
+                wait(&fShared->fRingFreed);
+                continue;
+            }
+            uint64_t offset = fHead % capacity;
+            size_t n = (size_t)SkTMin<uint64_t>(SkTMin<uint64_t>(size, free), capacity - offset);
+            memcpy(fShared->ring() + offset, src, n);
+            fHead += n;
+            src   += n;
+            size  -= n;
+        }
+        return true;
+    }
+
+    size_t bytesWritten() const override { return (size_t)fHead; }
+
+private:
+    PipeRasterShared* fShared;
+    uint64_t          fHead = 0;
+    uint64_t          fFrameStart = 0;
+};
+
+static void run_worker(PipeRasterShared* shared) {
+    const uint64_t capacity = shared->fRingBytes;
+
+    std::unique_ptr<SkCanvas> canvases[kMaxSlots];
+    for (int i = 0; i < shared->fSlots; ++i) {
+        canvases[i] = SkCanvas::MakeRasterDirect(shared->info(), shared->pixels(i),
+                                                 shared->rowBytes());
+    }
+
+    SkPipeDeserializer deserializer;
+    SkAutoTMalloc<uint8_t> scratch;
+    size_t scratchBytes = 0;
+
+    for (int frame = 0;; ++frame) {
+        wait(&shared->fFrameReady);
+        if (shared->fQuit) {
+            return;
+        }
+
+        const int slot = frame % shared->fSlots;
+        const PipeRasterShared::Frame& rec = shared->fFrames[slot];
+        const uint64_t start = rec.fOffset % capacity;
+        const size_t length = (size_t)rec.fLength;
+
+        // Play back right out of the ring, unless the frame wrapped around its end.
+        const void* data = shared->ring() + start;
+        if (start + length > capacity) {
+            if (scratchBytes < length) {
+                scratch.reset(length);
+                scratchBytes = length;
+            }
+            size_t first = (size_t)(capacity - start);
+            memcpy(scratch.get(), shared->ring() + start, first);
+            memcpy(scratch.get() + first, shared->ring(), length - first);
+            data = scratch.get();
+        }
+
+        SkCanvas* canvas = canvases[slot].get();
+        canvas->clear(SK_ColorTRANSPARENT);
+        deserializer.playback(data, length, canvas);
+        canvas->flush();
+
+        shared->fRingTail.store(rec.fOffset + rec.fLength, std::memory_order_release);
+        sem_post(&shared->fRingFreed);
+        sem_post(&shared->fFrameDone);
+    }
+}
+
+std::unique_ptr<PipeRasterClient> PipeRasterClient::Make(int width, int height,
+                                                         size_t ringBytes, int slots) {
+    if (width <= 0 || height <= 0 || slots < 1 || slots > kMaxSlots || ringBytes < 4) {
+        return nullptr;
+    }
+
+    // SkPipe writes whole 32-bit words, so keeping the ring a multiple of 4 keeps every frame
+    // aligned for playback straight out of it.
+    ringBytes = SkAlign4(ringBytes);
+    const size_t ringOffset = SkAlign8(sizeof(PipeRasterShared));
+    const size_t pixelsOffset = SkAlign8(ringOffset + ringBytes);
+    const size_t slotBytes = SkAlign8(width * height * sizeof(SkPMColor));
+    const size_t mappedBytes = pixelsOffset + slots * slotBytes;
+
+    void* mem = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == mem) {
+        SkDebugf("PipeRaster: could not map %zu bytes of shared memory.\n", mappedBytes);
+        return nullptr;
+    }
+
+    PipeRasterShared* shared = new (mem) PipeRasterShared;
+    if (0 != sem_init(&shared->fFrameReady, 1, 0) ||
+        0 != sem_init(&shared->fFrameDone,  1, 0) ||
+        0 != sem_init(&shared->fRingFreed,  1, 0)) {
+        SkDebugf("PipeRaster: process-shared semaphores are not supported here.\n");
+        munmap(mem, mappedBytes);
+        return nullptr;
+    }
+    shared->fRingTail.store(0);
+    shared->fQuit         = false;
+    shared->fRingBytes    = ringBytes;
+    shared->fRingOffset   = ringOffset;
+    shared->fPixelsOffset = pixelsOffset;
+    shared->fSlotBytes    = slotBytes;
+    shared->fWidth        = width;
+    shared->fHeight       = height;
+    shared->fSlots        = slots;
+
+    std::unique_ptr<PipeRasterClient> client(
+            new PipeRasterClient(shared, mappedBytes, width, height, slots));
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        SkDebugf("PipeRaster: fork() failed.\n");
+        return nullptr;
+    }
+    if (0 == pid) {
+        run_worker(shared);
+        _exit(0);
+    }
+    client->fPid = pid;
+    return client;
+}
+
+PipeRasterClient::PipeRasterClient(PipeRasterShared* shared, size_t mappedBytes,
+                                   int width, int height, int slots)
+    : fShared(shared)
+    , fMappedBytes(mappedBytes)
+    , fInfo(SkImageInfo::MakeN32Premul(width, height))
+    , fSlots(slots)
+    , fStream(new RingWStream(shared)) {}
+
+PipeRasterClient::~PipeRasterClient() {
+    if (fPid > 0) {
+        fShared->fQuit = true;
+        sem_post(&fShared->fFrameReady);
+        while (waitpid(fPid, nullptr, 0) < 0 && EINTR == errno) {}
+    }
+    sem_destroy(&fShared->fFrameReady);
+    sem_destroy(&fShared->fFrameDone);
+    sem_destroy(&fShared->fRingFreed);
+    fShared->~PipeRasterShared();
+    munmap(fShared, fMappedBytes);
+}
+
+SkCanvas* PipeRasterClient::beginFrame() {
+    SkASSERT(this->framesInFlight() < fSlots);
+    fStream->beginFrame();
+    return fSerializer.beginWrite(SkRect::MakeIWH(fInfo.width(), fInfo.height()),
+                                  fStream.get());
+}
+
+void PipeRasterClient::endFrame() {
+    fSerializer.endWrite();
+
+    PipeRasterShared::Frame& rec = fShared->fFrames[fSubmitted % fSlots];
+    rec.fOffset = fStream->frameStart();
+    rec.fLength = fStream->head() - fStream->frameStart();
+    fSubmitted++;
+    sem_post(&fShared->fFrameReady);
+}
+
+bool PipeRasterClient::finishFrame(SkPixmap* pixels) {
+    SkASSERT(this->framesInFlight() > 0);
+
+    // Wake up now and then to make sure there is still a worker to wait for.
+    for (;;) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += 1;
+        if (0 == sem_timedwait(&fShared->fFrameDone, &deadline)) {
+            break;
+        }
+        if (ETIMEDOUT == errno && waitpid(fPid, nullptr, WNOHANG) != 0) {
+            SkDebugf("PipeRaster: the worker exited.\n");
+            fPid = -1;
+            return false;
+        }
+    }
+
+    pixels->reset(fInfo, fShared->pixels(fFinished % fSlots), fShared->rowBytes());
+    fFinished++;
+    return true;
+}
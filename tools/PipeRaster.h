@@ -0,0 +1,81 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef PipeRaster_DEFINED
+#define PipeRaster_DEFINED
+
+#include "SkPipe.h"
+#include "SkPixmap.h"
+#include <memory>
+
+class SkCanvas;
+struct PipeRasterShared;
+class RingWStream;
+
+/**
+ *  Rasterizes frames in a forked worker process.
+ *
+ *  Each frame is recorded through an SkPipeCanvas straight into a ring buffer in memory shared
+ *  with the worker, which plays it back with an SkPipeDeserializer onto a raster surface whose
+ *  pixels also live in that shared memory.  Neither the commands nor the pixels are copied on
+ *  their way between the processes (unless a frame wraps around the end of the ring, in which
+ *  case the worker copies it once to make it contiguous).  The memory is anonymous and only
+ *  inherited across fork(), so the transport is strictly local.
+ *
+ *  The serializer and deserializer both live as long as the client, so images and typefaces
+ *  are only sent with the first frame that draws them.
+ *
+ *  POSIX only.
+ */
+class PipeRasterClient {
+public:
+    /**
+     *  Forks a worker that rasterizes frames of the given size, with enough shared memory for
+     *  ringBytes of commands and slots frames of pixels in flight.  Returns nullptr on failure.
+     */
+    static std::unique_ptr<PipeRasterClient> Make(int width, int height,
+                                                  size_t ringBytes, int slots);
+
+    // Asks the worker to exit and waits for it.
+    ~PipeRasterClient();
+
+    int slots() const { return fSlots; }
+    int framesInFlight() const { return fSubmitted - fFinished; }
+
+    /**
+     *  Starts recording a frame.  There must be fewer than slots() frames in flight.  A frame's
+     *  commands must fit in the ring, or this process aborts.
+     */
+    SkCanvas* beginFrame();
+
+    // Hands the frame begun by beginFrame() to the worker.
+    void endFrame();
+
+    /**
+     *  Blocks until the oldest frame in flight has been rasterized, and points pixels at its
+     *  shared memory.  The pixels stay valid until its slot is reused, slots() frames later.
+     *  Returns false if the worker went away.
+     */
+    bool finishFrame(SkPixmap* pixels);
+
+    SkPipeSerializer* serializer() { return &fSerializer; }
+
+private:
+    PipeRasterClient(PipeRasterShared*, size_t mappedBytes, int width, int height, int slots);
+
+    PipeRasterShared*           fShared;
+    size_t                      fMappedBytes;
+    SkImageInfo                 fInfo;
+    int                         fSlots;
+    int                         fPid = -1;
+    int                         fSubmitted = 0;
+    int                         fFinished = 0;
+    SkPipeSerializer            fSerializer;
+    std::unique_ptr<RingWStream> fStream;
+};
+
+#endif//PipeRaster_DEFINED
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "RecordProfile.h"
+
+#include "SkCanvas.h"
+#include "SkPixmap.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkTArray.h"
+#include "SkTemplates.h"
+#include "SkTime.h"
+
+#include <cmath>
+
+namespace {
+
+#define NAME(T) #T,
+static const char* kNames[] = { SK_RECORD_TYPES(NAME) };
+#undef NAME
+
+struct OpProfile {
+    int     type;
+    double  ns     = INFINITY;   // Fastest over all loops.
+    double  pixels = -1;         // Pixels changed, or -1 if not counted.
+    SkIRect devBounds;
+};
+
+class Profiler {
+public:
+    Profiler(SkCanvas* canvas, SkTArray<OpProfile>* ops, bool countPixels)
+        : fDraw(canvas, nullptr, nullptr, 0, nullptr)
+        , fOps(ops) {
+        if (countPixels && canvas->peekPixels(&fPixels)) {
+            fBefore.reset(fPixels.getSafeSize());
+        }
+    }
+
+    void setIndex(int index) { fIndex = index; }
+    void stopCountingPixels() { fBefore.reset(0); }
+
+    template <typename T>
+    void operator()(const T& command) {
+        OpProfile& op = (*fOps)[fIndex];
+        op.type = T::kType;
+
+        const bool counting = fBefore.get() && !op.devBounds.isEmpty();
+        if (counting) {
+            this->copyBounds(op.devBounds, fBefore.get());
+        }
+
+        auto start = SkTime::GetNSecs();
+        fDraw(command);
+        op.ns = SkTMin(op.ns, SkTime::GetNSecs() - start);
+
+        if (counting) {
+            op.pixels = this->countChanged(op.devBounds, fBefore.get());
+        }
+    }
+
+private:
+    void copyBounds(const SkIRect& r, uint8_t* dst) const {
+        const size_t rowBytes = r.width() * fPixels.info().bytesPerPixel();
+        for (int y = r.top(); y < r.bottom(); y++, dst += rowBytes) {
+            memcpy(dst, fPixels.addr(r.left(), y), rowBytes);
+        }
+    }
+
+    double countChanged(const SkIRect& r, const uint8_t* before) const {
+        const int bpp = fPixels.info().bytesPerPixel();
+        double changed = 0;
+        for (int y = r.top(); y < r.bottom(); y++) {
+            auto row = (const uint8_t*)fPixels.addr(r.left(), y);
+            for (int x = 0; x < r.width(); x++, row += bpp, before += bpp) {
+                changed += 0 != memcmp(row, before, bpp);
+            }
+        }
+        return changed;
+    }
+
+    SkRecords::Draw         fDraw;
+    SkTArray<OpProfile>*    fOps;
+    SkPixmap                fPixels;
+    SkAutoTMalloc<uint8_t>  fBefore;
+    int                     fIndex = 0;
+};
+
+Json::Value bounds_json(const SkIRect& r) {
+    Json::Value bounds(Json::arrayValue);
+    bounds.append(r.left());
+    bounds.append(r.top());
+    bounds.append(r.right());
+    bounds.append(r.bottom());
+    return bounds;
+}
+
+}  // namespace
+
+Json::Value ProfileRecord(const SkRecord& record,
+                          const SkRect& cullRect,
+                          SkCanvas* canvas,
+                          int loops,
+                          bool countPixels,
+                          int cellSize) {
+    SkASSERT(loops > 0 && cellSize > 0);
+    const int count = record.count();
+
+    // Find where each op can draw on the device.
+    SkTArray<OpProfile> ops(count);
+    ops.push_back_n(count);
+    {
+        SkAutoTMalloc<SkRect> bounds(count);
+        SkRecordFillBounds(cullRect, record, bounds.get());
+        const SkMatrix ctm = canvas->getTotalMatrix();
+        const SkIRect clip = canvas->getDeviceClipBounds();
+        for (int i = 0; i < count; i++) {
+            SkRect dev;
+            ctm.mapRect(&dev, bounds[i]);
+            if (!dev.roundOut().isEmpty() && ops[i].devBounds.intersect(dev.roundOut(), clip)) {
+                continue;
+            }
+            ops[i].devBounds.setEmpty();
+        }
+    }
+
+    Profiler profiler(canvas, &ops, countPixels);
+    for (int loop = 0; loop < loops; loop++) {
+        SkAutoCanvasRestore acr(canvas, true);
+        for (int i = 0; i < count; i++) {
+            profiler.setIndex(i);
+            record.visit(i, profiler);
+        }
+        // Only count pixels on the first loop; they won't change.
+        profiler.stopCountingPixels();
+    }
+
+    // Aggregate by op type and over the device.
+    const SkIRect device = canvas->getDeviceClipBounds();
+    const int columns = SkTMax(1, (device.right()  + cellSize - 1) / cellSize),
+              rows    = SkTMax(1, (device.bottom() + cellSize - 1) / cellSize);
+    SkAutoTMalloc<double> cells(columns * rows);
+    sk_bzero(cells.get(), columns * rows * sizeof(double));
+
+    const int kTypeCount = SK_ARRAY_COUNT(kNames);
+    int    typeCount [kTypeCount] = {};
+    double typeNs    [kTypeCount] = {};
+    double typePixels[kTypeCount] = {};
+
+    Json::Value opsJson(Json::arrayValue);
+    double totalNs = 0,
+           unattributedNs = 0;
+    for (int i = 0; i < count; i++) {
+        const OpProfile& op = ops[i];
+        if (op.type == SkRecords::NoOp_Type) {
+            continue;
+        }
+        totalNs += op.ns;
+        typeCount[op.type]++;
+        typeNs[op.type] += op.ns;
+        typePixels[op.type] += SkTMax(0.0, op.pixels);
+
+        Json::Value opJson;
+        opJson["index"] = i;
+        opJson["type"] = kNames[op.type];
+        opJson["ns"] = op.ns;
+        opJson["bounds"] = bounds_json(op.devBounds);
+        if (op.pixels >= 0) {
+            opJson["pixels"] = op.pixels;
+        }
+        opsJson.append(opJson);
+
+        const SkIRect& r = op.devBounds;
+        if (r.isEmpty()) {
+            unattributedNs += op.ns;
+            continue;
+        }
+        const double nsPerPixel = op.ns / ((double)r.width() * r.height());
+        for (int y = r.top() / cellSize; y <= (r.bottom() - 1) / cellSize && y < rows; y++) {
+        for (int x = r.left() / cellSize; x <= (r.right() - 1) / cellSize && x < columns; x++) {
+            SkIRect cell = SkIRect::MakeXYWH(x * cellSize, y * cellSize, cellSize, cellSize);
+            if (cell.intersect(r)) {
+                cells[y * columns + x] += nsPerPixel * cell.width() * cell.height();
+            }
+        }}
+    }
+
+    Json::Value typesJson;
+    for (int t = 0; t < kTypeCount; t++) {
+        if (typeCount[t] > 0 && t != SkRecords::NoOp_Type) {
+            Json::Value& typeJson = typesJson[kNames[t]];
+            typeJson["count"] = typeCount[t];
+            typeJson["ns"] = typeNs[t];
+            if (countPixels) {
+                typeJson["pixels"] = typePixels[t];
+            }
+        }
+    }
+
+    Json::Value heatmap;
+    heatmap["cell"] = cellSize;
+    heatmap["columns"] = columns;
+    heatmap["rows"] = rows;
+    heatmap["unattributed_ns"] = unattributedNs;
+    Json::Value& grid = heatmap["ns"] = Json::Value(Json::arrayValue);
+    for (int y = 0; y < rows; y++) {
+        Json::Value row(Json::arrayValue);
+        for (int x = 0; x < columns; x++) {
+            row.append(cells[y * columns + x]);
+        }
+        grid.append(row);
+    }
+
+    Json::Value root;
+    root["loops"] = loops;
+    root["total_ns"] = totalNs;
+    root["types"] = typesJson;
+    root["heatmap"] = heatmap;
+    root["ops"] = opsJson;
+    return root;
+}
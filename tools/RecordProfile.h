@@ -0,0 +1,38 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef RecordProfile_DEFINED
+#define RecordProfile_DEFINED
+
+#include "SkJSONCPP.h"
+
+class SkCanvas;
+class SkRecord;
+struct SkRect;
+
+/**
+ * Draw the record to the supplied canvas via SkRecords::Draw, timing each op,
+ * and return the timings as JSON:
+ *
+ *   "ops":     each op's index, type, time in nanoseconds and device bounds;
+ *   "types":   op count and total time for each op type;
+ *   "heatmap": time spread over a grid of cellSize x cellSize device-space cells,
+ *              each op's time split between the cells its bounds cover.
+ *
+ * The record is drawn loops times and each op's fastest time is kept.
+ *
+ * @param countPixels If true and the canvas is raster, also count the pixels each
+ *        op changes on the base layer.  (Ops drawn into a saveLayer() show up at
+ *        its restore().)  This adds no time to the op timings, but is slow.
+ */
+Json::Value ProfileRecord(const SkRecord& record,
+                          const SkRect& cullRect,
+                          SkCanvas* canvas,
+                          int loops,
+                          bool countPixels,
+                          int cellSize);
+
+#endif  // RecordProfile_DEFINED
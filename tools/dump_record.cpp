@@ -6,6 +6,7 @@
  */
 
 #include "DumpRecord.h"
+#include "RecordProfile.h"
 #include "SkCommandLineFlags.h"
 #include "SkDeferredCanvas.h"
 #include "SkPicture.h"
@@ -24,6 +25,10 @@ DEFINE_int32(tile, 1000000000, "Simulated tile size.");
 DEFINE_bool(timeWithCommand, false, "If true, print time next to command, else in first column.");
 DEFINE_string2(write, w, "", "Write the (optimized) picture to the named file.");
 DEFINE_bool(defer, false, "Defer clips and translates");
+DEFINE_string(profile, "", "Instead of dumping, time each op and write JSON profiles to this file.");
+DEFINE_int32(loops, 10, "With --profile, draw each SKP this many times, keeping the fastest times.");
+DEFINE_bool(countPixels, false, "With --profile, also count the pixels each op changes.");
+DEFINE_int32(cell, 256, "With --profile, size of the cells in the heat map.");
 
 static void dump(const char* name, int w, int h, const SkRecord& record) {
     SkBitmap bitmap;
@@ -37,9 +42,28 @@ static void dump(const char* name, int w, int h, const SkRecord& record) {
     DumpRecord(record, &canvas, FLAGS_timeWithCommand);
 }
 
+static Json::Value profile(int w, int h, const SkRecord& record) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(w, h);
+    SkCanvas canvas(bitmap);
+    canvas.clipRect(SkRect::MakeWH(SkIntToScalar(FLAGS_tile),
+                                   SkIntToScalar(FLAGS_tile)));
+
+    Json::Value json = ProfileRecord(record, SkRect::MakeIWH(w, h), &canvas,
+                                     SkTMax(1, FLAGS_loops), FLAGS_countPixels,
+                                     SkTMax(1, FLAGS_cell));
+    json["optimized"] = FLAGS_optimize || FLAGS_optimize2;
+    json["width"] = w;
+    json["height"] = h;
+    return json;
+}
+
 int main(int argc, char** argv) {
     SkCommandLineFlags::Parse(argc, argv);
 
+    // With --profile, one JSON object keyed by SKP path.
+    Json::Value profiles;
+
     for (int i = 0; i < FLAGS_skps.count(); i++) {
         if (SkCommandLineFlags::ShouldSkip(FLAGS_match, FLAGS_skps[i])) {
             continue;
@@ -76,7 +100,11 @@ int main(int argc, char** argv) {
             SkRecordOptimize2(&record);
         }
 
-        dump(FLAGS_skps[i], w, h, record);
+        if (FLAGS_profile.count() > 0) {
+            profiles[FLAGS_skps[i]] = profile(w, h, record);
+        } else {
+            dump(FLAGS_skps[i], w, h, record);
+        }
 
         if (FLAGS_write.count() > 0) {
             SkPictureRecorder r;
@@ -93,5 +121,14 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (FLAGS_profile.count() > 0) {
+        SkFILEWStream ostream(FLAGS_profile[0]);
+        if (!ostream.isValid()) {
+            SkDebugf("Could not write %s.\n", FLAGS_profile[0]);
+            return 1;
+        }
+        ostream.writeText(Json::StyledWriter().write(profiles).c_str());
+    }
+
     return 0;
 }
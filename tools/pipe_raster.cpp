@@ -0,0 +1,143 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "PipeRaster.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkGraphics.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+#include "SkTime.h"
+#include "Stats.h"
+#include <stdio.h>
+
+// Plays the SKPs back, in turn, as the frames of an animation: once rasterized in this
+// process, and once piped to a worker process through shared memory.
+
+DEFINE_string2(skps, r, "", ".SKPs to use as frames, in order.");
+DEFINE_int32(frames, 100, "Number of frames to draw, cycling through the SKPs.");
+DEFINE_int32(slots, 2, "Frames the worker may have in flight at once (1-8).");
+DEFINE_int32(ringMB, 16, "Size of the shared command ring, in MB.");
+DEFINE_int32(budgetMB, 0, "Cap on images and typefaces the worker holds on to, in MB; 0 for none.");
+DEFINE_bool(verify, true, "Check that the last frame matches between the two runs.");
+
+struct Result {
+    double           fSeconds = 0;
+    SkTArray<double> fLatencyMs;   // from starting a frame to having its pixels
+};
+
+static void report(const char* name, const Result& result) {
+    Stats stats(result.fLatencyMs);
+    printf("%-14s %8.1f frames/s   latency ms: min %.3f  median %.3f  mean %.3f  max %.3f\t%s\n",
+           name, result.fLatencyMs.count() / result.fSeconds,
+           stats.min, stats.median, stats.mean, stats.max, stats.plot.c_str());
+}
+
+static Result draw_in_process(const SkTArray<sk_sp<SkPicture>>& pics, SkBitmap* bitmap) {
+    SkCanvas canvas(*bitmap);
+    Result result;
+    double start = SkTime::GetMSecs();
+    for (int i = 0; i < FLAGS_frames; ++i) {
+        double frameStart = SkTime::GetMSecs();
+        canvas.clear(SK_ColorTRANSPARENT);
+        pics[i % pics.count()]->playback(&canvas);
+        canvas.flush();
+        result.fLatencyMs.push_back(SkTime::GetMSecs() - frameStart);
+    }
+    result.fSeconds = (SkTime::GetMSecs() - start) * 1e-3;
+    return result;
+}
+
+static bool draw_out_of_process(const SkTArray<sk_sp<SkPicture>>& pics, PipeRasterClient* client,
+                                SkPixmap* last, Result* result) {
+    SkTArray<double> started;
+    auto finish = [&]() {
+        if (!client->finishFrame(last)) {
+            return false;
+        }
+        int frame = result->fLatencyMs.count();
+        result->fLatencyMs.push_back(SkTime::GetMSecs() - started[frame]);
+        return true;
+    };
+
+    double start = SkTime::GetMSecs();
+    for (int i = 0; i < FLAGS_frames; ++i) {
+        // Keep the worker busy with up to slots() frames, retiring the oldest to make room.
+        if (client->framesInFlight() == client->slots() && !finish()) {
+            return false;
+        }
+        started.push_back(SkTime::GetMSecs());
+        pics[i % pics.count()]->playback(client->beginFrame());
+        client->endFrame();
+    }
+    while (client->framesInFlight() > 0) {
+        if (!finish()) {
+            return false;
+        }
+    }
+    result->fSeconds = (SkTime::GetMSecs() - start) * 1e-3;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Compares rasterizing SKPs in-process and in a worker process.");
+    SkCommandLineFlags::Parse(argc, argv);
+    SkGraphics::Init();
+
+    SkTArray<sk_sp<SkPicture>> pics;
+    SkIRect bounds = SkIRect::MakeEmpty();
+    for (int i = 0; i < FLAGS_skps.count(); ++i) {
+        std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(FLAGS_skps[i]);
+        sk_sp<SkPicture> pic = stream ? SkPicture::MakeFromStream(stream.get()) : nullptr;
+        if (!pic) {
+            SkDebugf("Could not read %s as an SkPicture.\n", FLAGS_skps[i]);
+            return 1;
+        }
+        bounds.join(pic->cullRect().roundOut());
+        pics.push_back(std::move(pic));
+    }
+    if (pics.empty() || bounds.isEmpty() || FLAGS_frames < 1) {
+        SkDebugf("Nothing to draw; pass some SKPs with --skps.\n");
+        return 1;
+    }
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(bounds.right(), bounds.bottom());
+    report("in-process", draw_in_process(pics, &bitmap));
+
+    std::unique_ptr<PipeRasterClient> client =
+            PipeRasterClient::Make(bitmap.width(), bitmap.height(),
+                                   (size_t)FLAGS_ringMB << 20, FLAGS_slots);
+    if (!client) {
+        SkDebugf("Could not start a worker process.\n");
+        return 1;
+    }
+    client->serializer()->setResourceBudget((size_t)FLAGS_budgetMB << 20);
+
+    SkPixmap last;
+    Result result;
+    if (!draw_out_of_process(pics, client.get(), &last, &result)) {
+        return 1;
+    }
+    report("out-of-process", result);
+
+    if (FLAGS_verify) {
+        // Both runs ended on the same SKP.
+        int mismatched = 0;
+        for (int y = 0; y < last.height(); ++y) {
+            if (memcmp(last.addr32(0, y), bitmap.getAddr32(0, y), last.width() * 4)) {
+                mismatched++;
+            }
+        }
+        if (mismatched) {
+            SkDebugf("%d of %d rows of the last frame differ.\n", mismatched, last.height());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "ProcStats.h"
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkData.h"
+#include "SkOSFile.h"
+#include "SkPicture.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTime.h"
+
+DEFINE_string2(input, i, "", "skp to load");
+DEFINE_bool2(lazy, l, false, "Load with SkPicture::MakeLazyFromData() from a mapped file, "
+                             "instead of SkPicture::MakeFromStream() from a file stream.");
+DEFINE_int32(tile, 256, "Size of the one tile to draw after loading; 0 to draw nothing.");
+DEFINE_int32(loops, 1, "Number of times to draw the tile.");
+DEFINE_bool2(quiet, q, false, "quiet");
+
+// This tool reports how long it takes, and how much memory it needs, to load an SKP
+// and to draw the first tile of it, so eager and lazy loading can be compared.
+// return codes:
+static const int kSuccess = 0;
+static const int kNotAnSKP = 2;
+static const int kMissingInput = 4;
+static const int kIOError = 5;
+
+static double now_ms() { return SkTime::GetNSecs() * 1e-6; }
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Times loading an skp and drawing one tile of it");
+    SkCommandLineFlags::Parse(argc, argv);
+
+    if (FLAGS_input.count() != 1) {
+        if (!FLAGS_quiet) {
+            SkDebugf("Missing input file\n");
+        }
+        return kMissingInput;
+    }
+    if (!sk_exists(FLAGS_input[0])) {
+        if (!FLAGS_quiet) {
+            SkDebugf("Couldn't open file\n");
+        }
+        return kIOError;
+    }
+
+    const int startRSS = sk_tools::getCurrResidentSetSizeMB();
+    double start = now_ms();
+    sk_sp<SkPicture> picture;
+    if (FLAGS_lazy) {
+        picture = SkPicture::MakeLazyFromData(SkData::MakeFromFileName(FLAGS_input[0]));
+    } else {
+        SkFILEStream stream(FLAGS_input[0]);
+        picture = SkPicture::MakeFromStream(&stream);
+    }
+    if (!picture) {
+        return kNotAnSKP;
+    }
+    const double loadMs = now_ms() - start;
+    const int loadRSS = sk_tools::getCurrResidentSetSizeMB();
+
+    double firstDrawMs = 0, drawMs = 0;
+    if (FLAGS_tile > 0) {
+        auto surface = SkSurface::MakeRasterN32Premul(FLAGS_tile, FLAGS_tile);
+        SkCanvas* canvas = surface->getCanvas();
+        canvas->clipRect(SkRect::MakeIWH(FLAGS_tile, FLAGS_tile));
+        canvas->translate(-picture->cullRect().left(), -picture->cullRect().top());
+        for (int i = 0; i < FLAGS_loops; i++) {
+            start = now_ms();
+            canvas->drawPicture(picture);
+            double ms = now_ms() - start;
+            if (0 == i) {
+                firstDrawMs = ms;
+            }
+            drawMs += ms;
+        }
+    }
+
+    if (!FLAGS_quiet) {
+        SkDebugf("%s\t%s\n", FLAGS_input[0], FLAGS_lazy ? "lazy" : "eager");
+        SkDebugf("load:       %.3f ms, %d MB RSS\n", loadMs, loadRSS - startRSS);
+        if (FLAGS_tile > 0) {
+            SkDebugf("first tile: %.3f ms\n", firstDrawMs);
+            SkDebugf("mean tile:  %.3f ms over %d loops\n", drawMs / FLAGS_loops, FLAGS_loops);
+        }
+        SkDebugf("peak RSS:   %d MB\n", sk_tools::getMaxResidentSetSizeMB());
+    }
+    return kSuccess;
+}